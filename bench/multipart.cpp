@@ -0,0 +1,225 @@
+#include "llhttplus/multipart.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Multipart upload benchmark.
+ *
+ *     llhttplus_multipart_bench [--json] [--size <MB>] [--span <KB>] [--parts <n>]
+ *
+ * Feeds a `multipart/form-data` body of `--size` MB (default 256) made of
+ * `--parts` random binary files (default 4) in spans of `--span` KB
+ * (default 64), as `on_body` would see it. Compares `MultipartSink`, which
+ * streams, with buffering the whole body and then splitting it with
+ * `std::string_view::find`. Reported: throughput and the most body bytes
+ * held at once. Both must find the same parts and payload.
+ */
+
+struct Result
+{
+	const char*	engine;
+	double		mb_per_s;
+	size_t		held;
+	size_t		parts;
+	size_t		bytes;
+};
+
+class CountSink : public llhttplus::MultipartSink
+{
+public:
+	int part_begin(const llhttplus::RequestBase&) override
+	{
+		++parts;
+		return 0;
+	}
+
+	int part_data(const llhttplus::RequestBase&, const char*, size_t length) override
+	{
+		bytes += length;
+		return 0;
+	}
+
+	size_t	parts = 0;
+	size_t	bytes = 0;
+};
+
+/* The body as a list of spans: the fixed framing and a reused random block. */
+struct Upload
+{
+	std::string					boundary;
+	std::vector<std::string>	framing;
+	std::vector<char>			block;
+	size_t						part_size;
+	size_t						span;
+	size_t						total = 0;
+
+	template<class F>
+	void each_span(F&& f) const
+	{
+		for (size_t part = 0; part < framing.size(); ++part)
+		{
+			f(framing[part].data(), framing[part].size());
+			if (part + 1 == framing.size())
+			{
+				break;
+			}
+			for (size_t sent = 0; sent < part_size; sent += span)
+			{
+				f(block.data(), std::min(span, part_size - sent));
+			}
+		}
+	}
+};
+
+static Upload __make_upload(size_t size, size_t span, size_t parts)
+{
+	Upload upload;
+	upload.boundary = "----llhttplusBenchBoundary8d3fa2c1";
+	upload.span = span;
+	upload.part_size = size / parts;
+	upload.block.resize(span);
+	uint64_t state = 0x9e3779b97f4a7c15;
+	for (auto& c : upload.block)
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		c = static_cast<char>(state);
+	}
+
+	for (size_t part = 0; part <= parts; ++part)
+	{
+		std::string framing = part == 0 ? "--" + upload.boundary : "\r\n--" + upload.boundary;
+		if (part == parts)
+		{
+			framing += "--\r\n";
+		}
+		else
+		{
+			framing += "\r\nContent-Disposition: form-data; name=\"file" + std::to_string(part) + "\"; filename=\"data"
+				+ std::to_string(part) + ".bin\"\r\nContent-Type: application/octet-stream\r\n\r\n";
+		}
+		upload.framing.push_back(framing);
+	}
+	upload.each_span([&](const char*, size_t length) { upload.total += length; });
+	return upload;
+}
+
+static Result __stream(const Upload& upload, const llhttplus::RequestBase& request)
+{
+	CountSink sink;
+	sink.reset(upload.boundary);
+	auto begin = std::chrono::steady_clock::now();
+	upload.each_span([&](const char* at, size_t length) { sink.write(request, at, length); });
+	bool ok = sink.finish(request) == 0;
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+	return { "stream", upload.total / 1e6 / elapsed.count(), 0, ok ? sink.parts : 0, sink.bytes };
+}
+
+/* Buffers the body, then walks it from delimiter to delimiter. */
+static Result __buffered(const Upload& upload)
+{
+	Result result = { "buffered", 0, 0, 0, 0 };
+	auto begin = std::chrono::steady_clock::now();
+	std::string body;
+	upload.each_span([&](const char* at, size_t length) { body.append(at, length); });
+	result.held = body.capacity();
+
+	std::string delimiter = "\r\n--" + upload.boundary;
+	std::string_view view(body);
+	size_t pos = view.find(delimiter.substr(2));
+	while (pos != std::string_view::npos)
+	{
+		pos += delimiter.size() - 2;
+		if (view.substr(pos, 2) == "--")
+		{
+			break;
+		}
+		size_t head_end = view.find("\r\n\r\n", pos);
+		if (head_end == std::string_view::npos)
+		{
+			break;
+		}
+		size_t next = view.find(delimiter, head_end + 4);
+		if (next == std::string_view::npos)
+		{
+			break;
+		}
+		++result.parts;
+		result.bytes += next - (head_end + 4);
+		pos = next + 2;
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+	result.mb_per_s = upload.total / 1e6 / elapsed.count();
+	return result;
+}
+
+int main(int argc, char* argv[])
+{
+	bool json = false;
+	size_t size = 256;
+	size_t span = 64;
+	size_t parts = 4;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--json") == 0)
+		{
+			json = true;
+		}
+		else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+		{
+			size = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+		}
+		else if (std::strcmp(argv[i], "--span") == 0 && i + 1 < argc)
+		{
+			span = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+		}
+		else if (std::strcmp(argv[i], "--parts") == 0 && i + 1 < argc)
+		{
+			parts = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--json] [--size <MB>] [--span <KB>] [--parts <n>]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	auto upload = __make_upload(size << 20, span << 10, parts);
+	llhttplus::Request request;
+
+	std::vector<Result> results;
+	results.push_back(__stream(upload, request));
+	results.push_back(__buffered(upload));
+	bool agree = results[0].parts == parts && results[0].parts == results[1].parts && results[0].bytes == results[1].bytes;
+
+	if (json)
+	{
+		std::printf("{\n  \"bytes\": %zu,\n  \"span\": %zu,\n  \"engines_agree\": %s,\n  \"results\": [\n", upload.total,
+			upload.span, agree ? "true" : "false");
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const auto& r = results[i];
+			std::printf("    { \"engine\": \"%s\", \"mb_per_s\": %.1f, \"held_bytes\": %zu, \"parts\": %zu }%s\n",
+				r.engine, r.mb_per_s, r.held, r.parts, i + 1 < results.size() ? "," : "");
+		}
+		std::printf("  ]\n}\n");
+	}
+	else
+	{
+		std::printf("body: %zu bytes in %zu byte spans%s\n", upload.total, upload.span, agree ? "" : "  ENGINES DISAGREE");
+		std::printf("%-9s %10s %14s %6s\n", "engine", "MB/s", "held bytes", "parts");
+		for (const auto& r : results)
+		{
+			std::printf("%-9s %10.1f %14zu %6zu\n", r.engine, r.mb_per_s, r.held, r.parts);
+		}
+	}
+	return agree ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+#include "llhttplus/llhttplus.hpp"
+#include "llhttplus/parser_group.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * Batch parsing benchmark.
+ *
+ *     llhttplus_group_bench [--json] [--time <ms>] [--connections <n>]
+ *                           [--batch <n>] [--distance <n>]
+ *
+ * `--connections` parsers, requests and receive buffers (default 65536, far
+ * more than fits in cache) each get one request per round; a round parses
+ * `--batch` random connections (default 256), as one `epoll_wait()` would
+ * return them. Compares calling `execute()` for each with
+ * `ParserGroup::execute_many()` prefetching `--distance` jobs ahead.
+ */
+
+struct Connection
+{
+	std::unique_ptr<llhttplus::Parser>	parser;
+	std::unique_ptr<llhttplus::Request>	request;
+	std::string							buffer;
+};
+
+struct Result
+{
+	const char*	engine;
+	double		ns_per_message;
+	size_t		errors;
+};
+
+static std::vector<Connection> __make_connections(size_t count)
+{
+	std::vector<Connection> connections(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		auto& connection = connections[i];
+		connection.parser = std::make_unique<llhttplus::Parser>();
+		connection.request = std::make_unique<llhttplus::Request>();
+		connection.buffer =
+			"GET /api/v1/items/" + std::to_string(i) + "?fields=id,name HTTP/1.1\r\n"
+			"Host: service.internal\r\n"
+			"User-Agent: llhttplus_group_bench\r\n"
+			"Accept: application/json\r\n"
+			"X-Request-Id: " + std::to_string(i * 7919) + "\r\n"
+			"\r\n";
+	}
+	return connections;
+}
+
+/* Random batches; a parser appears at most once per batch. */
+static std::vector<uint32_t> __make_schedule(size_t connections, size_t batch, size_t rounds)
+{
+	std::vector<uint32_t> schedule;
+	std::vector<size_t> picked(connections, SIZE_MAX);
+	schedule.reserve(batch * rounds);
+	uint64_t state = 0x2545f4914f6cdd1d;
+	for (size_t round = 0; round < rounds; ++round)
+	{
+		for (size_t i = 0; i < batch; )
+		{
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			size_t connection = state % connections;
+			if (picked[connection] != round)
+			{
+				picked[connection] = round;
+				schedule.push_back(static_cast<uint32_t>(connection));
+				++i;
+			}
+		}
+	}
+	return schedule;
+}
+
+template<class Batch>
+static Result __run(const char* engine, std::vector<Connection>& connections, const std::vector<uint32_t>& schedule,
+	size_t batch, double min_ms, Batch&& run)
+{
+	Result result = { engine, 0, 0 };
+	std::vector<llhttplus::ParseJob> jobs(batch);
+	size_t messages = 0;
+	auto begin = std::chrono::steady_clock::now();
+	std::chrono::duration<double, std::milli> elapsed{ 0 };
+	while (elapsed.count() < min_ms)
+	{
+		for (size_t offset = 0; offset + batch <= schedule.size(); offset += batch)
+		{
+			for (size_t i = 0; i < batch; ++i)
+			{
+				auto& connection = connections[schedule[offset + i]];
+				jobs[i] = { connection.parser.get(), connection.request.get(), connection.buffer.data(), connection.buffer.size() };
+			}
+			result.errors += batch - run(jobs);
+			messages += batch;
+		}
+		elapsed = std::chrono::steady_clock::now() - begin;
+	}
+	result.ns_per_message = elapsed.count() * 1e6 / messages;
+	return result;
+}
+
+int main(int argc, char* argv[])
+{
+	bool json = false;
+	double ms = 1000;
+	size_t count = 65536;
+	size_t batch = 256;
+	size_t distance = 4;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--json") == 0)
+		{
+			json = true;
+		}
+		else if (std::strcmp(argv[i], "--time") == 0 && i + 1 < argc)
+		{
+			ms = std::atof(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--connections") == 0 && i + 1 < argc)
+		{
+			count = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+		}
+		else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+		{
+			batch = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+		}
+		else if (std::strcmp(argv[i], "--distance") == 0 && i + 1 < argc)
+		{
+			distance = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--json] [--time <ms>] [--connections <n>] [--batch <n>] [--distance <n>]\n", argv[0]);
+			return 2;
+		}
+	}
+	batch = std::min(batch, count);
+
+	auto connections = __make_connections(count);
+	auto schedule = __make_schedule(count, batch, 256);
+
+	std::vector<Result> results;
+	results.push_back(__run("execute", connections, schedule, batch, ms, [](std::vector<llhttplus::ParseJob>& jobs) {
+		size_t completed = 0;
+		for (auto& job : jobs)
+		{
+			completed += job.parser->execute(job.request, job.data, job.length) == HPE_OK
+				&& job.request->url.size() != 0;
+		}
+		return completed;
+	}));
+
+	llhttplus::ParserGroup group(distance);
+	results.push_back(__run("group", connections, schedule, batch, ms, [&](std::vector<llhttplus::ParseJob>& jobs) {
+		group.execute_many(jobs);
+		return group.completed().size();
+	}));
+
+	bool ok = true;
+	double base = results.front().ns_per_message;
+	if (json)
+	{
+		std::printf("{\n  \"connections\": %zu,\n  \"batch\": %zu,\n  \"distance\": %zu,\n  \"results\": [\n", count, batch, distance);
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const auto& r = results[i];
+			std::printf("    { \"engine\": \"%s\", \"ns_per_message\": %.2f, \"speedup\": %.2f, \"errors\": %zu }%s\n",
+				r.engine, r.ns_per_message, base / r.ns_per_message, r.errors, i + 1 < results.size() ? "," : "");
+			ok &= r.errors == 0;
+		}
+		std::printf("  ]\n}\n");
+	}
+	else
+	{
+		std::printf("connections: %zu batch: %zu distance: %zu\n", count, batch, distance);
+		std::printf("%-8s %14s %8s\n", "engine", "ns/message", "speedup");
+		for (const auto& r : results)
+		{
+			std::printf("%-8s %14.1f %8.2f%s\n", r.engine, r.ns_per_message, base / r.ns_per_message,
+				r.errors == 0 ? "" : "  ERRORS");
+			ok &= r.errors == 0;
+		}
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,337 @@
+#include "llhttplus/router.hpp"
+#include "llhttplus/url.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <regex>
+#include <string>
+#include <vector>
+
+/*
+ * Router benchmark.
+ *
+ *     llhttplus_router_bench [--json] [--time <ms>] [--routes <n>]
+ *
+ * Registers about `--routes` REST-style routes (default 5000: collections,
+ * items, nested items, actions and a static wildcard) and matches a mix of
+ * URLs against them with the compiled `Router`, a chain of per-segment
+ * string compares, and one `std::regex` per route. Reported per lookup:
+ * time and heap allocations (counted through the global operator new). All
+ * engines must agree on every lookup.
+ */
+
+static std::atomic<size_t> __allocations{ 0 };
+
+void* operator new(size_t size)
+{
+	__allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+struct Route
+{
+	llhttp_method_t	method;
+	std::string		pattern;
+};
+
+struct Lookup
+{
+	llhttp_method_t	method;
+	std::string		url;
+	int				route;
+};
+
+static std::vector<Route> __make_routes(size_t count)
+{
+	std::vector<Route> routes;
+	routes.push_back({ HTTP_GET, "/static/*path" });
+	for (size_t i = 0; routes.size() < count; ++i)
+	{
+		std::string base = "/api/v" + std::to_string(1 + i % 3) + "/resource" + std::to_string(i);
+		routes.push_back({ HTTP_GET, base });
+		routes.push_back({ HTTP_POST, base });
+		routes.push_back({ HTTP_GET, base + "/:id" });
+		routes.push_back({ HTTP_PUT, base + "/:id" });
+		routes.push_back({ HTTP_DELETE, base + "/:id" });
+		routes.push_back({ HTTP_GET, base + "/:id/items/:item" });
+		routes.push_back({ HTTP_POST, base + "/:id/actions/archive" });
+	}
+	return routes;
+}
+
+/* Fills the captures of `pattern` in with values, as a client would. */
+static std::string __make_url(const std::string& pattern, size_t seed)
+{
+	std::string url;
+	size_t i = 0;
+	while (i < pattern.size())
+	{
+		if (pattern[i] == ':' || pattern[i] == '*')
+		{
+			url += pattern[i] == ':' ? std::to_string(1000 + seed) : "css/site.css";
+			while (i < pattern.size() && pattern[i] != '/')
+			{
+				++i;
+			}
+			continue;
+		}
+		url += pattern[i++];
+	}
+	return seed % 4 == 0 ? url + "?page=" + std::to_string(seed) : url;
+}
+
+static std::vector<Lookup> __make_lookups(const std::vector<Route>& routes, size_t count)
+{
+	std::vector<Lookup> lookups;
+	uint64_t state = 0x9e3779b97f4a7c15;
+	for (size_t i = 0; i < count; ++i)
+	{
+		state = state * 6364136223846793005 + 1442695040888963407;
+		size_t route = (state >> 33) % routes.size();
+		if (i % 16 == 15)
+		{
+			/* misses */
+			lookups.push_back({ HTTP_GET, "/api/v1/missing" + std::to_string(i), -1 });
+		}
+		else
+		{
+			lookups.push_back({ routes[route].method, __make_url(routes[route].pattern, i), static_cast<int>(route) });
+		}
+	}
+	return lookups;
+}
+
+/* The hand-written way: try every route, comparing segment by segment. */
+static int __linear_match(const std::vector<Route>& routes, llhttp_method_t method, std::string_view url)
+{
+	std::string_view path = llhttplus::UrlView(url).path();
+	for (size_t r = 0; r < routes.size(); ++r)
+	{
+		if (routes[r].method != method)
+		{
+			continue;
+		}
+
+		std::string_view pattern = routes[r].pattern;
+		size_t p = 0;
+		size_t u = 0;
+		bool ok = true;
+		while (ok && p < pattern.size() && u <= path.size())
+		{
+			size_t p_end = std::min(pattern.find('/', p + 1), pattern.size());
+			size_t u_end = std::min(path.find('/', u + 1), path.size());
+			std::string_view segment = pattern.substr(p, p_end - p);
+			if (segment.size() > 1 && segment[1] == '*')
+			{
+				u = path.size();
+				p = pattern.size();
+				break;
+			}
+			if (segment.size() > 1 && segment[1] == ':')
+			{
+				ok = u_end - u > 1 && path[u] == '/';
+			}
+			else
+			{
+				ok = path.substr(u, u_end - u) == segment;
+			}
+			p = p_end;
+			u = u_end;
+		}
+		if (ok && p == pattern.size() && u == path.size())
+		{
+			return static_cast<int>(r);
+		}
+	}
+	return -1;
+}
+
+struct RegexRoute
+{
+	llhttp_method_t	method;
+	std::regex		regex;
+};
+
+static std::vector<RegexRoute> __make_regexes(const std::vector<Route>& routes)
+{
+	std::vector<RegexRoute> regexes;
+	for (const auto& route : routes)
+	{
+		std::string expression;
+		for (size_t i = 0; i < route.pattern.size(); ++i)
+		{
+			char c = route.pattern[i];
+			if ((c == ':' || c == '*') && route.pattern[i - 1] == '/')
+			{
+				expression += c == ':' ? "([^/]+)" : "(.*)";
+				while (i + 1 < route.pattern.size() && route.pattern[i + 1] != '/')
+				{
+					++i;
+				}
+			}
+			else
+			{
+				expression += c;
+			}
+		}
+		regexes.push_back({ route.method, std::regex(expression) });
+	}
+	return regexes;
+}
+
+static int __regex_match(const std::vector<RegexRoute>& regexes, llhttp_method_t method, std::string_view url)
+{
+	std::string_view path = llhttplus::UrlView(url).path();
+	std::cmatch match;
+	for (size_t r = 0; r < regexes.size(); ++r)
+	{
+		if (regexes[r].method == method && std::regex_match(path.data(), path.data() + path.size(), match, regexes[r].regex))
+		{
+			return static_cast<int>(r);
+		}
+	}
+	return -1;
+}
+
+struct Result
+{
+	const char*	engine;
+	double		ns_per_lookup;
+	double		allocations_per_lookup;
+	size_t		mismatches;
+};
+
+template<class Match>
+static Result __run(const char* engine, const std::vector<Lookup>& lookups, double min_ms, Match&& match)
+{
+	Result result = { engine, 0, 0, 0 };
+	for (const auto& lookup : lookups)
+	{
+		result.mismatches += match(lookup) != lookup.route;
+	}
+
+	size_t done = 0;
+	size_t allocations = __allocations.load();
+	auto begin = std::chrono::steady_clock::now();
+	std::chrono::duration<double, std::milli> elapsed{ 0 };
+	int sink = 0;
+	while (elapsed.count() < min_ms)
+	{
+		for (const auto& lookup : lookups)
+		{
+			sink += match(lookup);
+		}
+		done += lookups.size();
+		elapsed = std::chrono::steady_clock::now() - begin;
+	}
+	result.ns_per_lookup = elapsed.count() * 1e6 / done;
+	result.allocations_per_lookup = static_cast<double>(__allocations.load() - allocations) / done;
+	if (sink == 42)
+	{
+		std::printf(" ");
+	}
+	return result;
+}
+
+int main(int argc, char* argv[])
+{
+	bool json = false;
+	double ms = 500;
+	size_t count = 5000;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--json") == 0)
+		{
+			json = true;
+		}
+		else if (std::strcmp(argv[i], "--time") == 0 && i + 1 < argc)
+		{
+			ms = std::atof(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--routes") == 0 && i + 1 < argc)
+		{
+			count = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--json] [--time <ms>] [--routes <n>]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	auto routes = __make_routes(count);
+	auto lookups = __make_lookups(routes, 4096);
+
+	llhttplus::Router router;
+	for (const auto& route : routes)
+	{
+		if (router.add(route.method, route.pattern) < 0)
+		{
+			std::fprintf(stderr, "rejected route %s\n", route.pattern.c_str());
+			return 1;
+		}
+	}
+	router.compile();
+
+	std::vector<Result> results;
+	results.push_back(__run("router", lookups, ms, [&](const Lookup& lookup) {
+		return router.match(lookup.method, lookup.url).route;
+	}));
+	results.push_back(__run("linear", lookups, ms, [&](const Lookup& lookup) {
+		return __linear_match(routes, lookup.method, lookup.url);
+	}));
+
+	/* thousands of regexes are slow enough to need fewer lookups */
+	auto regexes = __make_regexes(routes);
+	std::vector<Lookup> sample(lookups.begin(), lookups.begin() + 64);
+	results.push_back(__run("regex", sample, ms, [&](const Lookup& lookup) {
+		return __regex_match(regexes, lookup.method, lookup.url);
+	}));
+
+	bool ok = true;
+	double base = results.front().ns_per_lookup;
+	if (json)
+	{
+		std::printf("{\n  \"routes\": %zu,\n  \"results\": [\n", routes.size());
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const auto& r = results[i];
+			std::printf("    { \"engine\": \"%s\", \"ns_per_lookup\": %.2f, \"vs_router\": %.2f, \"allocs_per_lookup\": %.4f, \"mismatches\": %zu }%s\n",
+				r.engine, r.ns_per_lookup, r.ns_per_lookup / base, r.allocations_per_lookup, r.mismatches,
+				i + 1 < results.size() ? "," : "");
+			ok &= r.mismatches == 0;
+		}
+		std::printf("  ]\n}\n");
+	}
+	else
+	{
+		std::printf("routes: %zu\n", routes.size());
+		std::printf("%-8s %14s %10s %12s\n", "engine", "ns/lookup", "vs router", "allocs");
+		for (const auto& r : results)
+		{
+			std::printf("%-8s %14.1f %10.1f %12.4f%s\n", r.engine, r.ns_per_lookup, r.ns_per_lookup / base,
+				r.allocations_per_lookup, r.mismatches == 0 ? "" : "  MISMATCH");
+			ok &= r.mismatches == 0;
+		}
+	}
+	return ok ? 0 : 1;
+}
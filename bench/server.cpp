@@ -0,0 +1,250 @@
+#include "llhttplus/server.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Scaling benchmark of llhttplus_server over loopback.
+ *
+ *     llhttplus_server_bench [--json] [--time <ms>] [--threads <max>]
+ *                            [--connections <n>] [--pipeline <depth>] [--epoll]
+ *
+ * The server is started with 1, 2, 4, ... up to `--threads` loops (default:
+ * hardware threads); each round, `--connections` blocking clients send
+ * `--pipeline` requests at a time over keep-alive connections for `--time`
+ * ms; `--epoll` disables the io_uring backend. Clients run on the same
+ * machine, so they compete with the loops for CPUs: pin the server or run
+ * the clients elsewhere for absolute numbers.
+ */
+
+static const char __request[] =
+	"GET /plaintext HTTP/1.1\r\n"
+	"Host: localhost\r\n"
+	"User-Agent: llhttplus_server_bench\r\n"
+	"Accept: text/plain\r\n"
+	"\r\n";
+
+static const char __greeting[] = "Hello, World!";
+
+struct Result
+{
+	const char*	backend;
+	size_t		threads;
+	double		requests_per_s;
+	size_t		errors;
+};
+
+static int __connect(uint16_t port)
+{
+	int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+	int one = 1;
+	::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		::close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+/* Sends `pipeline` requests at a time until `stop`; returns the responses received. */
+static size_t __client(uint16_t port, size_t pipeline, const std::atomic<bool>& stop, size_t* errors)
+{
+	int fd = __connect(port);
+	if (fd < 0)
+	{
+		++*errors;
+		return 0;
+	}
+
+	std::string batch;
+	for (size_t i = 0; i < pipeline; ++i)
+	{
+		batch.append(__request, sizeof(__request) - 1);
+	}
+
+	llhttplus::Connection connection;
+	size_t responses = 0;
+	while (!stop.load(std::memory_order_relaxed))
+	{
+		if (::send(fd, batch.data(), batch.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(batch.size()))
+		{
+			++*errors;
+			break;
+		}
+
+		size_t pending = pipeline;
+		while (pending > 0)
+		{
+			auto region = connection.prepare();
+			ssize_t n = ::recv(fd, region.data, region.size, 0);
+			if (n <= 0)
+			{
+				++*errors;
+				::close(fd);
+				return responses;
+			}
+			connection.commit(static_cast<size_t>(n));
+			while (connection.next() != nullptr)
+			{
+				connection.pop();
+				--pending;
+				++responses;
+			}
+		}
+	}
+	::close(fd);
+	return responses;
+}
+
+static Result __run(size_t threads, size_t connections, size_t pipeline, bool io_uring, double ms)
+{
+	llhttplus::ServerOptions options;
+	options.address = "127.0.0.1";
+	options.port = 0;
+	options.threads = threads;
+	options.io_uring = io_uring;
+
+	llhttplus::Server server(options, [](const llhttplus::CompactRequest&, llhttplus::ResponseWriter& response) {
+		response.status(200);
+		response.date();
+		response.header(llhttplus::header_blocks::content_type_text);
+		response.body(__greeting, sizeof(__greeting) - 1);
+	});
+
+	Result result = { "", threads, 0, 0 };
+	if (server.start() != 0)
+	{
+		result.errors = 1;
+		return result;
+	}
+	result.backend = server.backend();
+
+	std::atomic<bool> stop{ false };
+	std::vector<size_t> responses(connections, 0);
+	std::vector<size_t> errors(connections, 0);
+	std::vector<std::thread> clients;
+	auto begin = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < connections; ++i)
+	{
+		clients.emplace_back([&, i] {
+			responses[i] = __client(server.port(), pipeline, stop, &errors[i]);
+		});
+	}
+
+	std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(ms));
+	stop.store(true, std::memory_order_relaxed);
+	size_t total = 0;
+	for (size_t i = 0; i < connections; ++i)
+	{
+		clients[i].join();
+		total += responses[i];
+		result.errors += errors[i];
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+	result.requests_per_s = total / elapsed.count();
+	return result;
+}
+
+int main(int argc, char* argv[])
+{
+	bool json = false;
+	double ms = 1000;
+	size_t max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+	size_t connections = 64;
+	size_t pipeline = 1;
+	bool io_uring = true;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--json") == 0)
+		{
+			json = true;
+		}
+		else if (std::strcmp(argv[i], "--time") == 0 && i + 1 < argc)
+		{
+			ms = std::atof(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			max_threads = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+		}
+		else if (std::strcmp(argv[i], "--connections") == 0 && i + 1 < argc)
+		{
+			connections = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+		}
+		else if (std::strcmp(argv[i], "--pipeline") == 0 && i + 1 < argc)
+		{
+			pipeline = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+		}
+		else if (std::strcmp(argv[i], "--epoll") == 0)
+		{
+			io_uring = false;
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--json] [--time <ms>] [--threads <max>] [--connections <n>] [--pipeline <depth>] [--epoll]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	std::vector<size_t> rounds;
+	for (size_t threads = 1; threads < max_threads; threads *= 2)
+	{
+		rounds.push_back(threads);
+	}
+	rounds.push_back(max_threads);
+
+	std::vector<Result> results;
+	for (size_t threads : rounds)
+	{
+		results.push_back(__run(threads, connections, pipeline, io_uring, ms));
+	}
+
+	bool ok = true;
+	double base = results.front().requests_per_s;
+	if (json)
+	{
+		std::printf("{\n  \"backend\": \"%s\",\n  \"connections\": %zu,\n  \"pipeline\": %zu,\n  \"results\": [\n",
+			results.front().backend, connections, pipeline);
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const auto& r = results[i];
+			std::printf("    { \"threads\": %zu, \"requests_per_s\": %.0f, \"speedup\": %.2f, \"errors\": %zu }%s\n",
+				r.threads, r.requests_per_s, base > 0 ? r.requests_per_s / base : 0.0, r.errors,
+				i + 1 < results.size() ? "," : "");
+			ok &= r.errors == 0;
+		}
+		std::printf("  ]\n}\n");
+	}
+	else
+	{
+		std::printf("backend: %s connections: %zu pipeline: %zu\n", results.front().backend, connections, pipeline);
+		std::printf("%8s %14s %8s\n", "threads", "requests/s", "speedup");
+		for (const auto& r : results)
+		{
+			std::printf("%8zu %14.0f %8.2f%s\n", r.threads, r.requests_per_s, base > 0 ? r.requests_per_s / base : 0.0,
+				r.errors == 0 ? "" : "  ERRORS");
+			ok &= r.errors == 0;
+		}
+	}
+	return ok ? 0 : 1;
+}
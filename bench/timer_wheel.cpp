@@ -0,0 +1,289 @@
+#include "llhttplus/timer_wheel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <queue>
+#include <vector>
+
+/*
+ * Connection deadline benchmark.
+ *
+ *     llhttplus_timer_bench [--json] [--time <ms>] [--connections <n>]
+ *
+ * Keeps one deadline per connection (default 500000) and re-arms a random
+ * one per operation, as every `execute()` does with `DeadlineSetting`.
+ * Time moves 1 ms every 1000 operations; due deadlines are collected and
+ * re-armed. Compares `TimerWheel` with a `std::multimap` and with a binary
+ * heap with lazy deletion. All engines must expire the same deadlines.
+ */
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+struct Result
+{
+	const char*	engine;
+	double		ns_per_rearm;
+	size_t		expired;
+};
+
+static uint64_t __next(uint64_t* state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+	return *state;
+}
+
+/* Deadlines between 1 and 5 s, in ms. */
+static int64_t __timeout(uint64_t* state)
+{
+	return 1000 + static_cast<int64_t>(__next(state) % 4000);
+}
+
+/* Same range for an expired deadline, independent of the order of expiry. */
+static int64_t __timeout(size_t connection, int64_t now)
+{
+	return 1000 + static_cast<int64_t>((connection * 2654435761u + static_cast<uint64_t>(now)) % 4000);
+}
+
+class WheelEngine
+{
+public:
+	explicit WheelEngine(size_t count)
+		: _wheel(1ms, Clock::time_point())
+		, _timers(count)
+	{
+	}
+
+	void arm(size_t connection, int64_t ms)
+	{
+		_wheel.arm(_timers[connection], std::chrono::milliseconds(ms));
+	}
+
+	template<class Expire>
+	void advance(int64_t now, Expire&& expire)
+	{
+		_expired.clear();
+		_wheel.advance(Clock::time_point() + std::chrono::milliseconds(now), _expired);
+		for (auto* timer : _expired)
+		{
+			expire(static_cast<size_t>(timer - _timers.data()));
+		}
+	}
+
+private:
+	llhttplus::TimerWheel			_wheel;
+	std::vector<llhttplus::Timer>	_timers;
+	std::vector<llhttplus::Timer*>	_expired;
+};
+
+class MapEngine
+{
+public:
+	explicit MapEngine(size_t count)
+		: _entries(count, _deadlines.end())
+	{
+	}
+
+	void arm(size_t connection, int64_t ms)
+	{
+		if (_entries[connection] != _deadlines.end())
+		{
+			_deadlines.erase(_entries[connection]);
+		}
+		_entries[connection] = _deadlines.emplace(_now + ms, connection);
+	}
+
+	template<class Expire>
+	void advance(int64_t now, Expire&& expire)
+	{
+		_now = now;
+		while (!_deadlines.empty() && _deadlines.begin()->first <= now)
+		{
+			size_t connection = _deadlines.begin()->second;
+			_deadlines.erase(_deadlines.begin());
+			_entries[connection] = _deadlines.end();
+			expire(connection);
+		}
+	}
+
+private:
+	using Map = std::multimap<int64_t, size_t>;
+
+	Map							_deadlines;
+	std::vector<Map::iterator>	_entries;
+	int64_t						_now = 0;
+};
+
+class HeapEngine
+{
+public:
+	explicit HeapEngine(size_t count)
+		: _generations(count, 0)
+	{
+	}
+
+	/* Re-arming pushes a new entry; the stale one is skipped when it surfaces. */
+	void arm(size_t connection, int64_t ms)
+	{
+		_heap.push({ _now + ms, connection, ++_generations[connection] });
+	}
+
+	template<class Expire>
+	void advance(int64_t now, Expire&& expire)
+	{
+		_now = now;
+		while (!_heap.empty() && _heap.top().deadline <= now)
+		{
+			Entry entry = _heap.top();
+			_heap.pop();
+			if (entry.generation == _generations[entry.connection])
+			{
+				++_generations[entry.connection];
+				expire(entry.connection);
+			}
+		}
+	}
+
+private:
+	struct Entry
+	{
+		int64_t		deadline;
+		size_t		connection;
+		uint64_t	generation;
+
+		bool operator<(const Entry& other) const
+		{
+			return deadline > other.deadline;
+		}
+	};
+
+	std::priority_queue<Entry>	_heap;
+	std::vector<uint64_t>		_generations;
+	int64_t						_now = 0;
+};
+
+template<class Engine>
+static Result __run(const char* engine, size_t count, double min_ms)
+{
+	Result result = { engine, 0, 0 };
+	auto deadlines = std::make_unique<Engine>(count);
+	uint64_t state = 0x2545f4914f6cdd1d;
+	for (size_t i = 0; i < count; ++i)
+	{
+		deadlines->arm(i, __timeout(&state));
+	}
+
+	int64_t now = 0;
+	size_t rearms = 0;
+	auto begin = Clock::now();
+	std::chrono::duration<double, std::milli> elapsed{ 0 };
+	while (elapsed.count() < min_ms)
+	{
+		for (int round = 0; round < 100; ++round)
+		{
+			for (int i = 0; i < 1000; ++i)
+			{
+				deadlines->arm(__next(&state) % count, __timeout(&state));
+			}
+			deadlines->advance(++now, [&](size_t connection) {
+				++result.expired;
+				deadlines->arm(connection, __timeout(connection, now));
+			});
+			rearms += 1000;
+		}
+		elapsed = Clock::now() - begin;
+	}
+	result.ns_per_rearm = elapsed.count() * 1e6 / rearms;
+	return result;
+}
+
+/* Runs a fixed schedule and returns the number of expiries, which must agree. */
+template<class Engine>
+static size_t __expiries(size_t count)
+{
+	Engine deadlines(count);
+	uint64_t state = 0x9e3779b97f4a7c15;
+	size_t expired = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		deadlines.arm(i, __timeout(&state));
+	}
+	for (int64_t now = 1; now <= 40000; ++now)
+	{
+		for (int i = 0; i < 10; ++i)
+		{
+			deadlines.arm(__next(&state) % count, __timeout(&state));
+		}
+		deadlines.advance(now, [&](size_t connection) {
+			++expired;
+			deadlines.arm(connection, __timeout(connection, now));
+		});
+	}
+	return expired;
+}
+
+int main(int argc, char* argv[])
+{
+	bool json = false;
+	double ms = 1000;
+	size_t count = 500000;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--json") == 0)
+		{
+			json = true;
+		}
+		else if (std::strcmp(argv[i], "--time") == 0 && i + 1 < argc)
+		{
+			ms = std::atof(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--connections") == 0 && i + 1 < argc)
+		{
+			count = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--json] [--time <ms>] [--connections <n>]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	size_t check = std::min<size_t>(count, 10000);
+	size_t wheel_expiries = __expiries<WheelEngine>(check);
+	bool agree = wheel_expiries == __expiries<MapEngine>(check) && wheel_expiries == __expiries<HeapEngine>(check);
+
+	std::vector<Result> results;
+	results.push_back(__run<WheelEngine>("wheel", count, ms));
+	results.push_back(__run<MapEngine>("multimap", count, ms));
+	results.push_back(__run<HeapEngine>("heap", count, ms));
+
+	double base = results.front().ns_per_rearm;
+	if (json)
+	{
+		std::printf("{\n  \"connections\": %zu,\n  \"engines_agree\": %s,\n  \"results\": [\n", count, agree ? "true" : "false");
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const auto& r = results[i];
+			std::printf("    { \"engine\": \"%s\", \"ns_per_rearm\": %.2f, \"vs_wheel\": %.2f, \"expired\": %zu }%s\n",
+				r.engine, r.ns_per_rearm, r.ns_per_rearm / base, r.expired, i + 1 < results.size() ? "," : "");
+		}
+		std::printf("  ]\n}\n");
+	}
+	else
+	{
+		std::printf("connections: %zu%s\n", count, agree ? "" : "  ENGINES DISAGREE");
+		std::printf("%-9s %14s %9s %10s\n", "engine", "ns/re-arm", "vs wheel", "expired");
+		for (const auto& r : results)
+		{
+			std::printf("%-9s %14.1f %9.2f %10zu\n", r.engine, r.ns_per_rearm, r.ns_per_rearm / base, r.expired);
+		}
+	}
+	return agree ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#ifndef _LLHTTP_ARENA_HPP_
+#define _LLHTTP_ARENA_HPP_
+#include <memory_resource>
+#include <vector>
+
+namespace llhttplus
+{
+    /*
+     * Bump allocator backing all per-message storage of a `Parser`.
+     *
+     * Memory is carved out of blocks obtained from the upstream allocator.
+     * `deallocate()` is a no-op; everything is released at once by `reset()`,
+     * which rewinds to the first block in O(1) and keeps the blocks, so a
+     * connection in steady state stops calling malloc after its first messages.
+     */
+    class Arena : public std::pmr::memory_resource
+    {
+    public:
+        explicit Arena(size_t block_size = 4096);
+        ~Arena() override;
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /* Releases every allocation at once, keeping the blocks for reuse. */
+        void reset();
+
+        /* Returns all blocks to the upstream allocator. */
+        void release();
+
+        /* Returns the number of allocations served since construction. */
+        size_t allocations() const;
+
+        /* Returns the number of blocks requested from the upstream allocator
+         * since construction.
+         */
+        size_t upstream_allocations() const;
+
+        /* Returns the number of bytes handed out since the last `reset()`. */
+        size_t bytes_used() const;
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:
+        struct Block
+        {
+            char*  data;
+            size_t size;
+        };
+
+        bool __enter_block(size_t index, size_t bytes, size_t alignment);
+
+        std::vector<Block> _blocks;
+        size_t _block_size;
+        size_t _current = 0;
+        char*  _cursor = nullptr;
+        char*  _end = nullptr;
+        size_t _allocations = 0;
+        size_t _upstream_allocations = 0;
+        size_t _bytes_used = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,117 @@
+#pragma once
+
+#ifndef _LLHTTP_BASIC_PARSER_HPP_
+#define _LLHTTP_BASIC_PARSER_HPP_
+#include "setting.hpp"
+#include <utility>
+
+#define _STATIC_DISPATCH_CB(name)                                               \
+    static int __##name(llhttp_t *lparser)                                      \
+    {                                                                           \
+        _LLHTTP_METRIC_CALLBACK(name);                                          \
+        auto *parser = static_cast<BasicParser *>((Parser *)lparser->data);     \
+        return parser->_callbacks._##name(parser);                              \
+    }
+
+#define _STATIC_DISPATCH_DATA_CB(name)                                          \
+    static int __##name(llhttp_t *lparser, const char *at, size_t length)       \
+    {                                                                           \
+        _LLHTTP_METRIC_CALLBACK(name);                                          \
+        auto *parser = static_cast<BasicParser *>((Parser *)lparser->data);     \
+        return parser->_callbacks._##name(parser, at, length);                  \
+    }
+
+namespace llhttplus
+{
+    /*
+     * Parser whose settings type is known at compile time.
+     *
+     * llhttp calls thunks generated for `Setting`, which reach its `_on_*`
+     * members through the parser itself instead of `Parser::setting()` and a
+     * cast, so the callbacks can be inlined. `Setting` implements the same
+     * interface as a `ParserSetting` subclass; every parser owns its instance.
+     */
+    template<class Setting>
+    class BasicParser : public Parser
+    {
+        static_assert(detail::implements_any<Setting>, "Setting does not implement any callback");
+
+    public:
+        template<class... Args>
+        explicit BasicParser(Args&&... args)
+            : Parser(&__low_layer_setting(), &_callbacks, detail::__is_default_setting<Setting>)
+            , _callbacks(std::forward<Args>(args)...)
+        {
+        }
+
+        Setting& callbacks()
+        {
+            return _callbacks;
+        }
+
+    private:
+        _STATIC_DISPATCH_DATA_CB(on_url)
+        _STATIC_DISPATCH_DATA_CB(on_status)
+        _STATIC_DISPATCH_DATA_CB(on_header_field)
+        _STATIC_DISPATCH_DATA_CB(on_header_value)
+        _STATIC_DISPATCH_DATA_CB(on_body)
+        _STATIC_DISPATCH_CB(on_message_begin)
+        _STATIC_DISPATCH_CB(on_headers_complete)
+        _STATIC_DISPATCH_CB(on_chunk_header)
+        _STATIC_DISPATCH_CB(on_chunk_complete)
+        _STATIC_DISPATCH_CB(on_url_complete)
+        _STATIC_DISPATCH_CB(on_status_complete)
+        _STATIC_DISPATCH_CB(on_header_field_complete)
+        _STATIC_DISPATCH_CB(on_header_value_complete)
+
+        /* Possible return values 0, -1, `HPE_PAUSED` */
+        static int __on_message_complete(llhttp_t *lparser)
+        {
+            _LLHTTP_METRIC_CALLBACK(on_message_complete);
+            auto *parser = static_cast<BasicParser *>((Parser *)lparser->data);
+            if constexpr (detail::has__on_message_complete<Setting>::value)
+            {
+                int ret = parser->_callbacks._on_message_complete(parser);
+                if (ret != 0)
+                {
+                    return ret;
+                }
+            }
+            return parser->Parser::__on_message_complete();
+        }
+
+#define _BIND_STATIC_CB(name)                          \
+    if constexpr (detail::has__##name<Setting>::value)  \
+    setting.name = BasicParser::__##name
+
+        static const llhttp_settings_t& __low_layer_setting()
+        {
+            static const llhttp_settings_t low_layer_setting = [] {
+                llhttp_settings_t setting;
+                llhttp_settings_init(&setting);
+                _BIND_STATIC_CB(on_message_begin);
+                _BIND_STATIC_CB(on_url);
+                _BIND_STATIC_CB(on_status);
+                _BIND_STATIC_CB(on_header_field);
+                _BIND_STATIC_CB(on_header_value);
+                _BIND_STATIC_CB(on_headers_complete);
+                _BIND_STATIC_CB(on_body);
+                setting.on_message_complete = BasicParser::__on_message_complete;
+                _BIND_STATIC_CB(on_chunk_header);
+                _BIND_STATIC_CB(on_chunk_complete);
+                _BIND_STATIC_CB(on_url_complete);
+                _BIND_STATIC_CB(on_status_complete);
+                _BIND_STATIC_CB(on_header_field_complete);
+                _BIND_STATIC_CB(on_header_value_complete);
+                return setting;
+            }();
+            return low_layer_setting;
+        }
+
+#undef _BIND_STATIC_CB
+
+        Setting _callbacks;
+    };
+}
+
+#endif
@@ -0,0 +1,122 @@
+#pragma once
+
+#ifndef _LLHTTP_BODY_SINK_HPP_
+#define _LLHTTP_BODY_SINK_HPP_
+#include <cstddef>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/types.h>
+#include <sys/uio.h>
+#endif
+
+namespace llhttplus
+{
+    struct RequestBase;
+
+    /*
+     * Receives the body of a message span by span, as llhttp reports it. The
+     * spans point into the buffer passed to `execute()` and are only valid
+     * during the call.
+     *
+     * Return 0 to continue, or an llhttp errno (`HPE_PAUSED`, `HPE_USER`, ...)
+     * to stop parsing.
+     */
+    class BodySink
+    {
+    public:
+        virtual ~BodySink() = default;
+
+        virtual int write(const RequestBase& request, const char* at, size_t length) = 0;
+
+        /* Called once the message is complete. */
+        virtual int finish(const RequestBase& request)
+        {
+            return 0;
+        }
+    };
+
+    /* Forwards every span to a callable taking `(const char*, size_t)`. */
+    template<class F>
+    class FunctionSink : public BodySink
+    {
+    public:
+        explicit FunctionSink(F f)
+            : _f(std::move(f))
+        {
+        }
+
+        int write(const RequestBase&, const char* at, size_t length) override
+        {
+            if constexpr (std::is_void_v<decltype(_f(at, length))>)
+            {
+                _f(at, length);
+                return 0;
+            }
+            else
+            {
+                return _f(at, length);
+            }
+        }
+
+    private:
+        F _f;
+    };
+
+#if !defined(_WIN32)
+    /*
+     * Collects the spans as an iovec array, e.g. for `writev()`. Nothing is
+     * copied, so the input buffers have to stay alive while the array is used.
+     */
+    class IovecSink : public BodySink
+    {
+    public:
+        explicit IovecSink(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        int write(const RequestBase& request, const char* at, size_t length) override;
+
+        const iovec* data() const;
+
+        size_t size() const;
+
+        /* Returns the total number of bytes referenced. */
+        size_t bytes() const;
+
+        void clear();
+
+    private:
+        std::pmr::vector<iovec> _iov;
+        size_t                  _bytes = 0;
+    };
+
+    /*
+     * Writes the body to a file descriptor as it arrives, with `write()` or,
+     * when an offset is given, `pwrite()`. A failed write stops parsing with
+     * `HPE_USER`; the errno is kept in `error()`, or EIO if a write wrote
+     * nothing.
+     */
+    class FdSink : public BodySink
+    {
+    public:
+        explicit FdSink(int fd, off_t offset = -1);
+
+        int write(const RequestBase& request, const char* at, size_t length) override;
+
+        /* Returns the number of bytes written so far. */
+        size_t written() const;
+
+        int error() const;
+
+    private:
+        int    _fd;
+        off_t  _offset;
+        size_t _written = 0;
+        int    _error = 0;
+    };
+#endif
+}
+
+#endif
@@ -0,0 +1,137 @@
+#pragma once
+
+#ifndef _LLHTTP_COMPACT_REQUEST_HPP_
+#define _LLHTTP_COMPACT_REQUEST_HPP_
+#include "basic_parser.hpp"
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace llhttplus
+{
+    /* Location of a value as offset and length relative to a buffer base. */
+    struct CompactSpan
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct CompactHeader
+    {
+        CompactSpan field;
+        CompactSpan value;
+    };
+
+    /*
+     * Request which refers to its values by 32-bit offsets into one buffer
+     * instead of pointers. Half the size of `Request` per value, and it stays
+     * valid when the buffer is moved or compacted: call `rebase()` with the new
+     * address (or the address the message now starts at) and views are
+     * produced from it on demand.
+     *
+     * All bytes of the message must live in that buffer, which is what a
+     * connection receive buffer provides; values are never copied elsewhere.
+     */
+    struct CompactRequest
+    {
+        explicit CompactRequest(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : headers(resource)
+        {
+        }
+
+        llhttp_method_t                 method = HTTP_GET;
+        uint8_t                         version_major = 0;
+        uint8_t                         version_minor = 0;
+        CompactSpan                     url = {};
+        CompactSpan                     status = {};
+        CompactSpan                     body = {};
+        std::pmr::vector<CompactHeader> headers;
+
+        /* Empties all fields, keeping the base and the header capacity. */
+        void clear()
+        {
+            method = HTTP_GET;
+            version_major = 0;
+            version_minor = 0;
+            url = {};
+            status = {};
+            body = {};
+            headers.clear();
+        }
+
+        /* Points all spans at a new buffer address in O(1). After the buffer
+         * moved by `d` bytes, pass `base() + d`.
+         */
+        void rebase(const char* base)
+        {
+            _base = base;
+        }
+
+        const char* base() const
+        {
+            return _base;
+        }
+
+        std::string_view view(CompactSpan span) const
+        {
+            return std::string_view(_base + span.offset, span.length);
+        }
+
+        Header header(size_t i) const
+        {
+            return { view(headers[i].field), view(headers[i].value) };
+        }
+
+        /* Returns the value of a header, ignoring case, or an empty view. */
+        std::string_view get(std::string_view name) const;
+
+    private:
+        const char* _base = nullptr;
+    };
+
+    /*
+     * Fills a `CompactRequest` bound with `bind()`. Pieces of a value must be
+     * contiguous in the request's buffer; chunked body payloads are moved over
+     * the chunk framing so the body is one span, which requires the buffer to
+     * be mutable.
+     */
+    class CompactSetting
+    {
+    public:
+        /* Sets the request filled by following callbacks; rebinding the same
+         * request keeps a value which is still being received open.
+         */
+        void bind(CompactRequest* request);
+
+        int _on_message_begin(Parser* p);
+        int _on_url(Parser* p, const char* at, size_t length);
+        int _on_status(Parser* p, const char* at, size_t length);
+        int _on_header_field(Parser* p, const char* at, size_t length);
+        int _on_header_value(Parser* p, const char* at, size_t length);
+        int _on_headers_complete(Parser* p);
+        int _on_body(Parser* p, const char* at, size_t length);
+        int _on_url_complete(Parser* p);
+        int _on_status_complete(Parser* p);
+        int _on_header_field_complete(Parser* p);
+        int _on_header_value_complete(Parser* p);
+
+    private:
+        int __append(Parser* p, CompactSpan* span, const char* at, size_t length);
+
+        CompactRequest* _request = nullptr;
+        CompactSpan*    _open = nullptr;
+    };
+
+    class CompactParser : public BasicParser<CompactSetting>
+    {
+    public:
+        /* Parses `data`, which must lie inside the buffer `request` is based
+         * on (see `CompactRequest::rebase()`). `data` is modified only to
+         * compact chunked bodies.
+         */
+        llhttp_errno_t execute(CompactRequest* request, char *data, size_t len) noexcept;
+    };
+}
+
+#endif
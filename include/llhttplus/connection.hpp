@@ -0,0 +1,171 @@
+#pragma once
+
+#ifndef _LLHTTP_CONNECTION_HPP_
+#define _LLHTTP_CONNECTION_HPP_
+#include "compact_request.hpp"
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace llhttplus
+{
+    /* Free space at the end of the receive buffer, see `Connection::prepare()`. */
+    struct ReceiveRegion
+    {
+        char*   data;
+        size_t  size;
+    };
+
+    /*
+     * One HTTP connection: a receive buffer, a parser which is kept across
+     * keep-alive messages, and the messages parsed from it.
+     *
+     *     auto region = connection.prepare();
+     *     ssize_t received = ::recv(fd, region.data, region.size, 0);
+     *     if (received < 0)
+     *     {
+     *         ...retry on EAGAIN or EINTR, close otherwise...
+     *     }
+     *     else if (received == 0)
+     *     {
+     *         if (auto* request = connection.finish())
+     *         {
+     *             ...respond...
+     *         }
+     *         ...close once the live messages are answered...
+     *     }
+     *     else
+     *     {
+     *         connection.commit(static_cast<size_t>(received));
+     *         while (auto* request = connection.next())
+     *         {
+     *             ...respond...
+     *             connection.pop();
+     *         }
+     *     }
+     *
+     * Messages are parsed where they were received; nothing is copied and no
+     * byte is parsed twice. A message yielded by `next()` stays live until
+     * `pop()`, which releases messages in the order they arrived. Only bytes
+     * in front of the oldest live message are discarded when the buffer runs
+     * out of space; the rest is moved to the front and live requests are
+     * rebased, so views taken from them must be taken again after `prepare()`.
+     */
+    class Connection
+    {
+    public:
+        /* The buffer starts at `capacity` bytes and doubles up to
+         * `max_capacity`, the largest message head and body accepted. At most
+         * `max_pipelined` messages are live at once; `next()` stops yielding
+         * until one is popped.
+         */
+        explicit Connection(
+            size_t capacity = 16 * 1024,
+            size_t max_capacity = 1024 * 1024,
+            size_t max_pipelined = 16,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+        );
+
+        Connection(const Connection&) = delete;
+        Connection& operator=(const Connection&) = delete;
+
+        /* Returns at least `min_size` bytes to receive into, compacting or
+         * growing the buffer if needed. The region is smaller if the buffer is
+         * at `max_capacity`, and empty if it is full of unfinished messages.
+         */
+        ReceiveRegion prepare(size_t min_size = 1);
+
+        /* Marks `size` bytes of the last prepared region as received. A size
+         * larger than the region is a bug of the caller (e.g. an unchecked
+         * error of `recv()`) and is ignored; the end of input is signaled with
+         * `finish()`, not with a size of 0.
+         */
+        void commit(size_t size);
+
+        /* Parses received bytes until the next message is complete and returns
+         * it, or nullptr if more bytes are needed, `max_pipelined` messages
+         * are live, the connection is closing, or on an error.
+         */
+        CompactRequest* next();
+
+        /* Signals the end of the input. Returns a message which is terminated
+         * by EOF (a response without length), or nullptr.
+         */
+        CompactRequest* finish();
+
+        /* Releases the oldest live message. Does nothing if none is live. */
+        void pop();
+
+        /* Drops all bytes and messages and resets the parser, keeping the
+         * buffer, for reuse with another peer.
+         */
+        void reset();
+
+        /* Returns the oldest live message. */
+        CompactRequest& front();
+
+        /* Returns the number of messages yielded and not popped yet. */
+        size_t live() const;
+
+        /* Returns true if no bytes are buffered: no live, partial or unparsed
+         * message.
+         */
+        bool empty() const;
+
+        /* Returns false once a message asked to close the connection, was an
+         * upgrade, or parsing failed. No more messages are parsed after that;
+         * close the connection once the live messages are answered.
+         */
+        bool keep_alive() const;
+
+        /* Returns true if the last message switched protocols (Upgrade or
+         * CONNECT). The bytes following it are in `unparsed()`.
+         */
+        bool upgraded() const;
+
+        /* Returns received bytes which were not parsed yet. */
+        std::string_view unparsed() const;
+
+        /* Returns `HPE_OK` unless parsing failed. */
+        llhttp_errno_t error() const;
+
+        /* Returns the parser, e.g. to enable lenient flags. */
+        CompactParser& parser();
+
+    private:
+        struct Slot
+        {
+            explicit Slot(std::pmr::memory_resource* resource)
+                : request(resource)
+            {
+            }
+
+            CompactRequest  request;
+            size_t          begin = 0;  // offset of the message in the buffer
+        };
+
+        Slot& __slot(size_t i);
+
+        CompactRequest* __complete(size_t end);
+
+        void __compact();
+
+        void __rebase();
+
+        CompactParser           _parser;
+        std::pmr::vector<char>  _buffer;
+        std::pmr::vector<Slot>  _slots;
+        size_t                  _max_capacity;
+        size_t                  _head = 0;      // oldest live slot
+        size_t                  _live = 0;
+        bool                    _parsing = false;   // slot `_head + _live` is in progress
+        size_t                  _parsed = 0;
+        size_t                  _end = 0;
+        bool                    _closing = false;
+        bool                    _upgraded = false;
+        llhttp_errno_t          _error = HPE_OK;
+    };
+}
+
+#endif
@@ -0,0 +1,839 @@
+#pragma once
+
+#ifndef _LLHTTP_COROUTINE_HPP_
+#define _LLHTTP_COROUTINE_HPP_
+#include "compact_request.hpp"
+
+/* C++20 only; the rest of the library builds as C++17. */
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <algorithm>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <utility>
+
+namespace llhttplus
+{
+    namespace detail
+    {
+        /* Every frame starts with the resource it came from, so it can be
+         * freed by `operator delete`, which only gets its address and size.
+         */
+        inline constexpr size_t __frame_header = alignof(std::max_align_t);
+
+        inline void* __allocate_frame(std::pmr::memory_resource* resource, size_t size)
+        {
+            auto* p = static_cast<char*>(resource->allocate(size + __frame_header, alignof(std::max_align_t)));
+            *reinterpret_cast<std::pmr::memory_resource**>(p) = resource;
+            return p + __frame_header;
+        }
+
+        inline void __deallocate_frame(void* frame, size_t size)
+        {
+            auto* p = static_cast<char*>(frame) - __frame_header;
+            auto* resource = *reinterpret_cast<std::pmr::memory_resource**>(p);
+            resource->deallocate(p, size + __frame_header, alignof(std::max_align_t));
+        }
+
+        template<class T>
+        concept __FrameOwner = requires(T& owner) {
+            { owner.frames() } -> std::convertible_to<std::pmr::memory_resource*>;
+        };
+
+        class __PromiseBase
+        {
+        public:
+            struct __FinalAwaiter
+            {
+                bool await_ready() noexcept
+                {
+                    return false;
+                }
+
+                template<class Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> coroutine) noexcept
+                {
+                    return coroutine.promise()._continuation;
+                }
+
+                void await_resume() noexcept
+                {
+                }
+            };
+
+            static void* operator new(size_t size)
+            {
+                return __allocate_frame(std::pmr::get_default_resource(), size);
+            }
+
+            static void operator delete(void* frame, size_t size)
+            {
+                __deallocate_frame(frame, size);
+            }
+
+            std::suspend_always initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            __FinalAwaiter final_suspend() noexcept
+            {
+                return {};
+            }
+
+            void unhandled_exception() noexcept
+            {
+                std::terminate();
+            }
+
+            std::coroutine_handle<> _continuation = std::noop_coroutine();
+        };
+
+        template<class T>
+        class __Promise : public __PromiseBase
+        {
+        public:
+            void return_value(T value)
+            {
+                _value.emplace(std::move(value));
+            }
+
+            T __take()
+            {
+                return std::move(*_value);
+            }
+
+        private:
+            std::optional<T> _value;
+        };
+
+        template<>
+        class __Promise<void> : public __PromiseBase
+        {
+        public:
+            void return_void()
+            {
+            }
+
+            void __take()
+            {
+            }
+        };
+
+        template<class T, class Owner, class... Args>
+        class __OwnedPromise;
+    }
+
+    /*
+     * Lazy coroutine: it starts when awaited, and resumes its awaiter by
+     * symmetric transfer when it returns, so chains of tasks neither grow the
+     * stack nor go through a scheduler. Exceptions terminate.
+     *
+     * Frames come from the default resource, or from `frames()` of the first
+     * argument, e.g. an `AsyncConnection`.
+     */
+    template<class T = void>
+    class Task
+    {
+    public:
+        class promise_type : public detail::__Promise<T>
+        {
+        public:
+            Task get_return_object()
+            {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+        };
+
+        Task() = default;
+
+        Task(Task&& other) noexcept
+            : _coroutine(std::exchange(other._coroutine, nullptr))
+            , _promise(std::exchange(other._promise, nullptr))
+        {
+        }
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (_coroutine)
+                {
+                    _coroutine.destroy();
+                }
+                _coroutine = std::exchange(other._coroutine, nullptr);
+                _promise = std::exchange(other._promise, nullptr);
+            }
+            return *this;
+        }
+
+        ~Task()
+        {
+            if (_coroutine)
+            {
+                _coroutine.destroy();
+            }
+        }
+
+        explicit operator bool() const
+        {
+            return static_cast<bool>(_coroutine);
+        }
+
+        /* Runs the task from outside a coroutine until it first suspends. */
+        void start()
+        {
+            _coroutine.resume();
+        }
+
+        bool done() const
+        {
+            return _coroutine.done();
+        }
+
+        /* Returns the value of a task which is done. */
+        T result()
+        {
+            return _promise->__take();
+        }
+
+        auto operator co_await() && noexcept
+        {
+            struct Awaiter
+            {
+                bool await_ready() noexcept
+                {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+                {
+                    promise->_continuation = awaiting;
+                    return coroutine;
+                }
+
+                T await_resume()
+                {
+                    return promise->__take();
+                }
+
+                std::coroutine_handle<>     coroutine;
+                detail::__Promise<T>*       promise;
+            };
+            return Awaiter{ _coroutine, _promise };
+        }
+
+    private:
+        template<class, class, class...> friend class detail::__OwnedPromise;
+
+        template<class Promise>
+        explicit Task(std::coroutine_handle<Promise> coroutine)
+            : _coroutine(coroutine)
+            , _promise(&coroutine.promise())
+        {
+        }
+
+        std::coroutine_handle<>     _coroutine;
+        detail::__Promise<T>*       _promise = nullptr;
+    };
+
+    namespace detail
+    {
+        /*
+         * Promise of a `Task` whose first parameter (or object, for a member
+         * function) has `frames()`: the frame is allocated from there. Picked
+         * by `std::coroutine_traits` below, so `operator new` is a plain
+         * member of a class template and pairs with `operator delete`; as a
+         * member template of the promise it would not, and GCC warns about
+         * mismatched allocation functions.
+         */
+        template<class T, class Owner, class... Args>
+        class __OwnedPromise : public __Promise<T>
+        {
+        public:
+            static void* operator new(size_t size, Owner& owner, Args&...)
+            {
+                return __allocate_frame(owner.frames(), size);
+            }
+
+            static void operator delete(void* frame, size_t size)
+            {
+                __deallocate_frame(frame, size);
+            }
+
+            Task<T> get_return_object()
+            {
+                return Task<T>(std::coroutine_handle<__OwnedPromise>::from_promise(*this));
+            }
+        };
+    }
+}
+
+template<class T, llhttplus::detail::__FrameOwner Owner, class... Args>
+struct std::coroutine_traits<llhttplus::Task<T>, Owner&, Args...>
+{
+    using promise_type = llhttplus::detail::__OwnedPromise<T, Owner, Args...>;
+};
+
+namespace llhttplus
+{
+
+    namespace detail
+    {
+        /* State of the message an `AsyncConnection` is reading. */
+        struct __StreamState
+        {
+            bool        headers = false;    // the head is complete
+            bool        complete = false;   // the message is complete
+            bool        keep_alive = true;
+            const char* piece = nullptr;    // body bytes not read yet
+            size_t      piece_size = 0;
+        };
+
+        /*
+         * `CompactSetting` which pauses on every body piece instead of
+         * collecting the body, and ignores trailers, which would not survive
+         * compaction of the consumed body.
+         */
+        class __StreamSetting : public CompactSetting
+        {
+        public:
+            explicit __StreamSetting(__StreamState* state)
+                : _state(state)
+            {
+            }
+
+            int _on_message_begin(Parser* p)
+            {
+                *_state = {};
+                return CompactSetting::_on_message_begin(p);
+            }
+
+            int _on_url(Parser* p, const char* at, size_t length)
+            {
+                return CompactSetting::_on_url(p, at, length);
+            }
+
+            int _on_status(Parser* p, const char* at, size_t length)
+            {
+                return CompactSetting::_on_status(p, at, length);
+            }
+
+            int _on_header_field(Parser* p, const char* at, size_t length)
+            {
+                return _state->headers ? 0 : CompactSetting::_on_header_field(p, at, length);
+            }
+
+            int _on_header_value(Parser* p, const char* at, size_t length)
+            {
+                return _state->headers ? 0 : CompactSetting::_on_header_value(p, at, length);
+            }
+
+            int _on_headers_complete(Parser* p)
+            {
+                _state->headers = true;
+                return CompactSetting::_on_headers_complete(p);
+            }
+
+            int _on_body(Parser* p, const char* at, size_t length)
+            {
+                if (length == 0)
+                {
+                    return 0;
+                }
+                _state->piece = at;
+                _state->piece_size = length;
+                return HPE_PAUSED;
+            }
+
+            int _on_message_complete(Parser* p)
+            {
+                _state->complete = true;
+                _state->keep_alive = p->should_keep_alive() && !p->get_upgrade();
+                return 0;
+            }
+
+            int _on_url_complete(Parser* p)
+            {
+                return CompactSetting::_on_url_complete(p);
+            }
+
+            int _on_status_complete(Parser* p)
+            {
+                return CompactSetting::_on_status_complete(p);
+            }
+
+            int _on_header_field_complete(Parser* p)
+            {
+                return CompactSetting::_on_header_field_complete(p);
+            }
+
+            int _on_header_value_complete(Parser* p)
+            {
+                return CompactSetting::_on_header_value_complete(p);
+            }
+
+        private:
+            __StreamState* _state;
+        };
+    }
+
+    /*
+     * Reads HTTP messages from an asynchronous byte stream with coroutines.
+     *
+     *     while (auto* request = co_await connection.next_request())
+     *     {
+     *         char chunk[4096];
+     *         while (size_t n = co_await connection.body().read_some(chunk))
+     *         {
+     *             ...consume n bytes...
+     *         }
+     *         ...respond...
+     *     }
+     *
+     * `Source` is awaited for more bytes: `co_await source.read_some(span)`
+     * reads into a `std::span<char>` and returns how many bytes it read, 0 at
+     * EOF or on an error. Awaiting the connection suspends only to read;
+     * whatever can be parsed from buffered bytes is returned right away
+     * without creating a coroutine.
+     *
+     * The head of the current message stays at the front of the receive
+     * buffer until the next message, and views taken from it must be taken
+     * again after the body was read. The body is not buffered: it is handed
+     * out where it was received and dropped as soon as it was read, so it is
+     * not limited by `max_capacity`, and an unread body is skipped by
+     * `next_request()`. Trailers are ignored.
+     *
+     * Coroutine frames, its own and those of coroutines which take the
+     * connection as their first parameter, are allocated from a pool owned by
+     * the connection.
+     */
+    template<class Source>
+    class AsyncConnection
+    {
+        enum class State : uint8_t
+        {
+            idle,   // between messages
+            head,
+            body,
+        };
+
+        static constexpr size_t __min_read = 4096;
+
+    public:
+        class NextRequest;
+        class ReadSome;
+
+        /* Body of the current message, see `AsyncConnection::body()`. */
+        class Body
+        {
+        public:
+            /* Copies up to `out.size()` body bytes into `out`, which must not
+             * be empty. Returns 0 once the body is over.
+             */
+            ReadSome read_some(std::span<char> out)
+            {
+                return ReadSome(_connection, out);
+            }
+
+        private:
+            friend class AsyncConnection;
+
+            explicit Body(AsyncConnection* connection)
+                : _connection(connection)
+            {
+            }
+
+            AsyncConnection* _connection;
+        };
+
+        /* Awaitable result of `next_request()`. */
+        class NextRequest
+        {
+        public:
+            bool await_ready()
+            {
+                return _connection->__try_next(&_request);
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting)
+            {
+                _slow = _connection->__next_slow();
+                return std::move(_slow).operator co_await().await_suspend(awaiting);
+            }
+
+            CompactRequest* await_resume()
+            {
+                return _slow ? _slow.result() : _request;
+            }
+
+        private:
+            friend class AsyncConnection;
+
+            explicit NextRequest(AsyncConnection* connection)
+                : _connection(connection)
+            {
+            }
+
+            AsyncConnection*        _connection;
+            CompactRequest*         _request = nullptr;
+            Task<CompactRequest*>   _slow;
+        };
+
+        /* Awaitable result of `Body::read_some()`. */
+        class ReadSome
+        {
+        public:
+            bool await_ready()
+            {
+                return _connection->__try_read(_out, &_size);
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting)
+            {
+                _slow = _connection->__read_slow(_out);
+                return std::move(_slow).operator co_await().await_suspend(awaiting);
+            }
+
+            size_t await_resume()
+            {
+                return _slow ? _slow.result() : _size;
+            }
+
+        private:
+            friend class Body;
+
+            ReadSome(AsyncConnection* connection, std::span<char> out)
+                : _connection(connection)
+                , _out(out)
+            {
+            }
+
+            AsyncConnection*    _connection;
+            std::span<char>     _out;
+            size_t              _size = 0;
+            Task<size_t>        _slow;
+        };
+
+        /* The buffer starts at `capacity` bytes and doubles up to
+         * `max_capacity`, the largest message head accepted.
+         */
+        explicit AsyncConnection(
+            Source& source,
+            size_t capacity = 16 * 1024,
+            size_t max_capacity = 1024 * 1024,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+        )
+            : _source(source)
+            , _frames(resource)
+            , _parser(&_stream)
+            , _request(resource)
+            , _buffer(std::min(std::max(capacity, __min_read), std::max(max_capacity, __min_read)), resource)
+            , _max_capacity(std::max(max_capacity, __min_read))
+        {
+            _parser.pause_on_message_complete(true);
+            _parser.callbacks().bind(&_request);
+        }
+
+        AsyncConnection(const AsyncConnection&) = delete;
+        AsyncConnection& operator=(const AsyncConnection&) = delete;
+
+        /* Skips the rest of the current message and awaits the head of the
+         * next one. Returns nullptr at the end of the stream, after a message
+         * which closes the connection, or on an error.
+         */
+        NextRequest next_request()
+        {
+            return NextRequest(this);
+        }
+
+        /* Returns the body of the message `next_request()` returned last. */
+        Body body()
+        {
+            return Body(this);
+        }
+
+        /* Returns false once a message asked to close the connection, was an
+         * upgrade, the stream ended, or parsing failed.
+         */
+        bool keep_alive() const
+        {
+            return !_closed;
+        }
+
+        /* Returns `HPE_OK` unless parsing failed; `HPE_USER` if a head did not
+         * fit into `max_capacity`.
+         */
+        llhttp_errno_t error() const
+        {
+            return _error;
+        }
+
+        /* Returns the parser, e.g. to enable lenient flags. */
+        Parser& parser()
+        {
+            return _parser;
+        }
+
+        /* Pool coroutine frames are allocated from. */
+        std::pmr::memory_resource* frames()
+        {
+            return &_frames;
+        }
+
+    private:
+        /* Parses the buffered bytes until the head of the next message is
+         * complete. Returns false if more bytes are needed.
+         */
+        bool __try_next(CompactRequest** request)
+        {
+            for (;;)
+            {
+                if (_state == State::body)
+                {
+                    _stream.piece_size = 0;
+                    if (_stream.complete)
+                    {
+                        __end_message();
+                    }
+                    else if (!__step())
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+
+                if (_closed)
+                {
+                    *request = nullptr;
+                    return true;
+                }
+
+                if (_state == State::idle)
+                {
+                    if (_parsed == _end)
+                    {
+                        /* Nothing is referenced: start over at the front. */
+                        _parsed = 0;
+                        _end = 0;
+                        if (!_eof)
+                        {
+                            return false;
+                        }
+                        _closed = true;
+                        continue;
+                    }
+                    _state = State::head;
+                    _head = _parsed;
+                    _request.rebase(_buffer.data() + _head);
+                    _stream = {};
+                }
+
+                if (_stream.headers)
+                {
+                    /* The body starts after the head; parsed body bytes are
+                     * dropped by compaction.
+                     */
+                    const char* body = _stream.piece_size != 0 ? _stream.piece : _buffer.data() + _parsed;
+                    _head_size = body - (_buffer.data() + _head);
+                    _state = State::body;
+                    *request = &_request;
+                    return true;
+                }
+
+                if (!__step())
+                {
+                    return false;
+                }
+            }
+        }
+
+        /* Copies body bytes into `out` from the buffered bytes. Returns false
+         * if more bytes are needed.
+         */
+        bool __try_read(std::span<char> out, size_t* size)
+        {
+            for (;;)
+            {
+                if (_state != State::body)
+                {
+                    *size = 0;
+                    return true;
+                }
+
+                if (_stream.piece_size != 0)
+                {
+                    *size = std::min(out.size(), _stream.piece_size);
+                    std::memcpy(out.data(), _stream.piece, *size);
+                    _stream.piece += *size;
+                    _stream.piece_size -= *size;
+                    return true;
+                }
+
+                if (_stream.complete)
+                {
+                    __end_message();
+                }
+                else if (!__step())
+                {
+                    return false;
+                }
+            }
+        }
+
+        Task<CompactRequest*> __next_slow()
+        {
+            CompactRequest* request = nullptr;
+            while (!__try_next(&request))
+            {
+                co_await __receive();
+            }
+            co_return request;
+        }
+
+        Task<size_t> __read_slow(std::span<char> out)
+        {
+            size_t size = 0;
+            while (!__try_read(out, &size))
+            {
+                co_await __receive();
+            }
+            co_return size;
+        }
+
+        /* Awaits more bytes from the source; the only suspension point. */
+        Task<> __receive()
+        {
+            auto space = __reserve();
+            if (space.empty())
+            {
+                __fail(HPE_USER);
+                co_return;
+            }
+
+            size_t size = co_await _source.read_some(space);
+            if (size == 0)
+            {
+                _eof = true;
+            }
+            _end += std::min(size, space.size());
+        }
+
+        /* Runs the parser once over the unparsed bytes. Returns false if it
+         * needs more bytes.
+         */
+        bool __step()
+        {
+            char* data = _buffer.data();
+            auto err = _parser.execute(nullptr, data + _parsed, _end - _parsed);
+            if (err == HPE_PAUSED)
+            {
+                _parsed = _parser.get_error_pos() - data;
+                _parser.resume();
+                return true;
+            }
+
+            if (err != HPE_OK)
+            {
+                __fail(err);
+                return true;
+            }
+
+            _parsed = _end;
+            if (!_eof)
+            {
+                return false;
+            }
+
+            /* Only a message without length may end at EOF. */
+            err = _parser.finish();
+            if (!_stream.complete)
+            {
+                __fail(err != HPE_OK && err != HPE_PAUSED ? err : HPE_INVALID_EOF_STATE);
+            }
+            return true;
+        }
+
+        void __end_message()
+        {
+            _state = State::idle;
+            if (!_stream.keep_alive)
+            {
+                _closed = true;
+            }
+        }
+
+        void __fail(llhttp_errno_t err)
+        {
+            _error = err;
+            _closed = true;
+            _state = State::idle;
+            _stream.piece_size = 0;
+        }
+
+        /* Returns free space to receive into, moving the head of the current
+         * message and the unparsed bytes to the front of the buffer, or
+         * growing it. Empty if a head fills `max_capacity`.
+         */
+        std::span<char> __reserve()
+        {
+            if (_buffer.size() - _end < __min_read)
+            {
+                __compact();
+            }
+
+            if (_buffer.size() - _end < __min_read && _buffer.size() < _max_capacity)
+            {
+                _buffer.resize(std::min(_buffer.size() * 2, _max_capacity));
+                _request.rebase(_buffer.data() + _head);
+            }
+            return std::span<char>(_buffer.data() + _end, _buffer.size() - _end);
+        }
+
+        void __compact()
+        {
+            char* data = _buffer.data();
+            size_t head = 0;
+            if (_state == State::head)
+            {
+                head = _parsed - _head;
+            }
+            else if (_state == State::body)
+            {
+                head = _head_size;
+            }
+
+            std::memmove(data, data + _head, head);
+            std::memmove(data + head, data + _parsed, _end - _parsed);
+            _end = head + (_end - _parsed);
+            _parsed = head;
+            _head = 0;
+            _request.rebase(data);
+        }
+
+        Source&                                 _source;
+        std::pmr::unsynchronized_pool_resource  _frames;
+        detail::__StreamState                   _stream;
+        BasicParser<detail::__StreamSetting>    _parser;
+        CompactRequest                          _request;
+        std::pmr::vector<char>                  _buffer;
+        size_t                                  _max_capacity;
+        State                                   _state = State::idle;
+        size_t                                  _head = 0;      // offset of the current message
+        size_t                                  _head_size = 0;
+        size_t                                  _parsed = 0;
+        size_t                                  _end = 0;
+        bool                                    _eof = false;
+        bool                                    _closed = false;
+        llhttp_errno_t                          _error = HPE_OK;
+    };
+}
+
+#endif
+
+#endif
@@ -0,0 +1,170 @@
+#pragma once
+
+#ifndef _LLHTTP_DEFAULT_SETTING_HPP_
+#define _LLHTTP_DEFAULT_SETTING_HPP_
+#include "header_filter.hpp"
+#include "setting.hpp"
+#include <type_traits>
+
+namespace llhttplus
+{
+    /*
+     * Fills the bound request with zero-copy views, stitching values which
+     * cross `execute()` calls, and indexes known headers. Only headers selected
+     * by `Filter` (see header_filter.hpp) are stored; the name of a dropped
+     * header is discarded once complete and its value is never touched.
+     *
+     * The body is streamed to `RequestBase::body_sink` when one is set.
+     * Otherwise `body` holds the body as long as it arrives in one contiguous
+     * piece, and the last piece if not, unless the buffer was passed to
+     * `Parser::execute_in_place()`, which always yields the whole body.
+     */
+    template<class Filter>
+    class FilteredSetting : public ParserSetting<FilteredSetting<Filter>>
+    {
+    public:
+        int _on_message_begin(Parser* p)
+        {
+            p->request()->clear();
+            return 0;
+        }
+
+        int _on_url(Parser* p, const char* at, size_t length)
+        {
+            p->stitcher().append(&p->request()->url, at, length);
+            return 0;
+        }
+
+        int _on_status(Parser* p, const char* at, size_t length)
+        {
+            p->stitcher().append(&p->request()->status, at, length);
+            return 0;
+        }
+
+        int _on_header_field(Parser* p, const char* at, size_t length)
+        {
+            auto& headers = p->request()->headers;
+            if (headers.empty() || !p->stitcher().is_open(&headers.back().first))
+            {
+                headers.push_back({ std::string_view(), std::string_view() });
+            }
+            p->stitcher().append(&headers.back().first, at, length);
+            return 0;
+        }
+
+        int _on_header_value(Parser* p, const char* at, size_t length)
+        {
+            auto& header = p->request()->headers.back();
+            if (!__dropped(header))
+            {
+                p->stitcher().append(&header.second, at, length);
+            }
+            return 0;
+        }
+
+        int _on_body(Parser* p, const char* at, size_t length)
+        {
+            auto* request = p->request();
+            if (request->body_sink != nullptr)
+            {
+                return request->body_sink->write(*request, at, length);
+            }
+
+            if (p->in_place())
+            {
+                p->stitcher().append_in_place(&request->body, const_cast<char*>(at), length);
+                return 0;
+            }
+
+            auto& body = request->body;
+            if (!body.empty() && at == body.data() + body.size())
+            {
+                body = std::string_view(body.data(), body.size() + length);
+            }
+            else
+            {
+                body = std::string_view(at, length);
+            }
+            return 0;
+        }
+
+        int _on_headers_complete(Parser* p)
+        {
+            p->request()->method = p->get_method();
+            p->request()->version_major = p->get_http_major();
+            p->request()->version_minor = p->get_http_minor();
+            return 0;
+        }
+
+        int _on_message_complete(Parser* p)
+        {
+            p->stitcher().close();
+
+            auto* request = p->request();
+            if (request->body_sink != nullptr)
+            {
+                return request->body_sink->finish(*request);
+            }
+            return 0;
+        }
+
+        int _on_url_complete(Parser* p)
+        {
+            p->stitcher().close();
+            return 0;
+        }
+
+        int _on_status_complete(Parser* p)
+        {
+            p->stitcher().close();
+            return 0;
+        }
+
+        int _on_header_field_complete(Parser* p)
+        {
+            p->stitcher().close();
+
+            auto* request = p->request();
+            auto& header = request->headers.back();
+            auto known = classify_header(header.first);
+            if (!Filter::capture(header.first, known))
+            {
+                /* An empty name marks the header as dropped until its value ends. */
+                header.first = std::string_view();
+                return 0;
+            }
+            request->index_header(request->headers.size() - 1, known);
+            return 0;
+        }
+
+        int _on_header_value_complete(Parser* p)
+        {
+            p->stitcher().close();
+
+            auto& headers = p->request()->headers;
+            if (__dropped(headers.back()))
+            {
+                headers.pop_back();
+            }
+            return 0;
+        }
+
+    private:
+        static bool __dropped(const Header& header)
+        {
+            if constexpr (std::is_same_v<Filter, CaptureAll>)
+            {
+                return false;
+            }
+            else
+            {
+                return header.first.data() == nullptr;
+            }
+        }
+    };
+
+    /* Settings used by `Parser()`; stores every header. */
+    using DefaultSetting = FilteredSetting<CaptureAll>;
+}
+
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+
+#ifndef _LLHTTP_FAST_PATH_HPP_
+#define _LLHTTP_FAST_PATH_HPP_
+#include <cstddef>
+#include <cstdint>
+
+namespace llhttplus
+{
+    struct RequestBase;
+
+    /* Returns the instruction set picked at runtime for the fast path
+     * scanners: "avx2", "sse2" or "scalar".
+     */
+    const char* fast_path_isa();
+
+    namespace detail
+    {
+        /*
+         * Parses `data` into `request` if it is exactly one complete request of
+         * the common shape: GET/HEAD/POST/PUT/DELETE/OPTIONS/PATCH, HTTP/1.0
+         * or 1.1, CRLF line ends, no line folding, no Transfer-Encoding or
+         * Upgrade, a body only by Content-Length, and a connection which stays
+         * open.
+         *
+         * Returns false for anything else, leaving `request` in an unspecified
+         * state; llhttp has to parse the data then, and reports any error.
+         */
+        bool __fast_parse(RequestBase* request, const char* data, size_t len);
+    }
+}
+
+#endif
@@ -0,0 +1,108 @@
+#pragma once
+
+#ifndef _LLHTTP_HEADER_FILTER_HPP_
+#define _LLHTTP_HEADER_FILTER_HPP_
+#include "known_header.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace llhttplus
+{
+    /*
+     * Header filters decide at compile time which headers `FilteredSetting`
+     * stores. A filter is any type with
+     *
+     *   static constexpr bool capture(std::string_view name, KnownHeader known);
+     *
+     * where `known` is the already classified name (`KnownHeader::Unknown` for
+     * custom headers). Headers which are not captured are never stored,
+     * stitched or indexed.
+     */
+    static_assert(known_header_count <= 64, "known header masks need more bits");
+
+    namespace detail
+    {
+        template<KnownHeader... Headers>
+        inline constexpr uint64_t known_header_mask = (uint64_t(0) | ... | (uint64_t(1) << static_cast<size_t>(Headers)));
+
+        constexpr bool __in_mask(uint64_t mask, KnownHeader known)
+        {
+            return known != KnownHeader::Unknown && (mask >> static_cast<size_t>(known)) & 1;
+        }
+
+        template<size_t N>
+        constexpr bool __in_names(const std::string_view (&names)[N], std::string_view name)
+        {
+            for (auto candidate : names)
+            {
+                if (__iequals(candidate, name))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+
+    /* Stores every header. */
+    struct CaptureAll
+    {
+        static constexpr bool capture(std::string_view, KnownHeader)
+        {
+            return true;
+        }
+    };
+
+    /* Stores only the listed headers; custom headers are dropped. */
+    template<KnownHeader... Headers>
+    struct CaptureOnly
+    {
+        static constexpr bool capture(std::string_view, KnownHeader known)
+        {
+            return detail::__in_mask(detail::known_header_mask<Headers...>, known);
+        }
+    };
+
+    /* Stores everything except the listed headers; custom headers are kept. */
+    template<KnownHeader... Headers>
+    struct CaptureExcept
+    {
+        static constexpr bool capture(std::string_view, KnownHeader known)
+        {
+            return !detail::__in_mask(detail::known_header_mask<Headers...>, known);
+        }
+    };
+
+    /*
+     * Stores only headers named in `Names`, ignoring case, so custom headers
+     * can be selected as well. `Names` is a constexpr array with static
+     * storage:
+     *
+     *     inline constexpr std::string_view edge_headers[] = { "Host", "X-Api-Key" };
+     *     BasicParser<FilteredSetting<CaptureNamed<edge_headers>>> parser;
+     *
+     * Each header is compared against the list in turn, so keep it short;
+     * known headers are cheaper to select with `CaptureOnly`.
+     */
+    template<const auto& Names>
+    struct CaptureNamed
+    {
+        static constexpr bool capture(std::string_view name, KnownHeader)
+        {
+            return detail::__in_names(Names, name);
+        }
+    };
+
+    /* Stores everything except the headers named in `Names`, ignoring case. */
+    template<const auto& Names>
+    struct CaptureExceptNamed
+    {
+        static constexpr bool capture(std::string_view name, KnownHeader)
+        {
+            return !detail::__in_names(Names, name);
+        }
+    };
+}
+
+#endif
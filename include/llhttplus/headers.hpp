@@ -0,0 +1,138 @@
+#pragma once
+
+#ifndef _LLHTTP_HEADERS_HPP_
+#define _LLHTTP_HEADERS_HPP_
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <string_view>
+#include <utility>
+
+namespace llhttplus
+{
+    using Header = std::pair<std::string_view, std::string_view>;
+
+    /*
+     * Contiguous list of headers which starts in storage provided by the owner
+     * (see `BasicRequest<N>`) and spills to its memory resource only once that
+     * inline capacity is exhausted.
+     *
+     * This class does not know the inline capacity, so code taking a
+     * `HeaderList&` works with requests of any size.
+     */
+    class HeaderList
+    {
+    public:
+        using value_type     = Header;
+        using iterator       = Header*;
+        using const_iterator = const Header*;
+
+        /* `inline_data` must outlive the list and hold `inline_capacity` headers. */
+        HeaderList(Header* inline_data, size_t inline_capacity, std::pmr::memory_resource* resource);
+
+        HeaderList(const HeaderList&) = delete;
+        HeaderList& operator=(const HeaderList& other);
+        ~HeaderList();
+
+        iterator begin()
+        {
+            return _data;
+        }
+
+        iterator end()
+        {
+            return _data + _size;
+        }
+
+        const_iterator begin() const
+        {
+            return _data;
+        }
+
+        const_iterator end() const
+        {
+            return _data + _size;
+        }
+
+        size_t size() const
+        {
+            return _size;
+        }
+
+        size_t capacity() const
+        {
+            return _capacity;
+        }
+
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+        /* Returns true once the headers no longer fit into the inline storage. */
+        bool spilled() const
+        {
+            return _data != _inline;
+        }
+
+        Header& operator[](size_t i)
+        {
+            return _data[i];
+        }
+
+        const Header& operator[](size_t i) const
+        {
+            return _data[i];
+        }
+
+        Header& back()
+        {
+            return _data[_size - 1];
+        }
+
+        const Header& back() const
+        {
+            return _data[_size - 1];
+        }
+
+        void push_back(const Header& header)
+        {
+            if (_size == _capacity)
+            {
+                __grow();
+            }
+            new (_data + _size++) Header(header);
+        }
+
+        void pop_back()
+        {
+            --_size;
+        }
+
+        /* Removes all headers, keeping the current capacity. */
+        void clear()
+        {
+            _size = 0;
+        }
+
+        /* Removes all headers and returns to the inline storage. */
+        void release();
+
+        std::pmr::memory_resource* resource() const
+        {
+            return _resource;
+        }
+
+    private:
+        void __grow();
+
+        Header* _data;
+        size_t  _size;
+        size_t  _capacity;
+        Header* _inline;
+        size_t  _inline_capacity;
+        std::pmr::memory_resource* _resource;
+    };
+}
+
+#endif
@@ -0,0 +1,243 @@
+#pragma once
+
+#ifndef _LLHTTP_KNOWN_HEADER_HPP_
+#define _LLHTTP_KNOWN_HEADER_HPP_
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace llhttplus
+{
+    /* Common request/response headers from the IANA registry. */
+    enum class KnownHeader : uint8_t
+    {
+        Accept,
+        AcceptCharset,
+        AcceptEncoding,
+        AcceptLanguage,
+        AcceptRanges,
+        AccessControlRequestHeaders,
+        AccessControlRequestMethod,
+        Age,
+        Allow,
+        Authorization,
+        CacheControl,
+        Connection,
+        ContentDisposition,
+        ContentEncoding,
+        ContentLanguage,
+        ContentLength,
+        ContentLocation,
+        ContentRange,
+        ContentType,
+        Cookie,
+        Date,
+        ETag,
+        Expect,
+        Expires,
+        Forwarded,
+        From,
+        Host,
+        IfMatch,
+        IfModifiedSince,
+        IfNoneMatch,
+        IfRange,
+        IfUnmodifiedSince,
+        KeepAlive,
+        LastModified,
+        Location,
+        MaxForwards,
+        Origin,
+        Pragma,
+        ProxyAuthorization,
+        Range,
+        Referer,
+        RetryAfter,
+        Server,
+        SetCookie,
+        TE,
+        Trailer,
+        TransferEncoding,
+        Upgrade,
+        UserAgent,
+        Vary,
+        Via,
+        WWWAuthenticate,
+        XForwardedFor,
+        XForwardedHost,
+        XForwardedProto,
+        XRequestId,
+        Unknown
+    };
+
+    inline constexpr size_t known_header_count = static_cast<size_t>(KnownHeader::Unknown);
+
+    /* Canonical spelling, indexed by `KnownHeader`. */
+    inline constexpr std::string_view known_header_names[known_header_count] = {
+        "Accept",
+        "Accept-Charset",
+        "Accept-Encoding",
+        "Accept-Language",
+        "Accept-Ranges",
+        "Access-Control-Request-Headers",
+        "Access-Control-Request-Method",
+        "Age",
+        "Allow",
+        "Authorization",
+        "Cache-Control",
+        "Connection",
+        "Content-Disposition",
+        "Content-Encoding",
+        "Content-Language",
+        "Content-Length",
+        "Content-Location",
+        "Content-Range",
+        "Content-Type",
+        "Cookie",
+        "Date",
+        "ETag",
+        "Expect",
+        "Expires",
+        "Forwarded",
+        "From",
+        "Host",
+        "If-Match",
+        "If-Modified-Since",
+        "If-None-Match",
+        "If-Range",
+        "If-Unmodified-Since",
+        "Keep-Alive",
+        "Last-Modified",
+        "Location",
+        "Max-Forwards",
+        "Origin",
+        "Pragma",
+        "Proxy-Authorization",
+        "Range",
+        "Referer",
+        "Retry-After",
+        "Server",
+        "Set-Cookie",
+        "TE",
+        "Trailer",
+        "Transfer-Encoding",
+        "Upgrade",
+        "User-Agent",
+        "Vary",
+        "Via",
+        "WWW-Authenticate",
+        "X-Forwarded-For",
+        "X-Forwarded-Host",
+        "X-Forwarded-Proto",
+        "X-Request-Id",
+    };
+
+    namespace detail
+    {
+        constexpr unsigned char __lower(char c)
+        {
+            return static_cast<unsigned char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+        }
+
+        constexpr bool __iequals(std::string_view a, std::string_view b)
+        {
+            if (a.size() != b.size())
+            {
+                return false;
+            }
+            for (size_t i = 0; i < a.size(); ++i)
+            {
+                if (__lower(a[i]) != __lower(b[i]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        inline constexpr unsigned known_header_table_bits = 9;
+        inline constexpr size_t known_header_table_size = size_t(1) << known_header_table_bits;
+
+        /* Looks at the length and three bytes only; the result is verified
+         * against the canonical name, so this needs to be injective over the
+         * known headers and nothing else.
+         */
+        constexpr uint32_t __known_header_hash(std::string_view name, uint32_t seed)
+        {
+            uint32_t h = static_cast<uint32_t>(name.size()) * 0x9E3779B1u;
+            h = (h ^ __lower(name[0])) * seed;
+            h = (h ^ __lower(name[name.size() / 2])) * seed;
+            h = (h ^ __lower(name[name.size() - 1])) * seed;
+            return h >> (32 - known_header_table_bits);
+        }
+
+        constexpr bool __is_perfect(uint32_t seed)
+        {
+            bool used[known_header_table_size] = {};
+            for (auto name : known_header_names)
+            {
+                auto slot = __known_header_hash(name, seed);
+                if (used[slot])
+                {
+                    return false;
+                }
+                used[slot] = true;
+            }
+            return true;
+        }
+
+        constexpr uint32_t __find_seed()
+        {
+            for (uint32_t seed = 0x01000193u; ; seed += 2)
+            {
+                if (__is_perfect(seed))
+                {
+                    return seed;
+                }
+            }
+        }
+
+        struct KnownHeaderTable
+        {
+            uint32_t    seed;
+            KnownHeader slots[known_header_table_size];
+        };
+
+        constexpr KnownHeaderTable __build_table()
+        {
+            KnownHeaderTable table{ __find_seed(), {} };
+            for (auto& slot : table.slots)
+            {
+                slot = KnownHeader::Unknown;
+            }
+            for (size_t i = 0; i < known_header_count; ++i)
+            {
+                table.slots[__known_header_hash(known_header_names[i], table.seed)] = static_cast<KnownHeader>(i);
+            }
+            return table;
+        }
+
+        inline constexpr KnownHeaderTable known_header_table = __build_table();
+    }
+
+    /* Maps a header name to its `KnownHeader`, ignoring case. Returns
+     * `KnownHeader::Unknown` for custom headers.
+     */
+    constexpr KnownHeader classify_header(std::string_view name)
+    {
+        if (name.empty())
+        {
+            return KnownHeader::Unknown;
+        }
+
+        auto known = detail::known_header_table.slots[detail::__known_header_hash(name, detail::known_header_table.seed)];
+        if (known == KnownHeader::Unknown
+            || !detail::__iequals(name, known_header_names[static_cast<size_t>(known)]))
+        {
+            return KnownHeader::Unknown;
+        }
+        return known;
+    }
+}
+
+#endif
@@ -3,37 +3,162 @@
 #ifndef _LLHTTP_HPP_
 #define _LLHTTP_HPP_
 #include "llhttp.h"
+#include "arena.hpp"
+#include "body_sink.hpp"
+#include "fast_path.hpp"
+#include "headers.hpp"
+#include "known_header.hpp"
+#include "stitch.hpp"
+#include <algorithm>
+#include <iterator>
 #include <string>
 #include <vector>
 #include <string_view>
 #include <memory>
+#include <memory_resource>
+#include <type_traits>
 
 namespace llhttplus
 {
-    using Header = std::pair<std::string_view, std::string_view>;
+    template<class T> class ParserSetting;
+    template<class Filter> class FilteredSetting;
+    struct CaptureAll;
 
-    struct Request
+    namespace detail
+    {
+        /* True for `DefaultSetting`, whose work `Parser::execute_fast()` may do itself. */
+        template<class Setting>
+        inline constexpr bool __is_default_setting = std::is_same_v<Setting, FilteredSetting<CaptureAll>>;
+    }
+
+    /*
+     * Parsed message without its inline header storage. The parser and
+     * settings work on this type so they accept a `BasicRequest<N>` of any N.
+     */
+    struct RequestBase
     {
         llhttp_method_t     method;
         std::string_view    url;
         uint8_t             version_major;
         uint8_t             version_minor;
-        std::vector<Header> headers;
+        HeaderList          headers;
         std::string_view    status;
         std::string_view    body;
+
+        /* Position + 1 in `headers` of the first occurrence of each known
+         * header, 0 if absent.
+         */
+        uint16_t            header_index[known_header_count];
+
+        /* If set, body spans are streamed here instead of being kept in
+         * `body`. Not touched by `clear()`.
+         */
+        BodySink*           body_sink;
+
+        /* Empties all fields, keeping the header capacity. */
+        void clear()
+        {
+            method = HTTP_GET;
+            url = std::string_view();
+            version_major = 0;
+            version_minor = 0;
+            headers.clear();
+            status = std::string_view();
+            body = std::string_view();
+            std::fill(std::begin(header_index), std::end(header_index), 0);
+        }
+
+        /* Records `headers[position]`, whose name classifies as `known`, in the
+         * index. Settings call this once the header field is complete.
+         */
+        void index_header(size_t position, KnownHeader known)
+        {
+            if (known != KnownHeader::Unknown
+                && header_index[static_cast<size_t>(known)] == 0
+                && position < UINT16_MAX)
+            {
+                header_index[static_cast<size_t>(known)] = static_cast<uint16_t>(position + 1);
+            }
+        }
+
+        /* Returns the value of a known header in O(1), or an empty view. */
+        std::string_view get(KnownHeader header) const
+        {
+            auto position = header_index[static_cast<size_t>(header)];
+            return position == 0 ? std::string_view() : headers[position - 1].second;
+        }
+
+        /* Returns the value of any header, ignoring case, or an empty view.
+         * Only known headers are O(1), from the index; any other name is a
+         * linear scan of `headers`.
+         */
+        std::string_view get(std::string_view name) const;
+
+    protected:
+        RequestBase(Header* inline_headers, size_t inline_capacity, std::pmr::memory_resource* resource)
+            : headers(inline_headers, inline_capacity, resource)
+            , header_index()
+            , body_sink(nullptr)
+        {
+        }
+
+        RequestBase& operator=(const RequestBase&) = default;
     };
 
+    /*
+     * Request holding up to N headers inline. Only further headers are
+     * allocated, from `resource`; pass `&parser.arena()` to take them from the
+     * parser's arena. Such a request must not outlive `Parser::reset()`.
+     */
+    template<size_t N>
+    struct BasicRequest : public RequestBase
+    {
+        explicit BasicRequest(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : RequestBase(reinterpret_cast<Header*>(_inline_headers), N, resource)
+        {
+        }
+
+        BasicRequest(const BasicRequest& other)
+            : BasicRequest(other.headers.resource())
+        {
+            RequestBase::operator=(other);
+        }
+
+        BasicRequest& operator=(const BasicRequest& other)
+        {
+            RequestBase::operator=(other);
+            return *this;
+        }
+
+    private:
+        alignas(64) unsigned char _inline_headers[(N > 0 ? N : 1) * sizeof(Header)];
+    };
+
+    using Request = BasicRequest<24>;
+
+    struct BatchResult
+    {
+        size_t          completed;  // number of slots holding a complete message
+        size_t          consumed;   // number of input bytes parsed
+        llhttp_errno_t  error;      // `HPE_OK` unless parsing stopped on an error
+    };
+
+    class ParserGroup;
+    class ParserPool;
+
     class Parser
     {
     public:
         template<class T> friend class ParserSetting;
+        friend class ParserGroup;
+        friend class ParserPool;
 
         Parser();
 
         template<class Setting>
         Parser(ParserSetting<Setting>* setting)
         {
-            __init(&setting->low_layer_setting());
+            __init(&setting->low_layer_setting(), setting, detail::__is_default_setting<Setting>);
         }
 
     public:
@@ -52,6 +177,10 @@ namespace llhttplus
         /*
          * Reset an already initialized parser back to the start state, preserving the
          * existing parser type, callback settings, user data, and lenient flags.
+         *
+         * The arena is rewound in O(1), releasing stitched values and the header
+         * storage of arena-backed requests, so views into them must not be used
+         * after this call.
          */
         void reset();
 
@@ -70,10 +199,66 @@ namespace llhttplus
          * NOTE: if this function ever returns a non-pause type error, it will continue
          * to return the same error upon each successive call up until `llhttp_init()`
          * is called.
+         *
+         * `_request` must stay the same until its message is complete. Passing
+         * another one in the middle of a message drops a value still open in the
+         * previous request, which keeps the part received so far.
+         */
+        llhttp_errno_t execute(RequestBase* _request, const char *data, size_t len) noexcept;
+        llhttp_errno_t execute(RequestBase* _request, const std::string &data) noexcept;
+        llhttp_errno_t execute(RequestBase* _request, std::string_view view) noexcept;
+
+        /* Parse like `execute()`, additionally compacting chunked bodies inside
+         * `data`: chunk payloads are moved over the chunk framing so `body` ends
+         * up as one contiguous view without copying. Only a body which spans
+         * more than one call is copied, into the arena.
+         *
+         * Applies to settings which honour `in_place()`, like `DefaultSetting`,
+         * and to requests without a body sink.
+         */
+        llhttp_errno_t execute_in_place(RequestBase* _request, char *data, size_t len) noexcept;
+
+        /* Parse like `execute()`, trying the SIMD fast path of fast_path.hpp
+         * first when the parser is between messages. It fills `_request`
+         * directly, without callbacks, if `data` is exactly one complete
+         * request of the common shape; everything else goes to llhttp.
+         *
+         * The fast path stores what `DefaultSetting` would, so it is only
+         * taken by parsers with exactly that setting (`Parser()`,
+         * `BasicParser<DefaultSetting>`) and for requests without a body sink.
+         * Any other setting, a header filter or custom callbacks, always goes
+         * through llhttp. So does everything after a message which closes the
+         * connection, which llhttp rejects with `HPE_CLOSED_CONNECTION`
+         * unless lenient keep-alive is set.
+         */
+        llhttp_errno_t execute_fast(RequestBase* _request, const char *data, size_t len) noexcept;
+
+        /* Parse pipelined messages, filling one slot per message.
+         *
+         * Parsing stops when the data is exhausted, all slots are filled, or an
+         * error occurs. Bytes after the last filled slot are not consumed if the
+         * slots ran out, and should be passed again on the next call. A message
+         * which is still incomplete when the data runs out is left in
+         * `slots[completed]`; pass that slot first on the next call.
+         */
+        template<size_t N>
+        BatchResult execute_batch(BasicRequest<N>* slots, size_t count, const char *data, size_t len) noexcept
+        {
+            return __execute_batch(
+                reinterpret_cast<char*>(static_cast<RequestBase*>(slots)),
+                sizeof(BasicRequest<N>),
+                count,
+                data,
+                len
+            );
+        }
+
+        /* Makes `execute()` stop with `HPE_PAUSED` right after each complete
+         * message, as `execute_batch()` does internally. `get_error_pos()` then
+         * points at the first byte of the next message; call `resume()` before
+         * passing it.
          */
-        llhttp_errno_t execute(Request* _request, const char *data, size_t len) noexcept;
-        llhttp_errno_t execute(Request* _request, const std::string &data) noexcept;
-        llhttp_errno_t execute(Request* _request, std::string_view view) noexcept;
+        void pause_on_message_complete(bool enabled);
 
         llhttp_errno_t finish();
 
@@ -177,16 +362,53 @@ namespace llhttplus
 
         void *setting();
 
-        Request* request();
+        RequestBase* request();
 
         bool parse_done();
 
+        /* Returns the stitcher used by data callbacks to join spans which cross
+         * the boundary of two `execute()` calls.
+         */
+        Stitcher& stitcher();
+
+        /* Returns the number of values which had to be copied because they were
+         * split across `execute()` calls since the last `reset()`.
+         */
+        size_t stitch_count();
+
+        /* Returns the number of messages `execute_fast()` parsed without
+         * llhttp since the last `reset()`.
+         */
+        size_t fast_path_count();
+
+        /* Returns true while parsing a buffer passed to `execute_in_place()`. */
+        bool in_place();
+
+        /* Returns the arena all per-message allocations of this parser come from. */
+        Arena& arena();
+
     protected:
-        void __init(llhttp_settings_t*);
+        Parser(const llhttp_settings_t* low_layer_setting, void* setting, bool default_setting);
+
+        /* `default_setting` tells whether `setting` is a `DefaultSetting`. */
+        void __init(const llhttp_settings_t* low_layer_setting, void* setting, bool default_setting);
+
+        BatchResult __execute_batch(char* slots, size_t stride, size_t count, const char *data, size_t len) noexcept;
+
+        int __on_message_complete();
 
         llhttp_t _low_layer_parser;
-        Request* _request;
+        RequestBase* _request = nullptr;
         void *_setting;
+        Arena _arena;
+        Stitcher _stitcher{ &_arena };
+        bool _in_place = false;
+        bool _batch = false;
+        bool _batch_completed = false;  // a message completed since it was cleared
+        bool _pause_on_complete = false;
+        size_t _fast_path_count = 0;
+        bool _default_setting = false;  // callbacks are `DefaultSetting`'s, see `execute_fast()`
+        bool _closed = false;           // the last message was not keep-alive, llhttp takes no more
     };
 }
 
@@ -0,0 +1,149 @@
+#pragma once
+
+#ifndef _LLHTTP_METRICS_HPP_
+#define _LLHTTP_METRICS_HPP_
+#include "llhttp.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Parser counters, compiled in only with `LLHTTPLUS_METRICS` defined (CMake
+ * option of the same name); otherwise every `_LLHTTP_METRIC_*` macro expands
+ * to nothing and `metrics_snapshot()` returns zeros.
+ *
+ * `LLHTTPLUS_METRICS_TICKS` additionally measures the time spent in
+ * `execute()`, in TSC cycles on x86 and nanoseconds elsewhere.
+ */
+#if defined(LLHTTPLUS_METRICS)
+#define _LLHTTP_METRIC_ADD(field, n)    ::llhttplus::detail::__metric_add(::llhttplus::detail::__thread_metrics().field, n)
+#define _LLHTTP_METRIC_CALLBACK(name)   _LLHTTP_METRIC_ADD(callbacks[static_cast<size_t>(::llhttplus::Callback::name)], 1)
+#define _LLHTTP_METRIC_ERRNO(err)       ::llhttplus::detail::__metric_errno(err)
+#else
+#define _LLHTTP_METRIC_ADD(field, n)    ((void)0)
+#define _LLHTTP_METRIC_CALLBACK(name)   ((void)0)
+#define _LLHTTP_METRIC_ERRNO(err)       ((void)0)
+#endif
+
+#if defined(LLHTTPLUS_METRICS) && defined(LLHTTPLUS_METRICS_TICKS)
+#define _LLHTTP_METRIC_TICKS_BEGIN()    uint64_t __metric_ticks = ::llhttplus::detail::__ticks()
+#define _LLHTTP_METRIC_TICKS_END()      _LLHTTP_METRIC_ADD(execute_ticks, ::llhttplus::detail::__ticks() - __metric_ticks)
+#else
+#define _LLHTTP_METRIC_TICKS_BEGIN()    ((void)0)
+#define _LLHTTP_METRIC_TICKS_END()      ((void)0)
+#endif
+
+namespace llhttplus
+{
+    /* llhttp callbacks, named after the fields of `llhttp_settings_t`. */
+    enum class Callback : uint8_t
+    {
+        on_message_begin,
+        on_url,
+        on_status,
+        on_header_field,
+        on_header_value,
+        on_headers_complete,
+        on_body,
+        on_message_complete,
+        on_chunk_header,
+        on_chunk_complete,
+        on_url_complete,
+        on_status_complete,
+        on_header_field_complete,
+        on_header_value_complete,
+    };
+
+    inline constexpr size_t callback_count = static_cast<size_t>(Callback::on_header_value_complete) + 1;
+
+    inline constexpr size_t errno_count = HPE_USER + 1;
+
+    /* Counters summed over all threads, see `metrics_snapshot()`. */
+    struct MetricsSnapshot
+    {
+        uint64_t bytes;                         // bytes passed to execute()
+        uint64_t executes;                      // execute() calls, batches count once
+        uint64_t execute_ticks;                 // time in execute(), see LLHTTPLUS_METRICS_TICKS
+        uint64_t messages;                      // completed messages
+        uint64_t fast_path_messages;            // of which parsed by execute_fast()
+        uint64_t pauses;                        // HPE_PAUSED returned to the caller
+        uint64_t upgrades;                      // HPE_PAUSED_UPGRADE returned to the caller
+        uint64_t stitches;                      // values copied because they crossed calls
+        uint64_t callbacks[callback_count];     // by `Callback`
+        uint64_t errors[errno_count];           // other errors, by `llhttp_errno_t`
+    };
+
+    /* Returns true if the library was built with `LLHTTPLUS_METRICS`. */
+    constexpr bool metrics_enabled()
+    {
+#if defined(LLHTTPLUS_METRICS)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /* Sums the counters of all threads, including exited ones. Safe to call
+     * from any thread while others parse; each counter is read atomically,
+     * the snapshot as a whole is not.
+     */
+    MetricsSnapshot metrics_snapshot();
+
+    namespace detail
+    {
+        /*
+         * Counters of one thread. Only the owning thread writes them, with a
+         * relaxed load and store instead of a read-modify-write, which costs
+         * the same as a plain increment; the atomics only make concurrent
+         * reads by `metrics_snapshot()` well defined.
+         */
+        struct alignas(64) __ThreadMetrics
+        {
+            __ThreadMetrics();
+            ~__ThreadMetrics();
+
+            std::atomic<uint64_t> bytes{ 0 };
+            std::atomic<uint64_t> executes{ 0 };
+            std::atomic<uint64_t> execute_ticks{ 0 };
+            std::atomic<uint64_t> messages{ 0 };
+            std::atomic<uint64_t> fast_path_messages{ 0 };
+            std::atomic<uint64_t> pauses{ 0 };
+            std::atomic<uint64_t> upgrades{ 0 };
+            std::atomic<uint64_t> stitches{ 0 };
+            std::atomic<uint64_t> callbacks[callback_count] = {};
+            std::atomic<uint64_t> errors[errno_count] = {};
+        };
+
+        inline __ThreadMetrics& __thread_metrics()
+        {
+            thread_local __ThreadMetrics metrics;
+            return metrics;
+        }
+
+        inline void __metric_add(std::atomic<uint64_t>& counter, uint64_t n)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        inline void __metric_errno(llhttp_errno_t err)
+        {
+            auto& metrics = __thread_metrics();
+            if (err == HPE_PAUSED)
+            {
+                __metric_add(metrics.pauses, 1);
+            }
+            else if (err == HPE_PAUSED_UPGRADE)
+            {
+                __metric_add(metrics.upgrades, 1);
+            }
+            else if (err != HPE_OK && static_cast<size_t>(err) < errno_count)
+            {
+                __metric_add(metrics.errors[err], 1);
+            }
+        }
+
+        uint64_t __ticks();
+    }
+}
+
+#endif
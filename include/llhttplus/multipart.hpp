@@ -0,0 +1,183 @@
+#pragma once
+
+#ifndef _LLHTTP_MULTIPART_HPP_
+#define _LLHTTP_MULTIPART_HPP_
+#include "basic_parser.hpp"
+#include "body_sink.hpp"
+#include "default_setting.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace llhttplus
+{
+    /* Returns the `boundary` parameter of a `multipart/...` content type,
+     * without quotes, or an empty view.
+     */
+    std::string_view multipart_boundary(std::string_view content_type);
+
+    enum class MultipartError : uint8_t
+    {
+        none,
+        boundary,       // missing or invalid boundary
+        framing,        // neither `--` nor a line break after a delimiter
+        head,           // part headers llhttp rejects; see `head_error()`
+        head_too_large, // part headers longer than `max_head`
+        truncated,      // the message ended before the close delimiter
+        handler,        // a `part_*()` hook returned non-zero
+    };
+
+    namespace detail
+    {
+        /* Part headers go through llhttp as the head of a request without a body. */
+        class __PartSetting : public DefaultSetting
+        {
+        public:
+            int _on_message_begin(Parser* p)
+            {
+                return DefaultSetting::_on_message_begin(p);
+            }
+
+            int _on_header_field(Parser* p, const char* at, size_t length)
+            {
+                return DefaultSetting::_on_header_field(p, at, length);
+            }
+
+            int _on_header_value(Parser* p, const char* at, size_t length)
+            {
+                return DefaultSetting::_on_header_value(p, at, length);
+            }
+
+            int _on_header_field_complete(Parser* p)
+            {
+                return DefaultSetting::_on_header_field_complete(p);
+            }
+
+            int _on_header_value_complete(Parser* p)
+            {
+                return DefaultSetting::_on_header_value_complete(p);
+            }
+
+            /* The head ends the part as far as llhttp is concerned: whatever
+             * `Content-Length`, `Transfer-Encoding` or `Upgrade` say, it must
+             * not take the payload for an HTTP body. Skipping the body
+             * completes the message right here, which pauses the parser on
+             * the first payload byte.
+             */
+            int _on_headers_complete(Parser* p)
+            {
+                return 1;
+            }
+
+            int _on_message_complete(Parser* p)
+            {
+                return DefaultSetting::_on_message_complete(p);
+            }
+        };
+    }
+
+    /*
+     * Streams a `multipart/form-data` (or any `multipart/...`) body part by
+     * part, as a `BodySink`. Derive from it and implement the `part_*()`
+     * hooks, then set it as the `body_sink` of the request.
+     *
+     * The boundary is searched in every span as it arrives, also across the
+     * edges of spans, and payload is handed to `part_data()` as views into
+     * the input: nothing is buffered, and memory stays constant however large
+     * the upload. The only bytes not delivered in place are up to one
+     * delimiter's worth at the end of a span which might start a boundary;
+     * they are passed from the sink's own copy of the delimiter once the
+     * next span rules it out.
+     *
+     * Part headers are parsed by llhttp with `DefaultSetting` into a
+     * `RequestBase`, so `get(KnownHeader::ContentDisposition)` and friends
+     * work; only its headers are filled. They are copied into an arena
+     * which is rewound for each part, and stay valid until the part ends.
+     *
+     * Any error stops parsing with `HPE_USER`; `error()` tells why.
+     */
+    class MultipartSink : public BodySink
+    {
+    public:
+        static constexpr size_t max_boundary = 70;     // RFC 2046
+
+        explicit MultipartSink(size_t max_head = 16384);
+
+        /* Prepares for the next body. An empty `boundary` is taken from the
+         * Content-Type of the request once its body starts, which is also
+         * what happens after `finish()`.
+         */
+        void reset(std::string_view boundary = std::string_view());
+
+        int write(const RequestBase& request, const char* at, size_t length) override;
+
+        int finish(const RequestBase& request) override;
+
+        /* Called once the headers of a part are parsed. */
+        virtual int part_begin(const RequestBase& part)
+        {
+            return 0;
+        }
+
+        /* Called for each piece of the payload of `part`; the piece is only
+         * valid during the call.
+         */
+        virtual int part_data(const RequestBase& part, const char* at, size_t length) = 0;
+
+        /* Called when the delimiter after the payload of `part` is found. */
+        virtual int part_end(const RequestBase& part)
+        {
+            return 0;
+        }
+
+        /* Returns the number of parts begun since `reset()`. */
+        size_t parts() const;
+
+        MultipartError error() const;
+
+        /* Returns the llhttp error of the part headers if `error()` is `head`. */
+        llhttp_errno_t head_error() const;
+
+    private:
+        enum class State : uint8_t
+        {
+            start,      // boundary not known yet
+            preamble,
+            delimiter,  // after a delimiter: `--` or padding and CRLF
+            head,
+            data,
+            epilogue,
+            failed,
+        };
+
+        bool __set_boundary(std::string_view boundary);
+
+        int __fail(MultipartError error);
+
+        int __scan(const char*& p, const char* end);
+
+        int __delimiter_found();
+
+        int __after_delimiter(const char*& p, const char* end);
+
+        int __head(const char*& p, const char* end);
+
+        int __data(const char* at, size_t length);
+
+        BasicParser<detail::__PartSetting>  _parser;
+        BasicRequest<8>                     _part;
+        size_t                              _max_head;
+        size_t                              _head_size = 0;
+        size_t                              _parts = 0;
+        size_t                              _matched = 0;   // delimiter bytes held back from the last span
+        size_t                              _length = 0;    // of `_delimiter`
+        State                               _state = State::start;
+        uint8_t                             _after = 0;     // progress through what follows a delimiter
+        MultipartError                      _error = MultipartError::none;
+        llhttp_errno_t                      _head_error = HPE_OK;
+        char                                _delimiter[max_boundary + 4];  // CRLF "--" boundary
+        uint8_t                             _shift[256];    // Horspool bad character shifts
+    };
+}
+
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+
+#ifndef _LLHTTP_PARSER_GROUP_HPP_
+#define _LLHTTP_PARSER_GROUP_HPP_
+#include "llhttplus.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace llhttplus
+{
+    /* Input of one `Parser::execute()` call in a batch, and its result. */
+    struct ParseJob
+    {
+        Parser*         parser;
+        RequestBase*    request;            // null if the setting fills its own, as `CompactSetting`
+        const char*     data;
+        size_t          length;
+        llhttp_errno_t  error = HPE_OK;     // returned by `execute()`
+        bool            completed = false;  // at least one message was completed
+    };
+
+    /*
+     * Parses the input of many connections in one pass, e.g. everything one
+     * `epoll_wait()` returned.
+     *
+     * Calling `execute()` connection after connection stalls on every cold
+     * parser, request and buffer. `execute_many()` prefetches in two stages
+     * ahead of the job being parsed: the parser, the request and the first
+     * lines of the data `2 * distance` jobs ahead, then what those point to
+     * (the settings and the header storage) `distance` jobs ahead, once the
+     * pointers themselves are cached. Results are grouped afterwards: the
+     * jobs which completed a message and those which failed are listed in
+     * order, so they can be handled in a second pass over hot requests.
+     */
+    class ParserGroup
+    {
+    public:
+        explicit ParserGroup(size_t distance = 4);
+
+        /* Runs `execute()` for every job. Each parser must appear once. */
+        void execute_many(ParseJob* jobs, size_t count);
+
+        void execute_many(std::vector<ParseJob>& jobs)
+        {
+            execute_many(jobs.data(), jobs.size());
+        }
+
+        /* Returns the indices of the jobs of the last batch which completed
+         * a message and did not fail.
+         */
+        const std::vector<uint32_t>& completed() const;
+
+        /* Returns the indices of the jobs of the last batch which stopped on
+         * an error other than a pause.
+         */
+        const std::vector<uint32_t>& failed() const;
+
+    private:
+        size_t                  _distance;
+        std::vector<uint32_t>   _completed;
+        std::vector<uint32_t>   _failed;
+    };
+}
+
+#endif
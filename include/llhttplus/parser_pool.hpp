@@ -0,0 +1,92 @@
+#pragma once
+
+#ifndef _LLHTTP_PARSER_POOL_HPP_
+#define _LLHTTP_PARSER_POOL_HPP_
+#include "llhttplus.hpp"
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace llhttplus
+{
+    /*
+     * Parser and request handed out by a `ParserPool`. Each pair starts on a
+     * cache line of its own and shares no line with its neighbours, so pairs
+     * used by different threads do not falsely share.
+     */
+    struct alignas(64) PooledParser
+    {
+        Parser      parser;
+        Request     request;
+    };
+
+    /*
+     * Free list of initialized parser and request pairs, so that accepting a
+     * connection neither allocates nor calls `llhttp_init()`.
+     *
+     * A pool belongs to the thread which created it; create one per thread.
+     * Only that thread may `acquire()`, and pairs it releases go back to its
+     * free list without synchronization. Other threads may `release()` too:
+     * their pairs are pushed on a lock-free return list, which the owner
+     * takes over in one exchange when its own list runs empty.
+     *
+     * Released pairs are recycled with `Parser::reset()` and
+     * `RequestBase::clear()`, keeping the grown arena and header capacity,
+     * and lose their lenient flags, pause mode and body sink. Pairs are
+     * allocated in blocks and freed with the pool, which must outlive them.
+     */
+    class ParserPool
+    {
+    public:
+        /* Pool of parsers using `DefaultSetting`, as `Parser()` does. */
+        explicit ParserPool(size_t reserve = 0);
+
+        template<class Setting>
+        explicit ParserPool(ParserSetting<Setting>* setting, size_t reserve = 0)
+            : ParserPool(&setting->low_layer_setting(), setting, detail::__is_default_setting<Setting>, reserve)
+        {
+        }
+
+        ParserPool(const ParserPool&) = delete;
+        ParserPool& operator=(const ParserPool&) = delete;
+        ~ParserPool();
+
+        /* Returns a reset pair. Owner thread only. */
+        PooledParser* acquire();
+
+        /* Recycles `pooled`, which this pool handed out. Any thread. */
+        void release(PooledParser* pooled) noexcept;
+
+        /* Constructs pairs until the pool holds at least `count`. Owner
+         * thread only.
+         */
+        void reserve(size_t count);
+
+        /* Returns the number of pairs constructed, in use or free. */
+        size_t size() const;
+
+    private:
+        struct Slot;
+
+        static constexpr size_t __block_slots = 16;
+
+        ParserPool(const llhttp_settings_t* low_layer_setting, void* setting, bool default_setting, size_t reserve);
+
+        void __grow(size_t count);
+
+        void __recycle(Slot* slot) noexcept;
+
+        const llhttp_settings_t*                    _low_layer_setting;
+        void*                                       _setting;
+        bool                                        _default_setting;
+        std::thread::id                             _owner;
+        Slot*                                       _free = nullptr;
+        std::vector<std::pair<Slot*, size_t>>       _blocks;
+        size_t                                      _size = 0;
+        alignas(64) std::atomic<Slot*>              _returned{ nullptr };  // released by other threads
+    };
+}
+
+#endif
@@ -0,0 +1,77 @@
+#pragma once
+
+#ifndef _LLHTTP_RESPONSE_HEADERS_HPP_
+#define _LLHTTP_RESPONSE_HEADERS_HPP_
+#include "headers.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+
+namespace llhttplus
+{
+    /*
+     * One or more preformatted header lines, each ending in CRLF, in storage
+     * which lives as long as the process. `ResponseWriter::header()` splices
+     * a block in as a single reference instead of formatting it.
+     */
+    class HeaderBlock
+    {
+    public:
+        constexpr HeaderBlock() = default;
+
+        /* `lines` must be static storage, e.g. a literal. */
+        constexpr explicit HeaderBlock(std::string_view lines)
+            : _lines(lines)
+        {
+        }
+
+        constexpr std::string_view lines() const
+        {
+            return _lines;
+        }
+
+    private:
+        std::string_view _lines;
+    };
+
+    namespace header_blocks
+    {
+        inline constexpr HeaderBlock connection_keep_alive{ "Connection: keep-alive\r\n" };
+        inline constexpr HeaderBlock connection_close{ "Connection: close\r\n" };
+        inline constexpr HeaderBlock content_type_text{ "Content-Type: text/plain; charset=utf-8\r\n" };
+        inline constexpr HeaderBlock content_type_html{ "Content-Type: text/html; charset=utf-8\r\n" };
+        inline constexpr HeaderBlock content_type_css{ "Content-Type: text/css; charset=utf-8\r\n" };
+        inline constexpr HeaderBlock content_type_javascript{ "Content-Type: text/javascript; charset=utf-8\r\n" };
+        inline constexpr HeaderBlock content_type_json{ "Content-Type: application/json\r\n" };
+        inline constexpr HeaderBlock content_type_octet_stream{ "Content-Type: application/octet-stream\r\n" };
+    }
+
+    /* Formats `headers` into one block, e.g. `{ { "Server", "example/1.0" } }`
+     * at startup. The storage is never released, so register each block
+     * once rather than per response.
+     */
+    HeaderBlock register_header_block(std::initializer_list<Header> headers);
+
+    /* Length of an IMF-fixdate, "Sun, 06 Nov 1994 08:49:37 GMT". */
+    inline constexpr size_t http_date_length = 29;
+
+    /* Writes the IMF-fixdate (RFC 9110) of `seconds` since the epoch to
+     * `out`, which must hold `http_date_length` characters.
+     */
+    void format_http_date(char* out, int64_t seconds);
+
+    /* Returns the current date as IMF-fixdate. It is cached per thread and
+     * formatted at most once per second, using a coarse clock where
+     * available. The view is valid until the next call on this thread.
+     */
+    std::string_view http_date();
+
+    namespace detail
+    {
+        /* Returns "Date: <http_date()>\r\n" from the same cache. */
+        std::string_view __date_header_line();
+    }
+}
+
+#endif
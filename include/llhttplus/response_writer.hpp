@@ -0,0 +1,121 @@
+#pragma once
+
+#ifndef _LLHTTP_RESPONSE_WRITER_HPP_
+#define _LLHTTP_RESPONSE_WRITER_HPP_
+#include "response_headers.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/uio.h>
+
+namespace llhttplus
+{
+    /*
+     * Serializes a response as an iovec array for `writev()`/`sendmsg()`.
+     *
+     * The status line, headers and chunk framing are formatted into a buffer
+     * owned by the writer, which keeps its capacity across responses. Bodies
+     * are referenced, not copied, so they have to stay alive until written.
+     *
+     *     writer.status(200);
+     *     writer.header("Content-Type", "text/plain");
+     *     writer.body(data, size);
+     *     ::writev(fd, writer.data(), writer.size());
+     *
+     * A chunked response starts with `begin_chunked()`; each `chunk()` adds
+     * one chunk with its framing, and `end_chunked()` the last chunk. Output
+     * may be written and `consume()`d between chunks.
+     */
+    class ResponseWriter
+    {
+    public:
+        explicit ResponseWriter(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        ResponseWriter(const ResponseWriter&) = delete;
+        ResponseWriter& operator=(const ResponseWriter&) = delete;
+
+        /* Starts an HTTP/1.1 response. Common codes use a preformatted status
+         * line unless `reason` is given; without a known reason, the reason
+         * phrase is empty.
+         */
+        void status(int code, std::string_view reason = std::string_view());
+
+        void header(std::string_view name, std::string_view value);
+
+        void header(std::string_view name, uint64_t value);
+
+        /* References a preformatted block as one iovec entry, see
+         * response_headers.hpp.
+         */
+        void header(const HeaderBlock& block);
+
+        /* Adds the `Date` header from the per-second cache of `http_date()`. */
+        void date();
+
+        /* Ends the header section without adding framing headers, e.g. for a
+         * response to HEAD or a 204.
+         */
+        void end_headers();
+
+        /* Adds `Content-Length`, ends the headers and references the body. */
+        void body(const void* data, size_t length);
+
+        /* Same for a body made of several buffers. */
+        void body(const iovec* parts, size_t count);
+
+        /* Like `body()`, but copies the body into the writer's buffer, for
+         * small bodies which do not outlive the call.
+         */
+        void copy_body(const void* data, size_t length);
+
+        /* Adds `Transfer-Encoding: chunked` and ends the headers. */
+        void begin_chunked();
+
+        /* Adds one chunk referencing `data`; empty chunks are skipped as they
+         * would end the body.
+         */
+        void chunk(const void* data, size_t length);
+
+        /* Adds the last chunk, with optional trailer lines ending in CRLF. */
+        void end_chunked(std::string_view trailers = std::string_view());
+
+        const iovec* data() const;
+
+        /* Returns the number of iovec entries. */
+        size_t size() const;
+
+        /* Returns the number of bytes still to be written. */
+        size_t bytes() const;
+
+        /* Marks `written` bytes as sent, e.g. after a partial `writev()`. Once
+         * everything is sent, the buffer is reused.
+         */
+        void consume(size_t written);
+
+        /* Drops all output and starts over with a new response. */
+        void clear();
+
+    private:
+        void __append(const char* data, size_t length);
+
+        void __append(std::string_view text)
+        {
+            __append(text.data(), text.size());
+        }
+
+        void __reference(const void* data, size_t length);
+
+        std::pmr::vector<char>  _buffer;
+        std::pmr::vector<iovec> _iov;
+        size_t                  _first = 0;     // first entry not written yet
+        size_t                  _bytes = 0;
+        bool                    _tail = false;  // last entry ends at the end of `_buffer`
+    };
+}
+#endif
+
+#endif
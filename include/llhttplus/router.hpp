@@ -0,0 +1,137 @@
+#pragma once
+
+#ifndef _LLHTTP_ROUTER_HPP_
+#define _LLHTTP_ROUTER_HPP_
+#include "llhttplus.hpp"
+#include "compact_request.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace llhttplus
+{
+    /* Most `:param` and `*wildcard` captures a route may have. */
+    constexpr size_t max_route_params = 8;
+
+    struct RouteParam
+    {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    /* Result of `Router::match()`; captures point into the URL. */
+    struct RouteMatch
+    {
+        int         route = -1;     // id returned by `Router::add()`, or -1
+        size_t      size = 0;       // number of captures
+        RouteParam  params[max_route_params];
+
+        explicit operator bool() const
+        {
+            return route >= 0;
+        }
+
+        /* Returns the capture named `name`, or an empty view. */
+        std::string_view get(std::string_view name) const;
+    };
+
+    /*
+     * Maps method and path to a route.
+     *
+     *     router.add(HTTP_GET, "/users/:id/posts/:post");
+     *     router.compile();
+     *     if (auto match = router.match(request))
+     *     {
+     *         handlers[match.route](request, match.get("id"));
+     *     }
+     *
+     * Patterns are paths whose segments may be a `:name` capture, which
+     * matches one non-empty segment, or end with a `*name` wildcard, which
+     * matches the rest of the path, even nothing. Static text wins over a
+     * capture, which wins over a wildcard; a match backtracks if the more
+     * specific branch fails further down.
+     *
+     * `compile()` turns the routes of each method into a radix tree laid out
+     * as one array of nodes, children next to each other and found by binary
+     * search on their first byte. Matching walks it against the path of the
+     * URL (query and fragment are ignored, nothing is decoded) without
+     * allocating.
+     */
+    class Router
+    {
+    public:
+        Router();
+        ~Router();
+
+        Router(const Router&) = delete;
+        Router& operator=(const Router&) = delete;
+
+        /* Adds a route and returns its id: the number of routes added before.
+         * Returns -1 if the pattern is malformed, has too many captures, or
+         * conflicts with a route added before, i.e. matches the same paths
+         * or names a capture differently. Call `compile()` afterwards.
+         */
+        int add(llhttp_method_t method, std::string_view pattern);
+
+        /* Builds the tables `match()` uses from the routes added so far. */
+        void compile();
+
+        /* Returns the route of `method` matching the path of `url`. */
+        RouteMatch match(llhttp_method_t method, std::string_view url) const;
+
+        RouteMatch match(const RequestBase& request) const
+        {
+            return match(request.method, request.url);
+        }
+
+        RouteMatch match(const CompactRequest& request) const
+        {
+            return match(request.method, request.view(request.url));
+        }
+
+        /* Returns the number of routes added. */
+        size_t size() const;
+
+    private:
+        struct BuildNode;
+
+        enum class Kind : uint8_t
+        {
+            text,
+            param,
+            wildcard,
+        };
+
+        struct Node
+        {
+            uint32_t    label;          // offset in `_labels` of the text, or the capture name
+            uint16_t    label_length;
+            uint16_t    children;       // number of text children
+            uint32_t    first_child;
+            int32_t     param;          // node of the `:name` child, or -1
+            int32_t     wildcard;       // node of the `*name` child, or -1
+            int32_t     route;
+            Kind        kind;
+        };
+
+        static constexpr size_t __method_count = 64;
+
+        bool __insert(BuildNode* node, std::string_view pattern, int route);
+
+        void __flatten(const BuildNode& node, uint32_t index);
+
+        bool __match(uint32_t index, const char* p, const char* end, RouteMatch* match) const;
+
+        std::unique_ptr<BuildNode>  _trees[__method_count];
+        size_t                      _routes = 0;
+        int32_t                     _roots[__method_count];
+        std::vector<Node>           _nodes;
+        std::vector<char>           _keys;      // first byte of each text node
+        std::string                 _labels;
+    };
+}
+
+#endif
@@ -0,0 +1,126 @@
+#pragma once
+
+#ifndef _LLHTTP_SERVER_HPP_
+#define _LLHTTP_SERVER_HPP_
+#include "connection.hpp"
+#include "response_writer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+
+namespace llhttplus
+{
+    struct ServerOptions
+    {
+        /* IPv4 or IPv6 literal to listen on. */
+        std::string address = "0.0.0.0";
+
+        /* 0 picks a free port, see `Server::port()`. */
+        uint16_t    port = 8080;
+
+        /* Number of event loops; 0 starts one per hardware thread. */
+        size_t      threads = 0;
+
+        int         backlog = 1024;
+
+        /* Pins loop `i` to CPU `i % CPUs`. */
+        bool        pin_threads = false;
+
+        /* See `Connection`. */
+        size_t      receive_capacity = 16 * 1024;
+        size_t      max_request_size = 1024 * 1024;
+        size_t      max_pipelined = 16;
+
+        /* A connection stops handling pipelined requests while this many
+         * response bytes are waiting for the socket.
+         */
+        size_t      max_pending_output = 256 * 1024;
+
+        /* Uses the io_uring backend if the library was built with
+         * LLHTTPLUS_IO_URING and the kernel supports it (6.0 or later), and
+         * epoll otherwise. Other io_uring setup errors make `start()` fail.
+         */
+        bool        io_uring = true;
+
+        /* io_uring: number (a power of two, at most 32768) and size of the
+         * receive buffers each loop provides to the kernel. `start()` returns
+         * EINVAL if they are out of range while `io_uring` is set.
+         */
+        size_t      io_uring_buffers = 1024;
+        size_t      io_uring_buffer_size = 4096;
+    };
+
+    /*
+     * Answers one request. Called on the event loop of the connection, i.e.
+     * concurrently from all loops, and must not block; the response is
+     * written once the handler returns. `request` is only valid during the
+     * call: bodies referenced by the writer must not point into it, use
+     * `copy_body()` for those.
+     */
+    using Handler = std::function<void(const CompactRequest& request, ResponseWriter& response)>;
+
+    namespace detail
+    {
+        class __ServerLoop;
+    }
+
+    /*
+     * Shared-nothing multi-core HTTP/1.1 server.
+     *
+     * Every event loop runs on its own thread with its own epoll instance and
+     * its own listening socket bound with `SO_REUSEPORT`, so the kernel
+     * spreads new connections over the loops and nothing is shared between
+     * them after `start()`. Each loop keeps a pool of connections, each with
+     * its `Connection` (receive buffer and parser) and `ResponseWriter`,
+     * which are reused for the next peer instead of being freed.
+     *
+     * With epoll, sockets are edge-triggered: a readable connection is read
+     * until the kernel has nothing left, parsed in place, and the responses
+     * of all requests parsed so far are sent with one `sendmsg()` (a
+     * `writev()` which does not raise SIGPIPE). The io_uring backend, see
+     * server_uring.cpp, replaces these system calls with multishot accept and
+     * receive and parses the buffers the kernel received into.
+     */
+    class Server
+    {
+    public:
+        Server(ServerOptions options, Handler handler);
+
+        ~Server();
+
+        Server(const Server&) = delete;
+        Server& operator=(const Server&) = delete;
+
+        /* Binds the listening sockets and starts the loops. Returns 0, or the
+         * errno of the first failure, in which case nothing is started.
+         */
+        int start();
+
+        /* Stops the loops, closes all connections and joins the threads. */
+        void stop();
+
+        /* Returns the bound port once started. */
+        uint16_t port() const;
+
+        /* Returns the number of event loops once started. */
+        size_t threads() const;
+
+        /* Returns "epoll" or "io_uring" once started. */
+        const char* backend() const;
+
+    private:
+        ServerOptions                                       _options;
+        Handler                                             _handler;
+        std::vector<std::unique_ptr<detail::__ServerLoop>>  _loops;
+        uint16_t                                            _port = 0;
+    };
+}
+
+#endif
+
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+
+#ifndef _LLHTTP_SERVER_LOOP_HPP_
+#define _LLHTTP_SERVER_LOOP_HPP_
+#include "server.hpp"
+#include <memory>
+#include <thread>
+
+#if defined(__linux__)
+
+namespace llhttplus
+{
+    namespace detail
+    {
+        /*
+         * Event loop of a `Server`, implemented by each I/O backend. A loop
+         * runs on its own thread and owns its listening socket once `open()`
+         * succeeded. Subclasses call `stop()` in their destructor.
+         */
+        class __ServerLoop
+        {
+        public:
+            __ServerLoop(const ServerOptions& options, const Handler& handler);
+
+            virtual ~__ServerLoop();
+
+            __ServerLoop(const __ServerLoop&) = delete;
+            __ServerLoop& operator=(const __ServerLoop&) = delete;
+
+            /* Sets the backend up and takes `listen_fd`. Returns 0 or errno; on
+             * failure the socket is left to the caller, e.g. for another
+             * backend.
+             */
+            virtual int open(int listen_fd) = 0;
+
+            virtual const char* backend() const = 0;
+
+            /* Runs the loop on a new thread, pinned to `cpu` unless negative. */
+            void start(int cpu);
+
+            /* Wakes the loop up, which closes its connections, and joins it. */
+            void stop();
+
+        protected:
+            virtual void __run() = 0;
+
+            /* Makes `__run()` return; called from another thread. */
+            virtual void __wake() = 0;
+
+            /* Answers the requests parsed from `connection` until `writer`
+             * holds `max_pending_output` bytes. Returns the number of
+             * responses added; sets `*closing` once the connection has to be
+             * closed after the output is written.
+             */
+            size_t __handle(Connection& connection, ResponseWriter& writer, bool* closing);
+
+            /* Adds an error response which closes the connection. */
+            void __reject(ResponseWriter& writer, int code);
+
+            const ServerOptions&    _options;
+            const Handler&          _handler;
+            int                     _listen_fd = -1;
+            std::thread             _thread;
+        };
+
+        /* Returns EINVAL if the io_uring options are out of range, else 0.
+         * Checked whether the backend is built or not, so options which work
+         * on one machine do not fail on another.
+         */
+        int __check_uring_options(const ServerOptions& options);
+
+        std::unique_ptr<__ServerLoop> __make_epoll_loop(const ServerOptions& options, const Handler& handler);
+
+#if defined(LLHTTPLUS_IO_URING)
+        std::unique_ptr<__ServerLoop> __make_uring_loop(const ServerOptions& options, const Handler& handler);
+#endif
+    }
+}
+
+#endif
+
+#endif
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "llhttp.h"
+#include "llhttplus.hpp"
+#include "metrics.hpp"
 
 /**
  * To use this Class, You should inherit server::http::Parser(CRTP template class).
@@ -59,16 +61,45 @@
     auto *self = (ParserSetting *)parser->setting();\
 
 #define STATIC_CB_DEFINE(name)                      \
+    _LLHTTP_METRIC_CALLBACK(name);                  \
     GET_CONTEXT                                     \
     INVOKE_CB(name);
 
 #define STATIC_DATA_CB_DEFINE(name)                 \
+    _LLHTTP_METRIC_CALLBACK(name);                  \
     GET_CONTEXT                                     \
     INVOKE_DATA_CB(name);
 
-namespace llhttp
+namespace llhttplus
 {
-    class Parser;
+    namespace detail
+    {
+        _HAS_MEMBER_FUNCTION(_on_url,                   Parser*, const char*, size_t)
+        _HAS_MEMBER_FUNCTION(_on_status,                Parser*, const char*, size_t)
+        _HAS_MEMBER_FUNCTION(_on_header_field,          Parser*, const char*, size_t)
+        _HAS_MEMBER_FUNCTION(_on_header_value,          Parser*, const char*, size_t)
+        _HAS_MEMBER_FUNCTION(_on_body,                  Parser*, const char*, size_t)
+        _HAS_MEMBER_FUNCTION(_on_message_begin,         Parser*)
+        _HAS_MEMBER_FUNCTION(_on_headers_complete,      Parser*)
+        _HAS_MEMBER_FUNCTION(_on_message_complete,      Parser*)
+        _HAS_MEMBER_FUNCTION(_on_chunk_header,          Parser*)
+        _HAS_MEMBER_FUNCTION(_on_chunk_complete,        Parser*)
+        _HAS_MEMBER_FUNCTION(_on_url_complete,          Parser*)
+        _HAS_MEMBER_FUNCTION(_on_status_complete,       Parser*)
+        _HAS_MEMBER_FUNCTION(_on_header_field_complete, Parser*)
+        _HAS_MEMBER_FUNCTION(_on_header_value_complete, Parser*)
+
+        /* True if `T` implements at least one of the callbacks above. */
+        template <class T>
+        constexpr bool implements_any =
+            has__on_url<T>::value || has__on_status<T>::value
+            || has__on_header_field<T>::value || has__on_header_value<T>::value
+            || has__on_body<T>::value || has__on_message_begin<T>::value
+            || has__on_headers_complete<T>::value || has__on_message_complete<T>::value
+            || has__on_chunk_header<T>::value || has__on_chunk_complete<T>::value
+            || has__on_url_complete<T>::value || has__on_status_complete<T>::value
+            || has__on_header_field_complete<T>::value || has__on_header_value_complete<T>::value;
+    }
 
     template <class SubClass>
     class ParserSetting
@@ -119,7 +150,15 @@ namespace llhttp
         /* Possible return values 0, -1, `HPE_PAUSED` */
         int on_message_complete(Parser* p)
         {
-            return static_cast<SubClass *>(this)->_on_message_complete(p); 
+            if constexpr (detail::has__on_message_complete<SubClass>::value)
+            {
+                int ret = static_cast<SubClass *>(this)->_on_message_complete(p);
+                if (ret != 0)
+                {
+                    return ret;
+                }
+            }
+            return p->__on_message_complete();
         }
 
         /*
@@ -160,11 +199,6 @@ namespace llhttp
         }
 
     private:
-        _HAS_MEMBER_FUNCTION(_on_url,           Parser *, const char*, size_t)
-        _HAS_MEMBER_FUNCTION(_on_status,        Parser*, const char*, size_t)
-        _HAS_MEMBER_FUNCTION(_on_header_field,  Parser*, const char*, size_t)
-        _HAS_MEMBER_FUNCTION(_on_header_value,  Parser*, const char*, size_t)
-        _HAS_MEMBER_FUNCTION(_on_body,          Parser*, const char*, size_t)
 
         static int __on_url(llhttp_t *lparser, const char *at, size_t length)
         {
@@ -191,15 +225,6 @@ namespace llhttp
             STATIC_DATA_CB_DEFINE(on_body)
         }
 
-        _HAS_MEMBER_FUNCTION(_on_message_begin,         Parser*)
-        _HAS_MEMBER_FUNCTION(_on_headers_complete,      Parser*)
-        _HAS_MEMBER_FUNCTION(_on_message_complete,      Parser*)
-        _HAS_MEMBER_FUNCTION(_on_chunk_header,          Parser*)
-        _HAS_MEMBER_FUNCTION(_on_chunk_complete,        Parser*)
-        _HAS_MEMBER_FUNCTION(_on_url_complete,          Parser*)
-        _HAS_MEMBER_FUNCTION(_on_status_complete,       Parser*)
-        _HAS_MEMBER_FUNCTION(_on_header_field_complete, Parser*)
-        _HAS_MEMBER_FUNCTION(_on_header_value_complete, Parser*)
 
         static int __on_message_begin(llhttp_t *lparser)
         {
@@ -260,7 +285,7 @@ namespace llhttp
         }
 
 #define _BIND_CB(name)                          \
-    if constexpr (has__##name<SubClass>::value) \
+    if constexpr (detail::has__##name<SubClass>::value) \
     _low_layer_setting.name = ParserSetting::__##name
 
         void __bind_low_layer_setting()
@@ -272,7 +297,8 @@ namespace llhttp
             _BIND_CB(on_header_value);
             _BIND_CB(on_headers_complete);
             _BIND_CB(on_body);
-            _BIND_CB(on_message_complete);
+            /* Always bound, the parser needs it to split batches. */
+            _low_layer_setting.on_message_complete = ParserSetting::__on_message_complete;
             _BIND_CB(on_chunk_header);
             _BIND_CB(on_chunk_complete);
             _BIND_CB(on_url_complete);
@@ -0,0 +1,65 @@
+#pragma once
+
+#ifndef _LLHTTP_STITCH_HPP_
+#define _LLHTTP_STITCH_HPP_
+#include "arena.hpp"
+#include <string_view>
+
+namespace llhttplus
+{
+    /*
+     * Joins data spans (url, status, header field/value) that llhttp reports in
+     * several pieces because they cross the boundary of two `execute()` buffers.
+     *
+     * A span that starts and ends inside one buffer is left as a zero-copy view
+     * into the caller's data. Only when a span is still open at the end of
+     * `execute()` its bytes are copied into the parser's arena, so the caller
+     * may reuse its buffer before the rest of the value arrives.
+     *
+     * Views that point into the arena stay valid until the arena is reset.
+     */
+    class Stitcher
+    {
+    public:
+        explicit Stitcher(Arena* arena);
+
+        /* Feeds one piece of the span which `target` refers to. */
+        void append(std::string_view* target, const char* at, size_t length);
+
+        /* Like `append()`, for spans whose pieces are not adjacent within one
+         * buffer, such as chunked body payloads. A piece that does not follow
+         * the previous one is moved right behind it, so `at` must point into a
+         * mutable buffer that also holds the previous pieces.
+         */
+        void append_in_place(std::string_view* target, char* at, size_t length);
+
+        /* Returns true if `target` is the span which is currently being fed. */
+        bool is_open(const std::string_view* target) const;
+
+        /* Marks the current span as complete. */
+        void close();
+
+        /* Called once the input buffer is exhausted. If a span is still open,
+         * its bytes are copied into the arena and `target` is re-pointed.
+         */
+        void detach();
+
+        /* Drops the open span and resets the counter. */
+        void clear();
+
+        /* Returns the number of spans which had to be copied since `clear()`. */
+        size_t count() const;
+
+    private:
+        void __reserve(size_t capacity);
+
+        Arena*            _arena;
+        std::string_view* _target = nullptr;
+        char*             _pending = nullptr;
+        size_t            _size = 0;
+        size_t            _capacity = 0;
+        size_t            _count = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,263 @@
+#pragma once
+
+#ifndef _LLHTTP_TIMER_WHEEL_HPP_
+#define _LLHTTP_TIMER_WHEEL_HPP_
+#include "setting.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace llhttplus
+{
+    class TimerWheel;
+
+    /*
+     * Timer linked into a `TimerWheel`. Arming, re-arming and cancelling
+     * unlink and link the timer itself, so they take O(1) and never allocate.
+     * The timer cancels itself when destroyed.
+     */
+    class Timer
+    {
+    public:
+        Timer() = default;
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        ~Timer()
+        {
+            cancel();
+        }
+
+        bool armed() const
+        {
+            return _wheel != nullptr;
+        }
+
+        /* Unlinks the timer if it is armed. */
+        void cancel();
+
+        void*   data = nullptr;     // free for the owner, e.g. the connection
+
+    private:
+        friend class TimerWheel;
+
+        TimerWheel* _wheel = nullptr;
+        Timer*      _prev = nullptr;
+        Timer*      _next = nullptr;
+        uint64_t    _expires = 0;   // tick
+        uint16_t    _slot = 0;
+    };
+
+    /*
+     * Hierarchical timing wheel: 4 levels of 64 slots, each level 64 times
+     * coarser than the one below, covering 2^24 ticks. A timer is linked into
+     * the level its remaining time falls in, and moved down a level each time
+     * the level below wraps around. Timers further out than the wheel spans
+     * park on the top level until they come in range.
+     *
+     * Time only moves in `advance()`. Deadlines count from `now()`, the time
+     * of the last call rounded down to a tick, so arming does not read the
+     * clock. A timer expires in the first `advance()` at or after its
+     * deadline. Empty slots are skipped using one occupancy bitmap per level.
+     */
+    class TimerWheel
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        explicit TimerWheel(clock::duration resolution = std::chrono::milliseconds(10),
+            clock::time_point start = clock::now());
+
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+        ~TimerWheel();
+
+        /* Arms `timer` to expire `after` from now, re-arming it if it is armed. */
+        void arm(Timer& timer, clock::duration after);
+
+        /* Moves time to `now` and appends the timers which expired meanwhile to
+         * `expired`, in expiry order, disarmed. Reuse the vector to avoid
+         * allocating. Returns the number of timers appended.
+         */
+        size_t advance(clock::time_point now, std::vector<Timer*>& expired);
+
+        /* Returns the time of the last `advance()`, rounded down to a tick. */
+        clock::time_point now() const;
+
+        /* Returns the number of armed timers. */
+        size_t size() const;
+
+    private:
+        friend class Timer;
+
+        static constexpr size_t __levels = 4;
+        static constexpr size_t __bits = 6;
+        static constexpr size_t __slots = size_t(1) << __bits;
+        static constexpr uint64_t __span = uint64_t(1) << (__levels * __bits);
+
+        void __link(Timer* timer);
+
+        void __unlink(Timer* timer);
+
+        void __cascade(size_t level, uint64_t tick);
+
+        clock::time_point   _start;
+        clock::duration     _resolution;
+        uint64_t            _now = 0;   // ticks since `_start`
+        size_t              _size = 0;
+        uint64_t            _occupied[__levels] = {};
+        Timer*              _heads[__levels * __slots] = {};
+    };
+
+    /* Time allowed for each phase of a connection; zero disables the phase. */
+    struct Deadlines
+    {
+        TimerWheel::clock::duration header;     // from the first byte to the end of the head
+        TimerWheel::clock::duration body;       // between two pieces of the body
+        TimerWheel::clock::duration idle;       // between two messages
+    };
+
+    enum class DeadlinePhase : uint8_t
+    {
+        none,
+        idle,
+        header,
+        body,
+    };
+
+#define _DEADLINE_FORWARD_CB(name)                                              \
+    int _##name(Parser* p)                                                      \
+    {                                                                           \
+        if constexpr (detail::has__##name<Inner>::value)                        \
+        {                                                                       \
+            return Inner::_##name(p);                                           \
+        }                                                                       \
+        return 0;                                                               \
+    }
+
+#define _DEADLINE_FORWARD_DATA_CB(name)                                         \
+    int _##name(Parser* p, const char* at, size_t length)                       \
+    {                                                                           \
+        if constexpr (detail::has__##name<Inner>::value)                        \
+        {                                                                       \
+            return Inner::_##name(p, at, length);                               \
+        }                                                                       \
+        return 0;                                                               \
+    }
+
+    /*
+     * Settings for `BasicParser` which behave like `Inner` and keep one timer
+     * per parser on a `TimerWheel`:
+     *
+     *  - the idle deadline is armed on construction and after every message;
+     *  - `on_message_begin` arms the header deadline, so a slow head expires
+     *    however steadily it trickles in;
+     *  - `on_headers_complete` and every `on_body` arm the body deadline, so
+     *    the body has to keep progressing;
+     *  - `on_message_complete` clears it, then arms the idle deadline.
+     *
+     * Set `timer().data` to find the connection again when the timer shows up
+     * in `TimerWheel::advance()`; `phase()` tells which deadline it was.
+     */
+    template<class Inner>
+    class DeadlineSetting : public Inner
+    {
+    public:
+        template<class... Args>
+        DeadlineSetting(TimerWheel* wheel, const Deadlines& deadlines, Args&&... args)
+            : Inner(std::forward<Args>(args)...)
+            , _wheel(wheel)
+            , _deadlines(deadlines)
+        {
+            __arm(DeadlinePhase::idle, _deadlines.idle);
+        }
+
+        Timer& timer()
+        {
+            return _timer;
+        }
+
+        /* Returns the deadline the timer is, or last was, armed for. */
+        DeadlinePhase phase() const
+        {
+            return _phase;
+        }
+
+        int _on_message_begin(Parser* p)
+        {
+            __arm(DeadlinePhase::header, _deadlines.header);
+            if constexpr (detail::has__on_message_begin<Inner>::value)
+            {
+                return Inner::_on_message_begin(p);
+            }
+            return 0;
+        }
+
+        int _on_headers_complete(Parser* p)
+        {
+            __arm(DeadlinePhase::body, _deadlines.body);
+            if constexpr (detail::has__on_headers_complete<Inner>::value)
+            {
+                return Inner::_on_headers_complete(p);
+            }
+            return 0;
+        }
+
+        int _on_body(Parser* p, const char* at, size_t length)
+        {
+            __arm(DeadlinePhase::body, _deadlines.body);
+            if constexpr (detail::has__on_body<Inner>::value)
+            {
+                return Inner::_on_body(p, at, length);
+            }
+            return 0;
+        }
+
+        int _on_message_complete(Parser* p)
+        {
+            __arm(DeadlinePhase::idle, _deadlines.idle);
+            if constexpr (detail::has__on_message_complete<Inner>::value)
+            {
+                return Inner::_on_message_complete(p);
+            }
+            return 0;
+        }
+
+        _DEADLINE_FORWARD_DATA_CB(on_url)
+        _DEADLINE_FORWARD_DATA_CB(on_status)
+        _DEADLINE_FORWARD_DATA_CB(on_header_field)
+        _DEADLINE_FORWARD_DATA_CB(on_header_value)
+        _DEADLINE_FORWARD_CB(on_chunk_header)
+        _DEADLINE_FORWARD_CB(on_chunk_complete)
+        _DEADLINE_FORWARD_CB(on_url_complete)
+        _DEADLINE_FORWARD_CB(on_status_complete)
+        _DEADLINE_FORWARD_CB(on_header_field_complete)
+        _DEADLINE_FORWARD_CB(on_header_value_complete)
+
+    private:
+        void __arm(DeadlinePhase phase, TimerWheel::clock::duration after)
+        {
+            _phase = phase;
+            if (after.count() > 0)
+            {
+                _wheel->arm(_timer, after);
+            }
+            else
+            {
+                _timer.cancel();
+            }
+        }
+
+        TimerWheel*     _wheel;
+        Deadlines       _deadlines;
+        Timer           _timer;
+        DeadlinePhase   _phase = DeadlinePhase::none;
+    };
+
+#undef _DEADLINE_FORWARD_CB
+#undef _DEADLINE_FORWARD_DATA_CB
+}
+
+#endif
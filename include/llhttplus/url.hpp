@@ -0,0 +1,167 @@
+#pragma once
+
+#ifndef _LLHTTP_URL_HPP_
+#define _LLHTTP_URL_HPP_
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <string_view>
+
+namespace llhttplus
+{
+    /* Returns true if `value` contains a `%` escape, or a `+` when `plus` is
+     * set; otherwise decoding would return it unchanged. Scans 16 bytes at a
+     * time.
+     */
+    bool needs_decoding(std::string_view value, bool plus = false);
+
+    /* Decodes `%XX` escapes, and `+` to a space if `plus` is set (as in
+     * query strings). Malformed escapes are kept as they are. Returns
+     * `value` itself if nothing has to be decoded, otherwise a copy
+     * allocated from `resource`, e.g. `&parser.arena()`.
+     */
+    std::string_view percent_decode(std::string_view value, std::pmr::memory_resource* resource, bool plus = false);
+
+    /* Decodes `data` in place, see `percent_decode()`. Returns the new length,
+     * which is never longer.
+     */
+    size_t percent_decode_in_place(char* data, size_t length, bool plus = false);
+
+    /* One `key=value` pair of a query string, still encoded. */
+    struct QueryParam
+    {
+        std::string_view key;
+        std::string_view value;
+    };
+
+    /* Iterates the pairs of a query string separated by `&`, skipping empty
+     * ones. A pair without `=` has an empty value.
+     */
+    class QueryIterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = QueryParam;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const QueryParam*;
+        using reference         = const QueryParam&;
+
+        QueryIterator() = default;
+
+        explicit QueryIterator(std::string_view query);
+
+        reference operator*() const
+        {
+            return _param;
+        }
+
+        pointer operator->() const
+        {
+            return &_param;
+        }
+
+        QueryIterator& operator++();
+
+        QueryIterator operator++(int)
+        {
+            QueryIterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const QueryIterator& other) const
+        {
+            return _param.key.data() == other._param.key.data();
+        }
+
+        bool operator!=(const QueryIterator& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        void __load();
+
+        std::string_view _rest;
+        QueryParam       _param;
+    };
+
+    struct QueryRange
+    {
+        QueryIterator begin() const
+        {
+            return QueryIterator(query);
+        }
+
+        QueryIterator end() const
+        {
+            return QueryIterator();
+        }
+
+        std::string_view query;
+    };
+
+    /*
+     * Parts of a request target, e.g. `Request::url`, without copying it.
+     *
+     *     llhttplus::UrlView url(request.url);
+     *     for (auto param : url.params())
+     *     {
+     *         auto value = llhttplus::percent_decode(param.value, &parser.arena(), true);
+     *     }
+     *
+     * Construction is free; the target is split on the first access. Views
+     * point into the target and are still encoded. The absolute form
+     * (`http://host/path`) is accepted, the authority is skipped.
+     */
+    class UrlView
+    {
+    public:
+        explicit UrlView(std::string_view url)
+            : _url(url)
+        {
+        }
+
+        std::string_view url() const
+        {
+            return _url;
+        }
+
+        /* Returns the path, e.g. `/a/b`. */
+        std::string_view path() const;
+
+        /* Returns the query without `?`. */
+        std::string_view query() const;
+
+        /* Returns the fragment without `#`; clients do not normally send one. */
+        std::string_view fragment() const;
+
+        QueryRange params() const
+        {
+            return { query() };
+        }
+
+        /* Returns the still encoded value of the first parameter named `key`,
+         * or an empty view.
+         */
+        std::string_view param(std::string_view key) const;
+
+        /* Returns the decoded path, see `percent_decode()`. */
+        std::string_view decoded_path(std::pmr::memory_resource* resource) const
+        {
+            return percent_decode(path(), resource);
+        }
+
+    private:
+        void __split() const;
+
+        std::string_view _url;
+        mutable bool     _split = false;
+        mutable uint32_t _path = 0;         // offset of the path
+        mutable uint32_t _query = 0;        // offset of `?`, or of the end of the path
+        mutable uint32_t _fragment = 0;     // offset of `#`, or the length
+    };
+}
+
+#endif
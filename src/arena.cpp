@@ -0,0 +1,107 @@
+#include <llhttplus/arena.hpp>
+#include <cstdint>
+#include <new>
+
+namespace llhttplus
+{
+    static char* __align_up(char* p, size_t alignment)
+    {
+        auto value = reinterpret_cast<uintptr_t>(p);
+        return reinterpret_cast<char*>((value + alignment - 1) & ~(uintptr_t)(alignment - 1));
+    }
+
+    Arena::Arena(size_t block_size)
+        : _block_size(block_size)
+    {
+    }
+
+    Arena::~Arena()
+    {
+        release();
+    }
+
+    void Arena::reset()
+    {
+        _current = 0;
+        _cursor = _blocks.empty() ? nullptr : _blocks.front().data;
+        _end = _blocks.empty() ? nullptr : _blocks.front().data + _blocks.front().size;
+        _bytes_used = 0;
+    }
+
+    void Arena::release()
+    {
+        for (auto& block : _blocks)
+        {
+            ::operator delete(block.data);
+        }
+        _blocks.clear();
+        reset();
+    }
+
+    size_t Arena::allocations() const
+    {
+        return _allocations;
+    }
+
+    size_t Arena::upstream_allocations() const
+    {
+        return _upstream_allocations;
+    }
+
+    size_t Arena::bytes_used() const
+    {
+        return _bytes_used;
+    }
+
+    bool Arena::__enter_block(size_t index, size_t bytes, size_t alignment)
+    {
+        auto& block = _blocks[index];
+        auto* begin = __align_up(block.data, alignment);
+        if (begin + bytes > block.data + block.size)
+        {
+            return false;
+        }
+
+        _current = index;
+        _cursor = block.data;
+        _end = block.data + block.size;
+        return true;
+    }
+
+    void* Arena::do_allocate(size_t bytes, size_t alignment)
+    {
+        auto* p = __align_up(_cursor, alignment);
+        if (_cursor == nullptr || p + bytes > _end)
+        {
+            /* Retained blocks are reused in order before asking upstream. */
+            size_t next = _blocks.empty() ? 0 : _current + 1;
+            while (next < _blocks.size() && !__enter_block(next, bytes, alignment))
+            {
+                ++next;
+            }
+
+            if (next == _blocks.size())
+            {
+                size_t size = bytes + alignment > _block_size ? bytes + alignment : _block_size;
+                _blocks.push_back({ static_cast<char*>(::operator new(size)), size });
+                ++_upstream_allocations;
+                __enter_block(next, bytes, alignment);
+            }
+            p = __align_up(_cursor, alignment);
+        }
+
+        _cursor = p + bytes;
+        _bytes_used += bytes;
+        ++_allocations;
+        return p;
+    }
+
+    void Arena::do_deallocate(void*, size_t, size_t)
+    {
+    }
+
+    bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+}
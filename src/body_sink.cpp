@@ -0,0 +1,93 @@
+#include <llhttplus/body_sink.hpp>
+#include "llhttp.h"
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <unistd.h>
+
+namespace llhttplus
+{
+    IovecSink::IovecSink(std::pmr::memory_resource* resource)
+        : _iov(resource)
+    {
+    }
+
+    int IovecSink::write(const RequestBase&, const char* at, size_t length)
+    {
+        _iov.push_back({ const_cast<char*>(at), length });
+        _bytes += length;
+        return 0;
+    }
+
+    const iovec* IovecSink::data() const
+    {
+        return _iov.data();
+    }
+
+    size_t IovecSink::size() const
+    {
+        return _iov.size();
+    }
+
+    size_t IovecSink::bytes() const
+    {
+        return _bytes;
+    }
+
+    void IovecSink::clear()
+    {
+        _iov.clear();
+        _bytes = 0;
+    }
+
+    FdSink::FdSink(int fd, off_t offset)
+        : _fd(fd)
+        , _offset(offset)
+    {
+    }
+
+    int FdSink::write(const RequestBase&, const char* at, size_t length)
+    {
+        while (length > 0)
+        {
+            ssize_t n = _offset < 0
+                ? ::write(_fd, at, length)
+                : ::pwrite(_fd, at, length, _offset);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                _error = errno;
+                return HPE_USER;
+            }
+            if (n == 0)
+            {
+                /* No progress and no errno: retrying would spin forever. */
+                _error = EIO;
+                return HPE_USER;
+            }
+
+            at += n;
+            length -= n;
+            _written += n;
+            if (_offset >= 0)
+            {
+                _offset += n;
+            }
+        }
+        return 0;
+    }
+
+    size_t FdSink::written() const
+    {
+        return _written;
+    }
+
+    int FdSink::error() const
+    {
+        return _error;
+    }
+}
+#endif
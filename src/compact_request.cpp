@@ -0,0 +1,136 @@
+#include <llhttplus/compact_request.hpp>
+#include <cstring>
+
+namespace llhttplus
+{
+    std::string_view CompactRequest::get(std::string_view name) const
+    {
+        for (const auto& header : headers)
+        {
+            if (detail::__iequals(view(header.field), name))
+            {
+                return view(header.value);
+            }
+        }
+        return std::string_view();
+    }
+
+    void CompactSetting::bind(CompactRequest* request)
+    {
+        if (_request != request)
+        {
+            _request = request;
+            _open = nullptr;
+        }
+    }
+
+    int CompactSetting::__append(Parser* p, CompactSpan* span, const char* at, size_t length)
+    {
+        const char* base = _request->base();
+        if (at < base || static_cast<uint64_t>(at - base) + length > UINT32_MAX)
+        {
+            p->set_error_reason("Span outside of the request base");
+            return HPE_USER;
+        }
+
+        auto offset = static_cast<uint32_t>(at - base);
+        if (span != _open)
+        {
+            _open = span;
+            *span = { offset, static_cast<uint32_t>(length) };
+        }
+        else if (offset == span->offset + span->length)
+        {
+            span->length += static_cast<uint32_t>(length);
+        }
+        else
+        {
+            p->set_error_reason("Span is not contiguous in the request buffer");
+            return HPE_USER;
+        }
+        return 0;
+    }
+
+    int CompactSetting::_on_message_begin(Parser* p)
+    {
+        _request->clear();
+        _open = nullptr;
+        return 0;
+    }
+
+    int CompactSetting::_on_url(Parser* p, const char* at, size_t length)
+    {
+        return __append(p, &_request->url, at, length);
+    }
+
+    int CompactSetting::_on_status(Parser* p, const char* at, size_t length)
+    {
+        return __append(p, &_request->status, at, length);
+    }
+
+    int CompactSetting::_on_header_field(Parser* p, const char* at, size_t length)
+    {
+        auto& headers = _request->headers;
+        if (headers.empty() || _open != &headers.back().field)
+        {
+            headers.push_back({});
+        }
+        return __append(p, &headers.back().field, at, length);
+    }
+
+    int CompactSetting::_on_header_value(Parser* p, const char* at, size_t length)
+    {
+        return __append(p, &_request->headers.back().value, at, length);
+    }
+
+    int CompactSetting::_on_headers_complete(Parser* p)
+    {
+        _request->method = p->get_method();
+        _request->version_major = p->get_http_major();
+        _request->version_minor = p->get_http_minor();
+        return 0;
+    }
+
+    int CompactSetting::_on_body(Parser* p, const char* at, size_t length)
+    {
+        auto& body = _request->body;
+        if (_open == &body && _request->base() + body.offset + body.length != at)
+        {
+            /* Chunked payload: move it over the framing right behind the body. */
+            auto* end = const_cast<char*>(_request->base() + body.offset + body.length);
+            std::memmove(end, at, length);
+            at = end;
+        }
+        return __append(p, &body, at, length);
+    }
+
+    int CompactSetting::_on_url_complete(Parser* p)
+    {
+        _open = nullptr;
+        return 0;
+    }
+
+    int CompactSetting::_on_status_complete(Parser* p)
+    {
+        _open = nullptr;
+        return 0;
+    }
+
+    int CompactSetting::_on_header_field_complete(Parser* p)
+    {
+        _open = nullptr;
+        return 0;
+    }
+
+    int CompactSetting::_on_header_value_complete(Parser* p)
+    {
+        _open = nullptr;
+        return 0;
+    }
+
+    llhttp_errno_t CompactParser::execute(CompactRequest* request, char *data, size_t len) noexcept
+    {
+        callbacks().bind(request);
+        return Parser::execute(nullptr, data, len);
+    }
+}
@@ -0,0 +1,228 @@
+#include <llhttplus/connection.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace llhttplus
+{
+    Connection::Connection(size_t capacity, size_t max_capacity, size_t max_pipelined, std::pmr::memory_resource* resource)
+        : _buffer(std::min(capacity, max_capacity), resource)
+        , _slots(resource)
+        , _max_capacity(max_capacity)
+    {
+        max_pipelined = std::max<size_t>(max_pipelined, 1);
+        _slots.reserve(max_pipelined);
+        for (size_t i = 0; i < max_pipelined; ++i)
+        {
+            _slots.emplace_back(resource);
+        }
+        _parser.pause_on_message_complete(true);
+    }
+
+    ReceiveRegion Connection::prepare(size_t min_size)
+    {
+        if (_buffer.size() - _end < min_size)
+        {
+            __compact();
+        }
+
+        if (_buffer.size() - _end < min_size && _buffer.size() < _max_capacity)
+        {
+            size_t capacity = std::max<size_t>(_buffer.size(), 1);
+            while (capacity - _end < min_size && capacity < _max_capacity)
+            {
+                capacity *= 2;
+            }
+            _buffer.resize(std::min(capacity, _max_capacity));
+            __rebase();
+        }
+        return { _buffer.data() + _end, _buffer.size() - _end };
+    }
+
+    void Connection::commit(size_t size)
+    {
+        assert(size <= _buffer.size() - _end);
+        if (size <= _buffer.size() - _end)
+        {
+            _end += size;
+        }
+    }
+
+    CompactRequest* Connection::next()
+    {
+        if (_closing || _parsed == _end || _live == _slots.size())
+        {
+            return nullptr;
+        }
+
+        auto& slot = __slot(_live);
+        if (!_parsing)
+        {
+            slot.begin = _parsed;
+            slot.request.rebase(_buffer.data() + _parsed);
+            _parsing = true;
+        }
+
+        auto err = _parser.execute(&slot.request, _buffer.data() + _parsed, _end - _parsed);
+        if (err == HPE_PAUSED)
+        {
+            size_t end = _parser.get_error_pos() - _buffer.data();
+            _parser.resume();
+            return __complete(end);
+        }
+
+        if (err != HPE_OK)
+        {
+            _error = err;
+            _closing = true;
+            return nullptr;
+        }
+        _parsed = _end;
+        return nullptr;
+    }
+
+    CompactRequest* Connection::finish()
+    {
+        CompactRequest* request = nullptr;
+        if (_error == HPE_OK && _parsing && _live < _slots.size())
+        {
+            auto err = _parser.finish();
+            if (err == HPE_PAUSED)
+            {
+                request = __complete(_end);
+            }
+            else if (err != HPE_OK)
+            {
+                _error = err;
+            }
+        }
+        _closing = true;
+        return request;
+    }
+
+    void Connection::pop()
+    {
+        if (_live == 0)
+        {
+            return;
+        }
+
+        _head = (_head + 1) % _slots.size();
+        --_live;
+
+        /* Nothing references the buffer anymore: start over at its front. */
+        if (_live == 0 && !_parsing && _parsed == _end)
+        {
+            _parsed = 0;
+            _end = 0;
+        }
+    }
+
+    void Connection::reset()
+    {
+        _parser.reset();
+        _parser.callbacks().bind(nullptr);
+        _head = 0;
+        _live = 0;
+        _parsing = false;
+        _parsed = 0;
+        _end = 0;
+        _closing = false;
+        _upgraded = false;
+        _error = HPE_OK;
+    }
+
+    CompactRequest& Connection::front()
+    {
+        return __slot(0).request;
+    }
+
+    size_t Connection::live() const
+    {
+        return _live;
+    }
+
+    bool Connection::empty() const
+    {
+        return _live == 0 && !_parsing && _parsed == _end;
+    }
+
+    bool Connection::keep_alive() const
+    {
+        return !_closing;
+    }
+
+    bool Connection::upgraded() const
+    {
+        return _upgraded;
+    }
+
+    std::string_view Connection::unparsed() const
+    {
+        return std::string_view(_buffer.data() + _parsed, _end - _parsed);
+    }
+
+    llhttp_errno_t Connection::error() const
+    {
+        return _error;
+    }
+
+    CompactParser& Connection::parser()
+    {
+        return _parser;
+    }
+
+    Connection::Slot& Connection::__slot(size_t i)
+    {
+        return _slots[(_head + i) % _slots.size()];
+    }
+
+    CompactRequest* Connection::__complete(size_t end)
+    {
+        auto& slot = __slot(_live++);
+        _parsed = end;
+        _parsing = false;
+
+        if (_parser.get_upgrade())
+        {
+            _upgraded = true;
+            _closing = true;
+        }
+        else if (!_parser.should_keep_alive())
+        {
+            _closing = true;
+        }
+        return &slot.request;
+    }
+
+    void Connection::__compact()
+    {
+        size_t first = _parsed;
+        if (_live > 0 || _parsing)
+        {
+            first = __slot(0).begin;
+        }
+        if (first == 0)
+        {
+            return;
+        }
+
+        std::memmove(_buffer.data(), _buffer.data() + first, _end - first);
+        for (size_t i = 0; i < _live + (_parsing ? 1 : 0); ++i)
+        {
+            __slot(i).begin -= first;
+        }
+        _parsed -= first;
+        _end -= first;
+        __rebase();
+    }
+
+    void Connection::__rebase()
+    {
+        for (size_t i = 0; i < _live + (_parsing ? 1 : 0); ++i)
+        {
+            auto& slot = __slot(i);
+            slot.request.rebase(_buffer.data() + slot.begin);
+        }
+    }
+}
@@ -0,0 +1,345 @@
+#include <llhttplus/fast_path.hpp>
+#include <llhttplus/llhttplus.hpp>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define _LLHTTP_FAST_PATH_SSE2
+#if defined(__GNUC__)
+#define _LLHTTP_FAST_PATH_AVX2
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace llhttplus
+{
+    namespace detail
+    {
+        using __scan_fn = const char* (*)(const char*, const char*);
+
+        /* A URL ends at the first byte outside 0x21..0x7e, a header value at
+         * the first control character other than HT. Both are meant to stop
+         * at the delimiter; any other stop byte makes the fast path give up.
+         */
+        static bool __url_stop(unsigned char c)
+        {
+            return c <= 0x20 || c >= 0x7f;
+        }
+
+        static bool __value_stop(unsigned char c)
+        {
+            return (c < 0x20 && c != '\t') || c == 0x7f;
+        }
+
+        template<bool Url>
+        static const char* __scan_scalar(const char* p, const char* end)
+        {
+            for (; p < end; ++p)
+            {
+                if (Url ? __url_stop(*p) : __value_stop(*p))
+                {
+                    break;
+                }
+            }
+            return p;
+        }
+
+#if defined(_LLHTTP_FAST_PATH_SSE2)
+        static unsigned __first_bit(unsigned mask)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return index;
+#else
+            return __builtin_ctz(mask);
+#endif
+        }
+
+        template<bool Url>
+        static const char* __scan_sse2(const char* p, const char* end)
+        {
+            const __m128i space = _mm_set1_epi8(0x20);
+            const __m128i del = _mm_set1_epi8(0x7f);
+            const __m128i ctl = _mm_set1_epi8(0x1f);
+            const __m128i tab = _mm_set1_epi8('\t');
+            for (; end - p >= 16; p += 16)
+            {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                unsigned mask;
+                if constexpr (Url)
+                {
+                    /* Signed compare: bytes from 0x80 are negative and stop too. */
+                    __m128i ok = _mm_andnot_si128(_mm_cmpeq_epi8(x, del), _mm_cmpgt_epi8(x, space));
+                    mask = ~static_cast<unsigned>(_mm_movemask_epi8(ok)) & 0xffff;
+                }
+                else
+                {
+                    __m128i stop = _mm_or_si128(_mm_cmpeq_epi8(x, del),
+                        _mm_andnot_si128(_mm_cmpeq_epi8(x, tab), _mm_cmpeq_epi8(_mm_min_epu8(x, ctl), x)));
+                    mask = static_cast<unsigned>(_mm_movemask_epi8(stop));
+                }
+
+                if (mask != 0)
+                {
+                    return p + __first_bit(mask);
+                }
+            }
+            return __scan_scalar<Url>(p, end);
+        }
+#endif
+
+#if defined(_LLHTTP_FAST_PATH_AVX2)
+        template<bool Url>
+        __attribute__((target("avx2")))
+        static const char* __scan_avx2(const char* p, const char* end)
+        {
+            const __m256i space = _mm256_set1_epi8(0x20);
+            const __m256i del = _mm256_set1_epi8(0x7f);
+            const __m256i ctl = _mm256_set1_epi8(0x1f);
+            const __m256i tab = _mm256_set1_epi8('\t');
+            for (; end - p >= 32; p += 32)
+            {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                unsigned mask;
+                if constexpr (Url)
+                {
+                    __m256i ok = _mm256_andnot_si256(_mm256_cmpeq_epi8(x, del), _mm256_cmpgt_epi8(x, space));
+                    mask = ~static_cast<unsigned>(_mm256_movemask_epi8(ok));
+                }
+                else
+                {
+                    __m256i stop = _mm256_or_si256(_mm256_cmpeq_epi8(x, del),
+                        _mm256_andnot_si256(_mm256_cmpeq_epi8(x, tab), _mm256_cmpeq_epi8(_mm256_min_epu8(x, ctl), x)));
+                    mask = static_cast<unsigned>(_mm256_movemask_epi8(stop));
+                }
+
+                if (mask != 0)
+                {
+                    return p + __builtin_ctz(mask);
+                }
+            }
+            return __scan_sse2<Url>(p, end);
+        }
+#endif
+
+        struct __Scanners
+        {
+            __scan_fn   url;
+            __scan_fn   value;
+            const char* isa;
+        };
+
+        static __Scanners __select_scanners()
+        {
+#if defined(_LLHTTP_FAST_PATH_AVX2)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2"))
+            {
+                return { __scan_avx2<true>, __scan_avx2<false>, "avx2" };
+            }
+#endif
+#if defined(_LLHTTP_FAST_PATH_SSE2)
+            /* SSE2 is part of x86-64, no check needed. */
+            return { __scan_sse2<true>, __scan_sse2<false>, "sse2" };
+#else
+            return { __scan_scalar<true>, __scan_scalar<false>, "scalar" };
+#endif
+        }
+
+        static const __Scanners& __scanners()
+        {
+            static const __Scanners scanners = __select_scanners();
+            return scanners;
+        }
+
+        /* RFC 9110 tchar. */
+        static constexpr bool __is_token(unsigned char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                || std::string_view("!#$%&'*+-.^_`|~").find(static_cast<char>(c)) != std::string_view::npos;
+        }
+
+        struct __TokenTable
+        {
+            bool value[256];
+
+            constexpr __TokenTable()
+                : value()
+            {
+                for (int c = 0; c < 256; ++c)
+                {
+                    value[c] = __is_token(static_cast<unsigned char>(c));
+                }
+            }
+        };
+
+        static constexpr __TokenTable __token_table;
+
+        static const char* __match_method(const char* p, const char* end, llhttp_method_t* method)
+        {
+            static constexpr struct
+            {
+                std::string_view    prefix;
+                llhttp_method_t     method;
+            } methods[] = {
+                { "GET ", HTTP_GET },
+                { "POST ", HTTP_POST },
+                { "HEAD ", HTTP_HEAD },
+                { "PUT ", HTTP_PUT },
+                { "DELETE ", HTTP_DELETE },
+                { "OPTIONS ", HTTP_OPTIONS },
+                { "PATCH ", HTTP_PATCH },
+            };
+
+            for (const auto& candidate : methods)
+            {
+                if (static_cast<size_t>(end - p) >= candidate.prefix.size()
+                    && std::memcmp(p, candidate.prefix.data(), candidate.prefix.size()) == 0)
+                {
+                    *method = candidate.method;
+                    return p + candidate.prefix.size();
+                }
+            }
+            return nullptr;
+        }
+
+        bool __fast_parse(RequestBase* request, const char* data, size_t len)
+        {
+            const auto& scanners = __scanners();
+            const char* end = data + len;
+            const char* p = __match_method(data, end, &request->method);
+            if (p == nullptr)
+            {
+                return false;
+            }
+
+            const char* url = p;
+            p = scanners.url(p, end);
+            if (p == url || end - p < 11 || *p != ' ')
+            {
+                return false;
+            }
+            request->url = std::string_view(url, p - url);
+
+            ++p;
+            if (std::memcmp(p, "HTTP/1.", 7) != 0 || (p[7] != '0' && p[7] != '1') || p[8] != '\r' || p[9] != '\n')
+            {
+                return false;
+            }
+            request->version_major = 1;
+            request->version_minor = p[7] - '0';
+            p += 10;
+
+            bool has_length = false;
+            uint64_t content_length = 0;
+            bool keep_alive = false;
+            for (;;)
+            {
+                if (end - p < 2)
+                {
+                    return false;
+                }
+                if (p[0] == '\r')
+                {
+                    if (p[1] != '\n')
+                    {
+                        return false;
+                    }
+                    p += 2;
+                    break;
+                }
+
+                const char* name = p;
+                while (p < end && __token_table.value[static_cast<unsigned char>(*p)])
+                {
+                    ++p;
+                }
+                if (p == name || p == end || *p != ':')
+                {
+                    return false;
+                }
+                std::string_view field(name, p - name);
+
+                ++p;
+                while (p < end && (*p == ' ' || *p == '\t'))
+                {
+                    ++p;
+                }
+                const char* value_begin = p;
+                p = scanners.value(p, end);
+                if (end - p < 2 || p[0] != '\r' || p[1] != '\n')
+                {
+                    return false;
+                }
+                std::string_view value(value_begin, p - value_begin);
+                if (!value.empty() && (value.back() == ' ' || value.back() == '\t'))
+                {
+                    return false;
+                }
+                p += 2;
+
+                auto known = classify_header(field);
+                switch (known)
+                {
+                case KnownHeader::TransferEncoding:
+                case KnownHeader::Upgrade:
+                    return false;
+                case KnownHeader::ContentLength:
+                    if (has_length || value.empty() || value.size() > 15)
+                    {
+                        return false;
+                    }
+                    for (char c : value)
+                    {
+                        if (c < '0' || c > '9')
+                        {
+                            return false;
+                        }
+                        content_length = content_length * 10 + (c - '0');
+                    }
+                    has_length = true;
+                    break;
+                case KnownHeader::Connection:
+                    if (!__iequals(value, "keep-alive"))
+                    {
+                        return false;
+                    }
+                    keep_alive = true;
+                    break;
+                case KnownHeader::Unknown:
+                    /* llhttp treats it like Connection. */
+                    if (__iequals(field, "proxy-connection"))
+                    {
+                        return false;
+                    }
+                    break;
+                default:
+                    break;
+                }
+
+                request->headers.push_back({ field, value });
+                request->index_header(request->headers.size() - 1, known);
+            }
+
+            if (request->version_minor == 0 && !keep_alive)
+            {
+                return false;
+            }
+            if (static_cast<uint64_t>(end - p) != content_length)
+            {
+                return false;
+            }
+            request->body = content_length > 0 ? std::string_view(p, content_length) : std::string_view();
+            return true;
+        }
+    }
+
+    const char* fast_path_isa()
+    {
+        return detail::__scanners().isa;
+    }
+}
@@ -0,0 +1,59 @@
+#include <llhttplus/headers.hpp>
+#include <cstring>
+
+namespace llhttplus
+{
+    HeaderList::HeaderList(Header* inline_data, size_t inline_capacity, std::pmr::memory_resource* resource)
+        : _data(inline_data)
+        , _size(0)
+        , _capacity(inline_capacity)
+        , _inline(inline_data)
+        , _inline_capacity(inline_capacity)
+        , _resource(resource)
+    {
+    }
+
+    HeaderList& HeaderList::operator=(const HeaderList& other)
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+
+        clear();
+        for (const auto& header : other)
+        {
+            push_back(header);
+        }
+        return *this;
+    }
+
+    HeaderList::~HeaderList()
+    {
+        release();
+    }
+
+    void HeaderList::release()
+    {
+        if (spilled())
+        {
+            _resource->deallocate(_data, _capacity * sizeof(Header), alignof(Header));
+        }
+        _data = _inline;
+        _size = 0;
+        _capacity = _inline_capacity;
+    }
+
+    void HeaderList::__grow()
+    {
+        size_t capacity = _capacity > 0 ? _capacity * 2 : 8;
+        auto* data = static_cast<Header*>(_resource->allocate(capacity * sizeof(Header), alignof(Header)));
+        std::memcpy(static_cast<void*>(data), _data, _size * sizeof(Header));
+        if (spilled())
+        {
+            _resource->deallocate(_data, _capacity * sizeof(Header), alignof(Header));
+        }
+        _data = data;
+        _capacity = capacity;
+    }
+}
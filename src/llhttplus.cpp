@@ -1,75 +1,52 @@
 #include <llhttplus/llhttplus.hpp>
-#include <llhttplus/setting.hpp>
-#include <iostream>
+#include <llhttplus/default_setting.hpp>
+#include <llhttplus/metrics.hpp>
 
 namespace llhttplus
 {
-    class DefaultSetting : public llhttp::ParserSetting<DefaultSetting>
-    {
-    public:
-        int _on_url(Parser* p, const char* at, size_t length)
-        {
-            p->request()->url = std::string_view(at, length);
-            return 0;
-        }
-
-        int _on_status(Parser* p, const char* at, size_t length)
-        {
-            p->request()->status = std::string_view(at, length);
-            return 0;
-        }
-
-        int _on_header_field(Parser* p, const char* at, size_t length)
-        {
-            p->request()->headers.push_back({
-                    std::string_view(at, length), std::string_view()
-                }
-            );
-            return 0;
-        }
-
-        int _on_header_value(Parser* p, const char* at, size_t length)
-        {
-            p->request()->headers.back().second = std::string_view(at, length);
-            return 0;
-        }
-
-        int _on_body(Parser* p, const char* at, size_t length)
-        {
-            p->request()->body = std::string_view(at, length);
-            return 0;
-        }
+    static DefaultSetting __default_setting;
 
-        int _on_headers_complete(Parser* p)
+    std::string_view RequestBase::get(std::string_view name) const
+    {
+        auto known = classify_header(name);
+        if (known != KnownHeader::Unknown)
         {
-            p->request()->method = p->get_method();
-            p->request()->version_major = p->get_http_major();
-            p->request()->version_minor = p->get_http_minor();
-            return 0;
+            return get(known);
         }
 
-        int _on_message_complete(Parser* p)
+        for (const auto& header : headers)
         {
-            std::cout << "complete" << std::endl;
-            return 0;
+            if (detail::__iequals(header.first, name))
+            {
+                return header.second;
+            }
         }
-    };
-
-    static DefaultSetting __default_setting;
+        return std::string_view();
+    }
 
     Parser::Parser()
     {
-        __init(&__default_setting.low_layer_setting());
+        __init(
+            &__default_setting.low_layer_setting(),
+            static_cast<ParserSetting<DefaultSetting>*>(&__default_setting),
+            true
+        );
     }
 
-    void Parser::__init(llhttp_settings_t* setting)
+    Parser::Parser(const llhttp_settings_t* low_layer_setting, void* setting, bool default_setting)
+    {
+        __init(low_layer_setting, setting, default_setting);
+    }
+
+    void Parser::__init(const llhttp_settings_t* low_layer_setting, void* setting, bool default_setting)
     {
         llhttp_init(
             &_low_layer_parser,
             HTTP_BOTH,
-            setting
+            low_layer_setting
         );
-        _setting = static_cast<void*>(setting);
+        _setting = setting;
+        _default_setting = default_setting;
         _low_layer_parser.data = this;
     }
 
@@ -105,25 +82,149 @@ namespace llhttplus
 
     void Parser::reset()
     {
+        if (_request != nullptr && _request->headers.resource() == &_arena)
+        {
+            _request->headers.release();
+        }
+        _stitcher.clear();
+        _arena.reset();
+        _fast_path_count = 0;
+        _closed = false;
         return llhttp_reset(&_low_layer_parser);
     }
 
-    llhttp_errno_t Parser::execute(Request* _request, const char *data, size_t len) noexcept
+    llhttp_errno_t Parser::execute(RequestBase* _request, const char *data, size_t len) noexcept
     {
+        _LLHTTP_METRIC_TICKS_BEGIN();
+        if (_request != this->_request)
+        {
+            /* A span left open points into the previous request. */
+            _stitcher.close();
+        }
         this->_request = _request;
-        return llhttp_execute(&_low_layer_parser, data, len);
+        auto err = llhttp_execute(&_low_layer_parser, data, len);
+        _stitcher.detach();
+
+        _LLHTTP_METRIC_TICKS_END();
+        _LLHTTP_METRIC_ADD(bytes, len);
+        _LLHTTP_METRIC_ADD(executes, 1);
+        _LLHTTP_METRIC_ERRNO(err);
+        return err;
     }
 
-    llhttp_errno_t Parser::execute(Request* _request, const std::string &data) noexcept
+    llhttp_errno_t Parser::execute(RequestBase* _request, const std::string &data) noexcept
     {
-        this->_request = _request;
-        return llhttp_execute(&_low_layer_parser, data.c_str(), data.length());
+        return execute(_request, data.c_str(), data.length());
     }
 
-    llhttp_errno_t Parser::execute(Request* _request, std::string_view view) noexcept
+    llhttp_errno_t Parser::execute(RequestBase* _request, std::string_view view) noexcept
     {
-        this->_request = _request;
-        return llhttp_execute(&_low_layer_parser, view.data(), view.length());
+        return execute(_request, view.data(), view.length());
+    }
+
+    llhttp_errno_t Parser::execute_in_place(RequestBase* _request, char *data, size_t len) noexcept
+    {
+        _in_place = true;
+        auto err = execute(_request, data, len);
+        _in_place = false;
+        return err;
+    }
+
+    llhttp_errno_t Parser::execute_fast(RequestBase* _request, const char *data, size_t len) noexcept
+    {
+        auto& state = _low_layer_parser;
+        if (_default_setting && !_closed && state.finish == HTTP_FINISH_SAFE && state.error == HPE_OK
+            && state.type != HTTP_RESPONSE && _request->body_sink == nullptr)
+        {
+            _request->clear();
+            if (detail::__fast_parse(_request, data, len))
+            {
+                /* Leave llhttp as if it had parsed the message itself: only
+                 * the fields its getters and `llhttp_should_keep_alive()` read
+                 * are set, to what it leaves after such a request, with the
+                 * flags cleared as after any message. The fast path only takes
+                 * keep-alive requests, so its state machine stays between
+                 * messages, where it is already.
+                 */
+                this->_request = _request;
+                state.type = HTTP_REQUEST;
+                state.method = _request->method;
+                state.http_major = _request->version_major;
+                state.http_minor = _request->version_minor;
+                state.flags = 0;
+                state.upgrade = 0;
+                ++_fast_path_count;
+                _LLHTTP_METRIC_ADD(bytes, len);
+                _LLHTTP_METRIC_ADD(executes, 1);
+                _LLHTTP_METRIC_ADD(messages, 1);
+                _LLHTTP_METRIC_ADD(fast_path_messages, 1);
+                return HPE_OK;
+            }
+        }
+        return execute(_request, data, len);
+    }
+
+    BatchResult Parser::__execute_batch(char* slots, size_t stride, size_t count, const char *data, size_t len) noexcept
+    {
+        _LLHTTP_METRIC_TICKS_BEGIN();
+        BatchResult result{ 0, 0, HPE_OK };
+        const char* end = data + len;
+        const char* pos = data;
+
+        _batch = true;
+        while (result.completed < count && pos < end)
+        {
+            _request = reinterpret_cast<RequestBase*>(slots + result.completed * stride);
+            _batch_completed = false;
+            result.error = llhttp_execute(&_low_layer_parser, pos, end - pos);
+            if (result.error == HPE_PAUSED && _batch_completed)
+            {
+                pos = llhttp_get_error_pos(&_low_layer_parser);
+                llhttp_resume(&_low_layer_parser);
+                result.error = HPE_OK;
+                ++result.completed;
+                continue;
+            }
+
+            if (result.error != HPE_OK && llhttp_get_error_pos(&_low_layer_parser) != nullptr)
+            {
+                pos = llhttp_get_error_pos(&_low_layer_parser);
+            }
+            else
+            {
+                pos = end;
+            }
+            break;
+        }
+        _batch = false;
+
+        _stitcher.detach();
+        result.consumed = pos - data;
+
+        _LLHTTP_METRIC_TICKS_END();
+        _LLHTTP_METRIC_ADD(bytes, result.consumed);
+        _LLHTTP_METRIC_ADD(executes, 1);
+        _LLHTTP_METRIC_ERRNO(result.error);
+        return result;
+    }
+
+    int Parser::__on_message_complete()
+    {
+        _LLHTTP_METRIC_ADD(messages, 1);
+        _batch_completed = true;
+        /* llhttp rejects anything after a message which is not keep-alive. */
+        _closed = !_low_layer_parser.upgrade && !llhttp_should_keep_alive(&_low_layer_parser)
+            && (_low_layer_parser.lenient_flags & LENIENT_KEEP_ALIVE) == 0;
+        if (_batch || _pause_on_complete)
+        {
+            return HPE_PAUSED;
+        }
+        return 0;
+    }
+
+    void Parser::pause_on_message_complete(bool enabled)
+    {
+        _pause_on_complete = enabled;
     }
 
     llhttp_errno_t Parser::finish()
@@ -254,7 +355,7 @@ namespace llhttplus
         return _setting;
     }
 
-    Request* Parser::request()
+    RequestBase* Parser::request()
     {
         return _request;
     }
@@ -263,4 +364,29 @@ namespace llhttplus
     {
         return _low_layer_parser.finish != HTTP_FINISH_UNSAFE;
     }
+
+    Stitcher& Parser::stitcher()
+    {
+        return _stitcher;
+    }
+
+    size_t Parser::stitch_count()
+    {
+        return _stitcher.count();
+    }
+
+    size_t Parser::fast_path_count()
+    {
+        return _fast_path_count;
+    }
+
+    bool Parser::in_place()
+    {
+        return _in_place;
+    }
+
+    Arena& Parser::arena()
+    {
+        return _arena;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include <llhttplus/metrics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define _LLHTTP_METRICS_TSC
+#endif
+
+namespace llhttplus
+{
+    namespace detail
+    {
+        struct __MetricsRegistry
+        {
+            std::mutex                      mutex;
+            std::vector<__ThreadMetrics*>   threads;
+            MetricsSnapshot                 retired = {};
+        };
+
+        /* Never destroyed: threads may exit after static destructors ran. */
+        static __MetricsRegistry& __registry()
+        {
+            static auto* registry = new __MetricsRegistry();
+            return *registry;
+        }
+
+        static void __accumulate(MetricsSnapshot* snapshot, const __ThreadMetrics& metrics)
+        {
+            auto load = [](const std::atomic<uint64_t>& counter) {
+                return counter.load(std::memory_order_relaxed);
+            };
+
+            snapshot->bytes += load(metrics.bytes);
+            snapshot->executes += load(metrics.executes);
+            snapshot->execute_ticks += load(metrics.execute_ticks);
+            snapshot->messages += load(metrics.messages);
+            snapshot->fast_path_messages += load(metrics.fast_path_messages);
+            snapshot->pauses += load(metrics.pauses);
+            snapshot->upgrades += load(metrics.upgrades);
+            snapshot->stitches += load(metrics.stitches);
+            for (size_t i = 0; i < callback_count; ++i)
+            {
+                snapshot->callbacks[i] += load(metrics.callbacks[i]);
+            }
+            for (size_t i = 0; i < errno_count; ++i)
+            {
+                snapshot->errors[i] += load(metrics.errors[i]);
+            }
+        }
+
+        __ThreadMetrics::__ThreadMetrics()
+        {
+            auto& registry = __registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.threads.push_back(this);
+        }
+
+        __ThreadMetrics::~__ThreadMetrics()
+        {
+            auto& registry = __registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            __accumulate(&registry.retired, *this);
+            registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), this));
+        }
+
+        uint64_t __ticks()
+        {
+#if defined(_LLHTTP_METRICS_TSC)
+            return __rdtsc();
+#else
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+        }
+    }
+
+    MetricsSnapshot metrics_snapshot()
+    {
+        MetricsSnapshot snapshot = {};
+#if defined(LLHTTPLUS_METRICS)
+        auto& registry = detail::__registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        snapshot = registry.retired;
+        for (const auto* metrics : registry.threads)
+        {
+            detail::__accumulate(&snapshot, *metrics);
+        }
+#endif
+        return snapshot;
+    }
+}
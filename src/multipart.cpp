@@ -0,0 +1,405 @@
+#include <llhttplus/multipart.hpp>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define _LLHTTP_MULTIPART_SSE2
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace llhttplus
+{
+    namespace detail
+    {
+        /* Request line the part headers are parsed behind. */
+        static constexpr std::string_view __part_prefix = "POST / HTTP/1.1\r\n";
+
+        /* Returns the first complete `delimiter` in `[p, end)` or nullptr.
+         * Candidates are found with SSE2 by comparing the first and the last
+         * byte of the delimiter at once, 16 positions per step, then checked
+         * with `memcmp`; the rest is searched with Horspool.
+         */
+        static const char* __find_delimiter(const char* p, const char* end, const char* delimiter, size_t length,
+            const uint8_t* shift)
+        {
+#if defined(_LLHTTP_MULTIPART_SSE2)
+            const __m128i first = _mm_set1_epi8(delimiter[0]);
+            const __m128i last = _mm_set1_epi8(delimiter[length - 1]);
+            for (; end - p >= static_cast<ptrdiff_t>(length + 15); p += 16)
+            {
+                __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + length - 1));
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+                    _mm_and_si128(_mm_cmpeq_epi8(head, first), _mm_cmpeq_epi8(tail, last))));
+                while (mask != 0)
+                {
+#if defined(_MSC_VER)
+                    unsigned long index;
+                    _BitScanForward(&index, mask);
+#else
+                    unsigned index = static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+                    if (std::memcmp(p + index + 1, delimiter + 1, length - 2) == 0)
+                    {
+                        return p + index;
+                    }
+                    mask &= mask - 1;
+                }
+            }
+#endif
+            const unsigned char last_byte = static_cast<unsigned char>(delimiter[length - 1]);
+            while (end - p >= static_cast<ptrdiff_t>(length))
+            {
+                auto c = static_cast<unsigned char>(p[length - 1]);
+                if (c == last_byte && std::memcmp(p, delimiter, length - 1) == 0)
+                {
+                    return p;
+                }
+                p += shift[c];
+            }
+            return nullptr;
+        }
+
+        /* Returns where a proper prefix of `delimiter` ends `[p, end)`, or
+         * `end`. The delimiter has its only CR in front, so only a CR in the
+         * last `length - 1` bytes can start one.
+         */
+        static const char* __find_partial(const char* p, const char* end, const char* delimiter, size_t length)
+        {
+            const char* from = end - p > static_cast<ptrdiff_t>(length - 1) ? end - (length - 1) : p;
+            while (auto* cr = static_cast<const char*>(std::memchr(from, '\r', end - from)))
+            {
+                if (std::memcmp(cr, delimiter, end - cr) == 0)
+                {
+                    return cr;
+                }
+                from = cr + 1;
+            }
+            return end;
+        }
+
+        static bool __iequals_prefix(std::string_view s, std::string_view prefix)
+        {
+            return s.size() >= prefix.size() && __iequals(s.substr(0, prefix.size()), prefix);
+        }
+    }
+
+    std::string_view multipart_boundary(std::string_view content_type)
+    {
+        if (!detail::__iequals_prefix(content_type, "multipart/"))
+        {
+            return std::string_view();
+        }
+
+        size_t pos = content_type.find(';');
+        while (pos != std::string_view::npos)
+        {
+            pos = content_type.find_first_not_of(" \t", pos + 1);
+            if (pos == std::string_view::npos)
+            {
+                break;
+            }
+
+            std::string_view rest = content_type.substr(pos);
+            if (detail::__iequals_prefix(rest, "boundary="))
+            {
+                rest.remove_prefix(9);
+                if (!rest.empty() && rest[0] == '"')
+                {
+                    size_t close = rest.find('"', 1);
+                    return close == std::string_view::npos ? std::string_view() : rest.substr(1, close - 1);
+                }
+                return rest.substr(0, std::min(rest.find_first_of("; \t"), rest.size()));
+            }
+            pos = content_type.find(';', pos);
+        }
+        return std::string_view();
+    }
+
+    MultipartSink::MultipartSink(size_t max_head)
+        : _part(&_parser.arena())
+        , _max_head(max_head)
+    {
+        _parser.pause_on_message_complete(true);
+        /* Both headers in one part frame nothing; llhttp must not reject them. */
+        _parser.set_lenient_chunked_length(1);
+    }
+
+    void MultipartSink::reset(std::string_view boundary)
+    {
+        _parts = 0;
+        _error = MultipartError::none;
+        _head_error = HPE_OK;
+        _state = State::start;
+        if (!boundary.empty() && !__set_boundary(boundary))
+        {
+            __fail(MultipartError::boundary);
+        }
+    }
+
+    bool MultipartSink::__set_boundary(std::string_view boundary)
+    {
+        if (boundary.empty() || boundary.size() > max_boundary
+            || boundary.find_first_of("\r\n") != std::string_view::npos)
+        {
+            return false;
+        }
+
+        _length = boundary.size() + 4;
+        std::memcpy(_delimiter, "\r\n--", 4);
+        std::memcpy(_delimiter + 4, boundary.data(), boundary.size());
+        std::fill(std::begin(_shift), std::end(_shift), static_cast<uint8_t>(_length));
+        for (size_t i = 0; i + 1 < _length; ++i)
+        {
+            _shift[static_cast<unsigned char>(_delimiter[i])] = static_cast<uint8_t>(_length - 1 - i);
+        }
+
+        /* The body starts with a delimiter without its CRLF: act as if it had one. */
+        _matched = 2;
+        _state = State::preamble;
+        return true;
+    }
+
+    int MultipartSink::write(const RequestBase& request, const char* at, size_t length)
+    {
+        if (_state == State::start)
+        {
+            _parts = 0;
+            _error = MultipartError::none;
+            _head_error = HPE_OK;
+            if (!__set_boundary(multipart_boundary(request.get(KnownHeader::ContentType))))
+            {
+                return __fail(MultipartError::boundary);
+            }
+        }
+
+        const char* p = at;
+        const char* end = at + length;
+        while (p < end)
+        {
+            int ret = 0;
+            switch (_state)
+            {
+            case State::preamble:
+            case State::data:
+                ret = __scan(p, end);
+                break;
+            case State::delimiter:
+                ret = __after_delimiter(p, end);
+                break;
+            case State::head:
+                ret = __head(p, end);
+                break;
+            case State::epilogue:
+                return 0;
+            default:
+                return HPE_USER;
+            }
+            if (ret != 0)
+            {
+                return ret;
+            }
+        }
+        return 0;
+    }
+
+    int MultipartSink::finish(const RequestBase& request)
+    {
+        State state = _state;
+        _state = State::start;
+        if (state == State::epilogue || (state == State::start && _error == MultipartError::none))
+        {
+            return 0;
+        }
+        if (state != State::failed)
+        {
+            _error = MultipartError::truncated;
+        }
+        return HPE_USER;
+    }
+
+    size_t MultipartSink::parts() const
+    {
+        return _parts;
+    }
+
+    MultipartError MultipartSink::error() const
+    {
+        return _error;
+    }
+
+    llhttp_errno_t MultipartSink::head_error() const
+    {
+        return _head_error;
+    }
+
+    int MultipartSink::__fail(MultipartError error)
+    {
+        _state = State::failed;
+        _error = error;
+        return HPE_USER;
+    }
+
+    int MultipartSink::__scan(const char*& p, const char* end)
+    {
+        if (_matched > 0)
+        {
+            size_t n = std::min(_length - _matched, static_cast<size_t>(end - p));
+            if (std::memcmp(p, _delimiter + _matched, n) == 0)
+            {
+                p += n;
+                _matched += n;
+                if (_matched < _length)
+                {
+                    return 0;
+                }
+                _matched = 0;
+                return __delimiter_found();
+            }
+
+            /* What was held back is payload after all. */
+            size_t held = _matched;
+            _matched = 0;
+            if (int ret = __data(_delimiter, held))
+            {
+                return ret;
+            }
+        }
+
+        if (auto* delimiter = detail::__find_delimiter(p, end, _delimiter, _length, _shift))
+        {
+            if (int ret = __data(p, delimiter - p))
+            {
+                return ret;
+            }
+            p = delimiter + _length;
+            return __delimiter_found();
+        }
+
+        auto* partial = detail::__find_partial(p, end, _delimiter, _length);
+        int ret = __data(p, partial - p);
+        _matched = end - partial;
+        p = end;
+        return ret;
+    }
+
+    int MultipartSink::__delimiter_found()
+    {
+        if (_state == State::data && part_end(_part) != 0)
+        {
+            return __fail(MultipartError::handler);
+        }
+        _state = State::delimiter;
+        _after = 0;
+        _head_size = 0;
+        return 0;
+    }
+
+    int MultipartSink::__after_delimiter(const char*& p, const char* end)
+    {
+        enum : uint8_t { first, dash, padding, cr };
+        while (p < end)
+        {
+            char c = *p++;
+            if (++_head_size > _max_head)
+            {
+                return __fail(MultipartError::head_too_large);
+            }
+
+            if (_after == dash || _after == cr)
+            {
+                if (c != (_after == dash ? '-' : '\n'))
+                {
+                    return __fail(MultipartError::framing);
+                }
+                if (_after == dash)
+                {
+                    _state = State::epilogue;
+                    return 0;
+                }
+
+                /* A part head follows. */
+                _parser.reset();
+                _parser.execute(&_part, detail::__part_prefix);
+                _head_size = 0;
+                _state = State::head;
+                return 0;
+            }
+
+            if (c == '-' && _after == first)
+            {
+                _after = dash;
+            }
+            else if (c == ' ' || c == '\t')
+            {
+                _after = padding;
+            }
+            else if (c == '\r')
+            {
+                _after = cr;
+            }
+            else
+            {
+                return __fail(MultipartError::framing);
+            }
+        }
+        return 0;
+    }
+
+    int MultipartSink::__head(const char*& p, const char* end)
+    {
+        auto err = _parser.execute(&_part, p, end - p);
+        if (err == HPE_OK)
+        {
+            _head_size += end - p;
+            p = end;
+            return _head_size > _max_head ? __fail(MultipartError::head_too_large) : 0;
+        }
+        /* An upgrade pauses as well, with nothing to resume: the part ends. */
+        if (err != HPE_PAUSED && err != HPE_PAUSED_UPGRADE)
+        {
+            _head_error = err;
+            return __fail(MultipartError::head);
+        }
+
+        const char* body = _parser.get_error_pos();
+        _head_size += body - p;
+        p = body;
+        if (_head_size > _max_head)
+        {
+            return __fail(MultipartError::head_too_large);
+        }
+
+        /* Views into the input die with this call; the part needs them longer. */
+        auto& arena = _parser.arena();
+        for (auto& header : _part.headers)
+        {
+            for (auto* view : { &header.first, &header.second })
+            {
+                if (!view->empty())
+                {
+                    auto* copy = static_cast<char*>(arena.allocate(view->size(), 1));
+                    std::memcpy(copy, view->data(), view->size());
+                    *view = std::string_view(copy, view->size());
+                }
+            }
+        }
+
+        ++_parts;
+        _state = State::data;
+        return part_begin(_part) != 0 ? __fail(MultipartError::handler) : 0;
+    }
+
+    int MultipartSink::__data(const char* at, size_t length)
+    {
+        if (_state != State::data || length == 0)
+        {
+            return 0;
+        }
+        return part_data(_part, at, length) != 0 ? __fail(MultipartError::handler) : 0;
+    }
+}
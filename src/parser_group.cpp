@@ -0,0 +1,113 @@
+#include <llhttplus/parser_group.hpp>
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace llhttplus
+{
+    namespace detail
+    {
+        static constexpr size_t __cache_line = 64;
+
+        static void __prefetch(const void* p)
+        {
+#if defined(_MSC_VER)
+            _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+            __builtin_prefetch(p, 0, 3);
+#endif
+        }
+
+        /* Prefetches `[p, p + size)`, at most `max_lines` lines of it. */
+        static void __prefetch_range(const void* p, size_t size, size_t max_lines)
+        {
+            auto* begin = static_cast<const char*>(p);
+            size = std::min(size, max_lines * __cache_line);
+            for (size_t offset = 0; offset < size; offset += __cache_line)
+            {
+                __prefetch(begin + offset);
+            }
+        }
+    }
+
+    ParserGroup::ParserGroup(size_t distance)
+        : _distance(std::max<size_t>(distance, 1))
+    {
+    }
+
+    void ParserGroup::execute_many(ParseJob* jobs, size_t count)
+    {
+        _completed.clear();
+        _failed.clear();
+        _completed.reserve(count);
+        _failed.reserve(count);
+
+        /* Stage one: the objects the job refers to. */
+        auto near = [](const ParseJob& job) {
+            detail::__prefetch_range(job.parser, sizeof(Parser), 4);
+            if (job.request != nullptr)
+            {
+                detail::__prefetch_range(job.request, sizeof(RequestBase), 4);
+            }
+            detail::__prefetch_range(job.data, job.length, 2);
+        };
+
+        /* Stage two: what they point to, read from lines fetched by stage one. */
+        auto far = [](const ParseJob& job) {
+            detail::__prefetch(job.parser->_setting);
+            if (job.request != nullptr)
+            {
+                detail::__prefetch(job.request->headers.begin());
+            }
+        };
+
+        size_t ahead = 2 * _distance;
+        for (size_t i = 0; i < std::min(count, ahead); ++i)
+        {
+            near(jobs[i]);
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (i + ahead < count)
+            {
+                near(jobs[i + ahead]);
+            }
+            if (i + _distance < count)
+            {
+                far(jobs[i + _distance]);
+            }
+
+            auto& job = jobs[i];
+            Parser& parser = *job.parser;
+            parser._batch_completed = false;
+            job.error = parser.execute(job.request, job.data, job.length);
+            job.completed = parser._batch_completed;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto& job = jobs[i];
+            if (job.error != HPE_OK && job.error != HPE_PAUSED && job.error != HPE_PAUSED_UPGRADE)
+            {
+                _failed.push_back(static_cast<uint32_t>(i));
+            }
+            else if (job.completed)
+            {
+                _completed.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+
+    const std::vector<uint32_t>& ParserGroup::completed() const
+    {
+        return _completed;
+    }
+
+    const std::vector<uint32_t>& ParserGroup::failed() const
+    {
+        return _failed;
+    }
+}
@@ -0,0 +1,136 @@
+#include <llhttplus/parser_pool.hpp>
+#include <new>
+
+namespace llhttplus
+{
+    struct ParserPool::Slot : PooledParser
+    {
+        Slot* next = nullptr;
+    };
+
+    ParserPool::ParserPool(size_t reserve)
+        : ParserPool(nullptr, nullptr, true, reserve)
+    {
+    }
+
+    ParserPool::ParserPool(const llhttp_settings_t* low_layer_setting, void* setting, bool default_setting, size_t reserve)
+        : _low_layer_setting(low_layer_setting)
+        , _setting(setting)
+        , _default_setting(default_setting)
+        , _owner(std::this_thread::get_id())
+    {
+        this->reserve(reserve);
+    }
+
+    ParserPool::~ParserPool()
+    {
+        for (auto& block : _blocks)
+        {
+            for (size_t i = 0; i < block.second; ++i)
+            {
+                block.first[i].~Slot();
+            }
+            ::operator delete(block.first, std::align_val_t(alignof(Slot)));
+        }
+    }
+
+    PooledParser* ParserPool::acquire()
+    {
+        if (_free == nullptr)
+        {
+            _free = _returned.exchange(nullptr, std::memory_order_acquire);
+            if (_free == nullptr)
+            {
+                __grow(__block_slots);
+            }
+        }
+
+        Slot* slot = _free;
+        _free = slot->next;
+        slot->next = nullptr;
+        return slot;
+    }
+
+    void ParserPool::release(PooledParser* pooled) noexcept
+    {
+        auto* slot = static_cast<Slot*>(pooled);
+        __recycle(slot);
+
+        if (std::this_thread::get_id() == _owner)
+        {
+            slot->next = _free;
+            _free = slot;
+            return;
+        }
+
+        /* Only the owner pops, taking the whole list at once, so there is no ABA. */
+        Slot* head = _returned.load(std::memory_order_relaxed);
+        do
+        {
+            slot->next = head;
+        } while (!_returned.compare_exchange_weak(head, slot, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void ParserPool::reserve(size_t count)
+    {
+        if (count > _size)
+        {
+            __grow(count - _size);
+        }
+    }
+
+    size_t ParserPool::size() const
+    {
+        return _size;
+    }
+
+    void ParserPool::__grow(size_t count)
+    {
+        auto* block = static_cast<Slot*>(::operator new(sizeof(Slot) * count, std::align_val_t(alignof(Slot))));
+        size_t constructed = 0;
+        try
+        {
+            for (; constructed < count; ++constructed)
+            {
+                Slot* slot = new (block + constructed) Slot();
+                if (_setting != nullptr)
+                {
+                    slot->parser.__init(_low_layer_setting, _setting, _default_setting);
+                }
+            }
+        }
+        catch (...)
+        {
+            while (constructed > 0)
+            {
+                block[--constructed].~Slot();
+            }
+            ::operator delete(block, std::align_val_t(alignof(Slot)));
+            throw;
+        }
+
+        /* Pushed in reverse, so pairs are handed out in address order. */
+        for (size_t i = count; i > 0; --i)
+        {
+            block[i - 1].next = _free;
+            _free = block + i - 1;
+        }
+        _blocks.emplace_back(block, count);
+        _size += count;
+    }
+
+    void ParserPool::__recycle(Slot* slot) noexcept
+    {
+        Parser& parser = slot->parser;
+        parser.reset();
+        parser.set_lenient_headers(0);
+        parser.set_lenient_chunked_length(0);
+        parser.set_lenient_keep_alive(0);
+        parser._request = nullptr;
+        parser._batch_completed = false;
+        parser._pause_on_complete = false;
+
+        slot->request.clear();
+        slot->request.body_sink = nullptr;
+    }
+}
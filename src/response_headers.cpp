@@ -0,0 +1,136 @@
+#include <llhttplus/response_headers.hpp>
+#include <cstring>
+#include <ctime>
+#include <forward_list>
+#include <mutex>
+#include <string>
+
+namespace llhttplus
+{
+    namespace detail
+    {
+        struct __BlockRegistry
+        {
+            std::mutex                      mutex;
+            std::forward_list<std::string>  blocks;
+        };
+
+        /* Never destroyed: blocks may be referenced until the process exits. */
+        static __BlockRegistry& __block_registry()
+        {
+            static auto* registry = new __BlockRegistry();
+            return *registry;
+        }
+
+        static void __format_2digits(char* out, unsigned value)
+        {
+            out[0] = static_cast<char>('0' + value / 10);
+            out[1] = static_cast<char>('0' + value % 10);
+        }
+
+        /* Seconds since the epoch from a clock which may lag by a tick. */
+        static int64_t __coarse_now()
+        {
+#if defined(CLOCK_REALTIME_COARSE)
+            timespec now;
+            clock_gettime(CLOCK_REALTIME_COARSE, &now);
+            return now.tv_sec;
+#else
+            return static_cast<int64_t>(std::time(nullptr));
+#endif
+        }
+
+        static constexpr std::string_view __date_prefix = "Date: ";
+
+        struct __DateCache
+        {
+            int64_t second = INT64_MIN;
+            char    line[__date_prefix.size() + http_date_length + 2];
+        };
+
+        static __DateCache& __date_cache()
+        {
+            thread_local __DateCache cache;
+            auto now = __coarse_now();
+            if (now != cache.second)
+            {
+                std::memcpy(cache.line, __date_prefix.data(), __date_prefix.size());
+                format_http_date(cache.line + __date_prefix.size(), now);
+                std::memcpy(cache.line + __date_prefix.size() + http_date_length, "\r\n", 2);
+                cache.second = now;
+            }
+            return cache;
+        }
+
+        std::string_view __date_header_line()
+        {
+            return std::string_view(__date_cache().line, sizeof(__DateCache::line));
+        }
+    }
+
+    HeaderBlock register_header_block(std::initializer_list<Header> headers)
+    {
+        std::string lines;
+        for (const auto& header : headers)
+        {
+            lines.append(header.first);
+            lines.append(": ");
+            lines.append(header.second);
+            lines.append("\r\n");
+        }
+
+        auto& registry = detail::__block_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.blocks.push_front(std::move(lines));
+        return HeaderBlock(registry.blocks.front());
+    }
+
+    void format_http_date(char* out, int64_t seconds)
+    {
+        static constexpr char weekdays[] = "SunMonTueWedThuFriSat";
+        static constexpr char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+        int64_t days = seconds / 86400;
+        int64_t rest = seconds % 86400;
+        if (rest < 0)
+        {
+            rest += 86400;
+            --days;
+        }
+
+        /* Civil date from days since 1970-01-01, see H. Hinnant's date algorithms. */
+        int64_t z = days + 719468;
+        int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+        auto doe = static_cast<unsigned>(z - era * 146097);
+        unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        unsigned mp = (5 * doy + 2) / 153;
+        unsigned day = doy - (153 * mp + 2) / 5 + 1;
+        unsigned month = mp < 10 ? mp + 3 : mp - 9;
+        auto year = static_cast<unsigned>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+
+        /* 1970-01-01 was a Thursday. */
+        auto weekday = static_cast<unsigned>(((days % 7) + 11) % 7);
+
+        std::memcpy(out, weekdays + weekday * 3, 3);
+        std::memcpy(out + 3, ", ", 2);
+        detail::__format_2digits(out + 5, day);
+        out[7] = ' ';
+        std::memcpy(out + 8, months + (month - 1) * 3, 3);
+        out[11] = ' ';
+        detail::__format_2digits(out + 12, year / 100 % 100);
+        detail::__format_2digits(out + 14, year % 100);
+        out[16] = ' ';
+        detail::__format_2digits(out + 17, static_cast<unsigned>(rest / 3600));
+        out[19] = ':';
+        detail::__format_2digits(out + 20, static_cast<unsigned>(rest / 60 % 60));
+        out[22] = ':';
+        detail::__format_2digits(out + 23, static_cast<unsigned>(rest % 60));
+        std::memcpy(out + 25, " GMT", 4);
+    }
+
+    std::string_view http_date()
+    {
+        return detail::__date_header_line().substr(detail::__date_prefix.size(), http_date_length);
+    }
+}
@@ -0,0 +1,306 @@
+#include <llhttplus/response_writer.hpp>
+
+#if !defined(_WIN32)
+#include <cstdint>
+
+namespace llhttplus
+{
+    namespace detail
+    {
+        /* Returns the preformatted status line of a common status code. */
+        static std::string_view __status_line(int code)
+        {
+            switch (code)
+            {
+            case 100: return "HTTP/1.1 100 Continue\r\n";
+            case 101: return "HTTP/1.1 101 Switching Protocols\r\n";
+            case 200: return "HTTP/1.1 200 OK\r\n";
+            case 201: return "HTTP/1.1 201 Created\r\n";
+            case 202: return "HTTP/1.1 202 Accepted\r\n";
+            case 204: return "HTTP/1.1 204 No Content\r\n";
+            case 206: return "HTTP/1.1 206 Partial Content\r\n";
+            case 301: return "HTTP/1.1 301 Moved Permanently\r\n";
+            case 302: return "HTTP/1.1 302 Found\r\n";
+            case 303: return "HTTP/1.1 303 See Other\r\n";
+            case 304: return "HTTP/1.1 304 Not Modified\r\n";
+            case 307: return "HTTP/1.1 307 Temporary Redirect\r\n";
+            case 308: return "HTTP/1.1 308 Permanent Redirect\r\n";
+            case 400: return "HTTP/1.1 400 Bad Request\r\n";
+            case 401: return "HTTP/1.1 401 Unauthorized\r\n";
+            case 403: return "HTTP/1.1 403 Forbidden\r\n";
+            case 404: return "HTTP/1.1 404 Not Found\r\n";
+            case 405: return "HTTP/1.1 405 Method Not Allowed\r\n";
+            case 408: return "HTTP/1.1 408 Request Timeout\r\n";
+            case 409: return "HTTP/1.1 409 Conflict\r\n";
+            case 410: return "HTTP/1.1 410 Gone\r\n";
+            case 411: return "HTTP/1.1 411 Length Required\r\n";
+            case 412: return "HTTP/1.1 412 Precondition Failed\r\n";
+            case 413: return "HTTP/1.1 413 Content Too Large\r\n";
+            case 414: return "HTTP/1.1 414 URI Too Long\r\n";
+            case 415: return "HTTP/1.1 415 Unsupported Media Type\r\n";
+            case 416: return "HTTP/1.1 416 Range Not Satisfiable\r\n";
+            case 417: return "HTTP/1.1 417 Expectation Failed\r\n";
+            case 426: return "HTTP/1.1 426 Upgrade Required\r\n";
+            case 429: return "HTTP/1.1 429 Too Many Requests\r\n";
+            case 431: return "HTTP/1.1 431 Request Header Fields Too Large\r\n";
+            case 500: return "HTTP/1.1 500 Internal Server Error\r\n";
+            case 501: return "HTTP/1.1 501 Not Implemented\r\n";
+            case 502: return "HTTP/1.1 502 Bad Gateway\r\n";
+            case 503: return "HTTP/1.1 503 Service Unavailable\r\n";
+            case 504: return "HTTP/1.1 504 Gateway Timeout\r\n";
+            default: return std::string_view();
+            }
+        }
+
+        /* Writes `value` in decimal right-aligned before `end`; returns the
+         * first digit.
+         */
+        static char* __format_decimal(char* end, uint64_t value)
+        {
+            static constexpr char digits[] =
+                "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                "8081828384858687888990919293949596979899";
+
+            char* p = end;
+            while (value >= 100)
+            {
+                auto pair = static_cast<size_t>(value % 100) * 2;
+                value /= 100;
+                *--p = digits[pair + 1];
+                *--p = digits[pair];
+            }
+            if (value >= 10)
+            {
+                auto pair = static_cast<size_t>(value) * 2;
+                *--p = digits[pair + 1];
+                *--p = digits[pair];
+            }
+            else
+            {
+                *--p = static_cast<char>('0' + value);
+            }
+            return p;
+        }
+
+        static char* __format_hex(char* end, uint64_t value)
+        {
+            char* p = end;
+            do
+            {
+                *--p = "0123456789abcdef"[value & 0xf];
+                value >>= 4;
+            } while (value != 0);
+            return p;
+        }
+    }
+
+    ResponseWriter::ResponseWriter(std::pmr::memory_resource* resource)
+        : _buffer(resource)
+        , _iov(resource)
+    {
+        _buffer.reserve(512);
+        _iov.reserve(8);
+    }
+
+    void ResponseWriter::status(int code, std::string_view reason)
+    {
+        auto line = reason.empty() ? detail::__status_line(code) : std::string_view();
+        if (!line.empty())
+        {
+            __append(line);
+            return;
+        }
+
+        char digits[20];
+        char* end = digits + sizeof(digits);
+        char* begin = detail::__format_decimal(end, static_cast<uint64_t>(code < 0 ? 0 : code));
+        __append("HTTP/1.1 ");
+        __append(begin, end - begin);
+        __append(" ");
+        __append(reason);
+        __append("\r\n");
+    }
+
+    void ResponseWriter::header(std::string_view name, std::string_view value)
+    {
+        __append(name);
+        __append(": ");
+        __append(value);
+        __append("\r\n");
+    }
+
+    void ResponseWriter::header(std::string_view name, uint64_t value)
+    {
+        char digits[20];
+        char* end = digits + sizeof(digits);
+        char* begin = detail::__format_decimal(end, value);
+        header(name, std::string_view(begin, end - begin));
+    }
+
+    void ResponseWriter::header(const HeaderBlock& block)
+    {
+        __reference(block.lines().data(), block.lines().size());
+    }
+
+    void ResponseWriter::date()
+    {
+        __append(detail::__date_header_line());
+    }
+
+    void ResponseWriter::end_headers()
+    {
+        __append("\r\n");
+    }
+
+    void ResponseWriter::body(const void* data, size_t length)
+    {
+        header("Content-Length", static_cast<uint64_t>(length));
+        end_headers();
+        __reference(data, length);
+    }
+
+    void ResponseWriter::body(const iovec* parts, size_t count)
+    {
+        size_t length = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            length += parts[i].iov_len;
+        }
+
+        header("Content-Length", static_cast<uint64_t>(length));
+        end_headers();
+        for (size_t i = 0; i < count; ++i)
+        {
+            __reference(parts[i].iov_base, parts[i].iov_len);
+        }
+    }
+
+    void ResponseWriter::copy_body(const void* data, size_t length)
+    {
+        header("Content-Length", static_cast<uint64_t>(length));
+        end_headers();
+        __append(static_cast<const char*>(data), length);
+    }
+
+    void ResponseWriter::begin_chunked()
+    {
+        __append("Transfer-Encoding: chunked\r\n\r\n");
+    }
+
+    void ResponseWriter::chunk(const void* data, size_t length)
+    {
+        if (length == 0)
+        {
+            return;
+        }
+
+        char digits[16];
+        char* end = digits + sizeof(digits);
+        char* begin = detail::__format_hex(end, length);
+        __append(begin, end - begin);
+        __append("\r\n");
+        __reference(data, length);
+        __append("\r\n");
+    }
+
+    void ResponseWriter::end_chunked(std::string_view trailers)
+    {
+        __append("0\r\n");
+        __append(trailers);
+        __append("\r\n");
+    }
+
+    const iovec* ResponseWriter::data() const
+    {
+        return _iov.data() + _first;
+    }
+
+    size_t ResponseWriter::size() const
+    {
+        return _iov.size() - _first;
+    }
+
+    size_t ResponseWriter::bytes() const
+    {
+        return _bytes;
+    }
+
+    void ResponseWriter::consume(size_t written)
+    {
+        if (written >= _bytes)
+        {
+            _buffer.clear();
+            _iov.clear();
+            _first = 0;
+            _bytes = 0;
+            _tail = false;
+            return;
+        }
+
+        _bytes -= written;
+        while (written >= _iov[_first].iov_len)
+        {
+            written -= _iov[_first].iov_len;
+            ++_first;
+        }
+        auto& partial = _iov[_first];
+        partial.iov_base = static_cast<char*>(partial.iov_base) + written;
+        partial.iov_len -= written;
+    }
+
+    void ResponseWriter::clear()
+    {
+        consume(_bytes);
+    }
+
+    void ResponseWriter::__append(const char* data, size_t length)
+    {
+        if (length == 0)
+        {
+            return;
+        }
+
+        const char* old_data = _buffer.data();
+        size_t old_size = _buffer.size();
+        _buffer.insert(_buffer.end(), data, data + length);
+
+        /* The buffer moved: point the entries referencing it at the new one. */
+        if (_buffer.data() != old_data)
+        {
+            auto old_begin = reinterpret_cast<uintptr_t>(old_data);
+            for (size_t i = _first; i < _iov.size(); ++i)
+            {
+                auto base = reinterpret_cast<uintptr_t>(_iov[i].iov_base);
+                if (base >= old_begin && base < old_begin + old_size)
+                {
+                    _iov[i].iov_base = _buffer.data() + (base - old_begin);
+                }
+            }
+        }
+
+        if (_tail)
+        {
+            _iov.back().iov_len += length;
+        }
+        else
+        {
+            _iov.push_back({ _buffer.data() + old_size, length });
+            _tail = true;
+        }
+        _bytes += length;
+    }
+
+    void ResponseWriter::__reference(const void* data, size_t length)
+    {
+        if (length == 0)
+        {
+            return;
+        }
+
+        _iov.push_back({ const_cast<void*>(data), length });
+        _tail = false;
+        _bytes += length;
+    }
+}
+#endif
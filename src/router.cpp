@@ -0,0 +1,316 @@
+#include <llhttplus/router.hpp>
+#include <llhttplus/url.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace llhttplus
+{
+    std::string_view RouteMatch::get(std::string_view name) const
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (params[i].name == name)
+            {
+                return params[i].value;
+            }
+        }
+        return std::string_view();
+    }
+
+    /* Node of the tree routes are inserted into; `compile()` flattens it. */
+    struct Router::BuildNode
+    {
+        Kind                                    kind = Kind::text;
+        std::string                             label;
+        int                                     route = -1;
+        std::vector<std::unique_ptr<BuildNode>> children;   // text children by first byte
+        std::unique_ptr<BuildNode>              param;
+        std::unique_ptr<BuildNode>              wildcard;
+    };
+
+    /* Returns true if `pattern[i]` starts a `:name` or `*name` segment. */
+    static bool __capture_at(std::string_view pattern, size_t i)
+    {
+        return (pattern[i] == ':' || pattern[i] == '*') && pattern[i - 1] == '/';
+    }
+
+    static bool __valid_pattern(std::string_view pattern)
+    {
+        if (pattern.empty() || pattern[0] != '/')
+        {
+            return false;
+        }
+
+        size_t captures = 0;
+        for (size_t i = 1; i < pattern.size(); ++i)
+        {
+            if (!__capture_at(pattern, i))
+            {
+                continue;
+            }
+
+            size_t end = std::min(pattern.find('/', i), pattern.size());
+            if (end == i + 1 || ++captures > max_route_params
+                || (pattern[i] == '*' && end != pattern.size()))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Router::Router()
+    {
+        std::fill(std::begin(_roots), std::end(_roots), -1);
+    }
+
+    Router::~Router() = default;
+
+    int Router::add(llhttp_method_t method, std::string_view pattern)
+    {
+        if (static_cast<size_t>(method) >= __method_count || !__valid_pattern(pattern))
+        {
+            return -1;
+        }
+
+        auto& tree = _trees[method];
+        if (tree == nullptr)
+        {
+            tree = std::make_unique<BuildNode>();
+        }
+
+        int route = static_cast<int>(_routes);
+        if (!__insert(tree.get(), pattern, route))
+        {
+            return -1;
+        }
+        ++_routes;
+        return route;
+    }
+
+    bool Router::__insert(BuildNode* node, std::string_view pattern, int route)
+    {
+        size_t pos = 0;
+        while (pos < pattern.size())
+        {
+            if (pos > 0 && __capture_at(pattern, pos))
+            {
+                size_t end = std::min(pattern.find('/', pos), pattern.size());
+                std::string_view name = pattern.substr(pos + 1, end - pos - 1);
+                auto& child = pattern[pos] == ':' ? node->param : node->wildcard;
+                if (child == nullptr)
+                {
+                    child = std::make_unique<BuildNode>();
+                    child->kind = pattern[pos] == ':' ? Kind::param : Kind::wildcard;
+                    child->label = name;
+                }
+                else if (child->label != name)
+                {
+                    return false;
+                }
+                node = child.get();
+                pos = end;
+                continue;
+            }
+
+            /* Text up to the next capture. */
+            size_t cut = pos + 1;
+            while (cut < pattern.size() && !__capture_at(pattern, cut))
+            {
+                ++cut;
+            }
+            std::string_view text = pattern.substr(pos, cut - pos);
+
+            auto& children = node->children;
+            auto it = std::lower_bound(children.begin(), children.end(), text[0],
+                [](const std::unique_ptr<BuildNode>& child, char c) { return child->label[0] < c; });
+            if (it == children.end() || (*it)->label[0] != text[0])
+            {
+                it = children.insert(it, std::make_unique<BuildNode>());
+                (*it)->label = text;
+                node = it->get();
+                pos = cut;
+                continue;
+            }
+
+            size_t common = 1;
+            const std::string& label = (*it)->label;
+            while (common < label.size() && common < text.size() && label[common] == text[common])
+            {
+                ++common;
+            }
+
+            if (common < label.size())
+            {
+                /* Split the child at the end of the common prefix. */
+                auto middle = std::make_unique<BuildNode>();
+                middle->label = label.substr(0, common);
+                (*it)->label.erase(0, common);
+                middle->children.push_back(std::move(*it));
+                *it = std::move(middle);
+            }
+            node = it->get();
+            pos += common;
+        }
+
+        if (node->route >= 0)
+        {
+            return false;
+        }
+        node->route = route;
+        return true;
+    }
+
+    void Router::compile()
+    {
+        _nodes.clear();
+        _keys.clear();
+        _labels.clear();
+        for (size_t method = 0; method < __method_count; ++method)
+        {
+            _roots[method] = -1;
+            if (_trees[method] != nullptr)
+            {
+                _roots[method] = static_cast<int32_t>(_nodes.size());
+                _nodes.emplace_back();
+                _keys.emplace_back();
+                __flatten(*_trees[method], _roots[method]);
+            }
+        }
+    }
+
+    void Router::__flatten(const BuildNode& node, uint32_t index)
+    {
+        auto label = static_cast<uint32_t>(_labels.size());
+        _labels += node.label;
+
+        /* Text children are contiguous, so they can be searched by `_keys`. */
+        auto first = static_cast<uint32_t>(_nodes.size());
+        _nodes.resize(first + node.children.size());
+        _keys.resize(_nodes.size());
+        _nodes[index] = { label, static_cast<uint16_t>(node.label.size()), static_cast<uint16_t>(node.children.size()),
+            first, -1, -1, node.route, node.kind };
+        _keys[index] = node.kind == Kind::text && !node.label.empty() ? node.label[0] : 0;
+
+        for (size_t i = 0; i < node.children.size(); ++i)
+        {
+            __flatten(*node.children[i], first + static_cast<uint32_t>(i));
+        }
+
+        for (auto* child : { node.param.get(), node.wildcard.get() })
+        {
+            if (child != nullptr)
+            {
+                auto at = static_cast<int32_t>(_nodes.size());
+                _nodes.emplace_back();
+                _keys.emplace_back();
+                __flatten(*child, at);
+                (child == node.param.get() ? _nodes[index].param : _nodes[index].wildcard) = at;
+            }
+        }
+    }
+
+    RouteMatch Router::match(llhttp_method_t method, std::string_view url) const
+    {
+        RouteMatch match;
+        if (static_cast<size_t>(method) < __method_count && _roots[method] >= 0)
+        {
+            auto path = UrlView(url).path();
+            __match(_roots[method], path.data(), path.data() + path.size(), &match);
+        }
+        return match;
+    }
+
+    bool Router::__match(uint32_t index, const char* p, const char* end, RouteMatch* match) const
+    {
+        size_t captured = match->size;
+        for (;;)
+        {
+            const Node& node = _nodes[index];
+            std::string_view label(_labels.data() + node.label, node.label_length);
+            switch (node.kind)
+            {
+            case Kind::text:
+                if (static_cast<size_t>(end - p) < label.size() || std::memcmp(p, label.data(), label.size()) != 0)
+                {
+                    match->size = captured;
+                    return false;
+                }
+                p += label.size();
+                break;
+
+            case Kind::param:
+            {
+                auto* slash = static_cast<const char*>(std::memchr(p, '/', end - p));
+                const char* stop = slash != nullptr ? slash : end;
+                if (stop == p)
+                {
+                    match->size = captured;
+                    return false;
+                }
+                match->params[match->size++] = { label, std::string_view(p, stop - p) };
+                p = stop;
+                break;
+            }
+
+            case Kind::wildcard:
+                match->params[match->size++] = { label, std::string_view(p, end - p) };
+                p = end;
+                break;
+            }
+
+            if (p == end)
+            {
+                if (node.route >= 0)
+                {
+                    match->route = node.route;
+                    return true;
+                }
+            }
+            else
+            {
+                const char* keys = _keys.data() + node.first_child;
+                const char* key = std::lower_bound(keys, keys + node.children, *p);
+                if (key != keys + node.children && *key == *p)
+                {
+                    auto child = node.first_child + static_cast<uint32_t>(key - keys);
+                    if (node.param < 0 && node.wildcard < 0)
+                    {
+                        /* Nothing to fall back to: descend without recursing. */
+                        index = child;
+                        continue;
+                    }
+                    if (__match(child, p, end, match))
+                    {
+                        return true;
+                    }
+                }
+
+                if (node.param >= 0)
+                {
+                    if (node.wildcard < 0)
+                    {
+                        index = node.param;
+                        continue;
+                    }
+                    if (__match(node.param, p, end, match))
+                    {
+                        return true;
+                    }
+                }
+            }
+
+            if (node.wildcard < 0)
+            {
+                match->size = captured;
+                return false;
+            }
+            index = node.wildcard;
+        }
+    }
+
+    size_t Router::size() const
+    {
+        return _routes;
+    }
+}
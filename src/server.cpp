@@ -0,0 +1,278 @@
+#include <llhttplus/server_loop.hpp>
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace llhttplus
+{
+    namespace detail
+    {
+        /* Opens a non-blocking listening socket which shares `port` with the
+         * sockets of the other loops. Returns 0 or errno.
+         */
+        static int __listen(const ServerOptions& options, uint16_t port, int* fd_out)
+        {
+            sockaddr_storage address;
+            std::memset(&address, 0, sizeof(address));
+            socklen_t length;
+
+            auto* v4 = reinterpret_cast<sockaddr_in*>(&address);
+            auto* v6 = reinterpret_cast<sockaddr_in6*>(&address);
+            if (::inet_pton(AF_INET, options.address.c_str(), &v4->sin_addr) == 1)
+            {
+                v4->sin_family = AF_INET;
+                v4->sin_port = htons(port);
+                length = sizeof(sockaddr_in);
+            }
+            else if (::inet_pton(AF_INET6, options.address.c_str(), &v6->sin6_addr) == 1)
+            {
+                v6->sin6_family = AF_INET6;
+                v6->sin6_port = htons(port);
+                length = sizeof(sockaddr_in6);
+            }
+            else
+            {
+                return EINVAL;
+            }
+
+            int fd = ::socket(address.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (fd < 0)
+            {
+                return errno;
+            }
+
+            int one = 1;
+            if (::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0
+                || ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) != 0
+                || ::bind(fd, reinterpret_cast<sockaddr*>(&address), length) != 0
+                || ::listen(fd, options.backlog) != 0)
+            {
+                int err = errno;
+                ::close(fd);
+                return err;
+            }
+            *fd_out = fd;
+            return 0;
+        }
+
+        static uint16_t __local_port(int fd)
+        {
+            sockaddr_storage address;
+            socklen_t length = sizeof(address);
+            if (::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0)
+            {
+                return 0;
+            }
+            if (address.ss_family == AF_INET6)
+            {
+                return ntohs(reinterpret_cast<sockaddr_in6*>(&address)->sin6_port);
+            }
+            return ntohs(reinterpret_cast<sockaddr_in*>(&address)->sin_port);
+        }
+
+        int __check_uring_options(const ServerOptions& options)
+        {
+            size_t count = options.io_uring_buffers;
+            if (count == 0 || count > 32768 || (count & (count - 1)) != 0
+                || options.io_uring_buffer_size == 0 || options.io_uring_buffer_size > UINT32_MAX)
+            {
+                return EINVAL;
+            }
+            return 0;
+        }
+    
+        __ServerLoop::__ServerLoop(const ServerOptions& options, const Handler& handler)
+            : _options(options)
+            , _handler(handler)
+        {
+        }
+
+        __ServerLoop::~__ServerLoop()
+        {
+            if (_listen_fd >= 0)
+            {
+                ::close(_listen_fd);
+            }
+        }
+
+        void __ServerLoop::start(int cpu)
+        {
+            _thread = std::thread([this] { __run(); });
+            if (cpu >= 0)
+            {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpu, &set);
+                ::pthread_setaffinity_np(_thread.native_handle(), sizeof(set), &set);
+            }
+        }
+
+        void __ServerLoop::stop()
+        {
+            if (_thread.joinable())
+            {
+                __wake();
+                _thread.join();
+            }
+        }
+
+        size_t __ServerLoop::__handle(Connection& connection, ResponseWriter& writer, bool* closing)
+        {
+            if (*closing)
+            {
+                return 0;
+            }
+
+            size_t handled = 0;
+            while (writer.bytes() < _options.max_pending_output)
+            {
+                CompactRequest* request = connection.next();
+                if (request == nullptr)
+                {
+                    if (connection.error() != HPE_OK)
+                    {
+                        __reject(writer, 400);
+                        *closing = true;
+                        ++handled;
+                    }
+                    else if (!connection.keep_alive())
+                    {
+                        *closing = true;
+                    }
+                    break;
+                }
+
+                _handler(*request, writer);
+                connection.pop();
+                ++handled;
+            }
+            return handled;
+        }
+
+        void __ServerLoop::__reject(ResponseWriter& writer, int code)
+        {
+            writer.status(code);
+            writer.date();
+            writer.header(header_blocks::connection_close);
+            writer.copy_body(nullptr, 0);
+        }
+    }
+
+    Server::Server(ServerOptions options, Handler handler)
+        : _options(std::move(options))
+        , _handler(std::move(handler))
+    {
+    }
+
+    Server::~Server()
+    {
+        stop();
+    }
+
+    int Server::start()
+    {
+        if (!_loops.empty())
+        {
+            return EALREADY;
+        }
+        if (_options.io_uring)
+        {
+            if (int err = detail::__check_uring_options(_options))
+            {
+                return err;
+            }
+        }
+
+        size_t cpus = std::max(std::thread::hardware_concurrency(), 1u);
+        size_t count = _options.threads != 0 ? _options.threads : cpus;
+        uint16_t port = _options.port;
+
+        std::vector<std::unique_ptr<detail::__ServerLoop>> loops;
+        loops.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            int fd = -1;
+            int err = detail::__listen(_options, port, &fd);
+            if (err != 0)
+            {
+                return err;
+            }
+
+            /* The first socket picks the port the others share. */
+            if (port == 0)
+            {
+                port = detail::__local_port(fd);
+            }
+
+            std::unique_ptr<detail::__ServerLoop> loop;
+#if defined(LLHTTPLUS_IO_URING)
+            /* Falls back to epoll only where io_uring is unavailable: a kernel
+             * without it or too old, or io_uring disabled by policy. Any other
+             * error fails like one of epoll.
+             */
+            if (_options.io_uring)
+            {
+                loop = detail::__make_uring_loop(_options, _handler);
+                err = loop->open(fd);
+                if (err == ENOSYS || err == EPERM || err == EACCES || err == EOPNOTSUPP)
+                {
+                    loop.reset();
+                }
+                else if (err != 0)
+                {
+                    ::close(fd);
+                    return err;
+                }
+            }
+#endif
+            if (loop == nullptr)
+            {
+                loop = detail::__make_epoll_loop(_options, _handler);
+                err = loop->open(fd);
+                if (err != 0)
+                {
+                    ::close(fd);
+                    return err;
+                }
+            }
+            loops.push_back(std::move(loop));
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            loops[i]->start(_options.pin_threads ? static_cast<int>(i % cpus) : -1);
+        }
+        _loops = std::move(loops);
+        _port = port;
+        return 0;
+    }
+
+    void Server::stop()
+    {
+        _loops.clear();
+    }
+
+    uint16_t Server::port() const
+    {
+        return _port;
+    }
+
+    size_t Server::threads() const
+    {
+        return _loops.size();
+    }
+
+    const char* Server::backend() const
+    {
+        return _loops.empty() ? "" : _loops.front()->backend();
+    }
+}
+#endif
@@ -0,0 +1,367 @@
+#include <llhttplus/server_loop.hpp>
+
+#if defined(__linux__)
+#include <limits.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace llhttplus
+{
+    namespace detail
+    {
+        /* Smallest free space to receive into. */
+        static constexpr size_t __min_receive = 4096;
+
+        /* Connections accepted per wakeup; the listening socket is
+         * level-triggered, so the rest is accepted on the next one.
+         */
+        static constexpr int __accept_batch = 64;
+
+        static constexpr int __max_events = 256;
+
+        /*
+         * epoll backend: an epoll instance, a listening socket and a pool of
+         * sessions. Only the loop thread touches its members after `start()`,
+         * except for the eventfd which `__wake()` signals.
+         */
+        class __EpollLoop final : public __ServerLoop
+        {
+        public:
+            __EpollLoop(const ServerOptions& options, const Handler& handler)
+                : __ServerLoop(options, handler)
+            {
+            }
+
+            ~__EpollLoop() override
+            {
+                stop();
+                for (int fd : { _epoll_fd, _event_fd })
+                {
+                    if (fd >= 0)
+                    {
+                        ::close(fd);
+                    }
+                }
+            }
+
+            /* Creates the epoll instance and registers the listening socket and
+             * the stop eventfd. Returns 0 or errno.
+             */
+            int open(int listen_fd) override
+            {
+                _epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+                _event_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+                if (_epoll_fd < 0 || _event_fd < 0)
+                {
+                    return errno;
+                }
+
+                epoll_event event;
+                event.events = EPOLLIN;
+                event.data.ptr = &_listen_fd;
+                if (::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, listen_fd, &event) != 0)
+                {
+                    return errno;
+                }
+                event.data.ptr = &_event_fd;
+                if (::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event) != 0)
+                {
+                    return errno;
+                }
+                _listen_fd = listen_fd;
+                return 0;
+            }
+
+            const char* backend() const override
+            {
+                return "epoll";
+            }
+
+        private:
+            struct Session
+            {
+                explicit Session(const ServerOptions& options)
+                    : connection(options.receive_capacity, options.max_request_size, options.max_pipelined)
+                {
+                }
+
+                Connection      connection;
+                ResponseWriter  writer;
+                int             fd = -1;
+                bool            readable = false;   // the socket may have unread bytes
+                bool            closing = false;    // close once the output is written
+            };
+
+            void __wake() override
+            {
+                uint64_t one = 1;
+                (void)!::write(_event_fd, &one, sizeof(one));
+            }
+
+            void __run() override
+            {
+                epoll_event events[__max_events];
+                bool stopping = false;
+                while (!stopping)
+                {
+                    int count = ::epoll_wait(_epoll_fd, events, __max_events, -1);
+                    if (count < 0)
+                    {
+                        if (errno == EINTR)
+                        {
+                            continue;
+                        }
+                        break;
+                    }
+
+                    for (int i = 0; i < count; ++i)
+                    {
+                        void* tag = events[i].data.ptr;
+                        if (tag == &_listen_fd)
+                        {
+                            __accept();
+                            continue;
+                        }
+                        if (tag == &_event_fd)
+                        {
+                            stopping = true;
+                            continue;
+                        }
+
+                        auto* session = static_cast<Session*>(tag);
+                        if (session->fd < 0)
+                        {
+                            continue;   // closed earlier in this batch
+                        }
+                        if (events[i].events & (EPOLLERR | EPOLLHUP))
+                        {
+                            __close(session);
+                            continue;
+                        }
+                        if (events[i].events & (EPOLLIN | EPOLLRDHUP))
+                        {
+                            session->readable = true;
+                        }
+                        __drive(session);
+                    }
+
+                    /* Stale events may still name sessions closed in this batch,
+                     * so they are only reused from the next one on.
+                     */
+                    _free.insert(_free.end(), _closed.begin(), _closed.end());
+                    _closed.clear();
+                }
+
+                for (auto& session : _sessions)
+                {
+                    if (session->fd >= 0)
+                    {
+                        __close(session.get());
+                    }
+                }
+                _closed.clear();
+            }
+
+            void __accept()
+            {
+                for (int i = 0; i < __accept_batch; ++i)
+                {
+                    int fd = ::accept4(_listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (fd < 0)
+                    {
+                        if (errno == EINTR || errno == ECONNABORTED)
+                        {
+                            continue;
+                        }
+                        return;
+                    }
+
+                    int one = 1;
+                    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+                    Session* session = __acquire();
+                    session->fd = fd;
+
+                    epoll_event event;
+                    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+                    event.data.ptr = session;
+                    if (::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+                    {
+                        __close(session);
+                    }
+                }
+            }
+
+            Session* __acquire()
+            {
+                if (_free.empty())
+                {
+                    _sessions.push_back(std::make_unique<Session>(_options));
+                    return _sessions.back().get();
+                }
+                Session* session = _free.back();
+                _free.pop_back();
+                return session;
+            }
+
+            /* Handles, writes and reads in turn until none of them progresses or
+             * the session is closed.
+             */
+            void __drive(Session* session)
+            {
+                for (;;)
+                {
+                    bool progress = __handle(session->connection, session->writer, &session->closing) > 0;
+                    size_t pending = session->writer.bytes();
+                    if (!__flush(session))
+                    {
+                        return;
+                    }
+
+                    /* Output held back `__handle()`, which may now go on. */
+                    progress = progress || session->writer.bytes() < pending;
+
+                    if (session->readable && !session->closing
+                        && session->writer.bytes() < _options.max_pending_output)
+                    {
+                        int received = __receive(session);
+                        if (received < 0)
+                        {
+                            return;
+                        }
+                        progress = progress || received > 0;
+                    }
+
+                    if (!progress)
+                    {
+                        break;
+                    }
+                }
+
+                if (session->closing && session->writer.bytes() == 0)
+                {
+                    ::shutdown(session->fd, SHUT_WR);
+                    __close(session);
+                }
+            }
+
+            /* Receives once. Returns 1 if bytes or EOF arrived, 0 if there was
+             * nothing to read, or -1 if the session was closed.
+             */
+            int __receive(Session* session)
+            {
+                auto& connection = session->connection;
+                auto region = connection.prepare(__min_receive);
+                if (region.size == 0)
+                {
+                    /* The message in progress fills `max_request_size`. */
+                    __reject(session->writer, 413);
+                    session->closing = true;
+                    return 1;
+                }
+
+                ssize_t received;
+                do
+                {
+                    received = ::recv(session->fd, region.data, region.size, 0);
+                } while (received < 0 && errno == EINTR);
+
+                if (received > 0)
+                {
+                    connection.commit(static_cast<size_t>(received));
+
+                    /* A short read drained the socket: edge-triggered epoll reports
+                     * the next bytes as a new event.
+                     */
+                    if (static_cast<size_t>(received) < region.size)
+                    {
+                        session->readable = false;
+                    }
+                    return 1;
+                }
+                if (received == 0)
+                {
+                    /* Requests are never terminated by EOF; the remaining output
+                     * is still written before closing.
+                     */
+                    session->readable = false;
+                    if (connection.finish() != nullptr)
+                    {
+                        connection.pop();
+                    }
+                    return 1;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    session->readable = false;
+                    return 0;
+                }
+                __close(session);
+                return -1;
+            }
+
+            /* Writes as much output as the socket takes. Returns false if the
+             * session was closed.
+             */
+            bool __flush(Session* session)
+            {
+                auto& writer = session->writer;
+                while (writer.bytes() > 0)
+                {
+                    msghdr message;
+                    std::memset(&message, 0, sizeof(message));
+                    message.msg_iov = const_cast<iovec*>(writer.data());
+                    message.msg_iovlen = std::min<size_t>(writer.size(), IOV_MAX);
+
+                    ssize_t sent = ::sendmsg(session->fd, &message, MSG_NOSIGNAL);
+                    if (sent >= 0)
+                    {
+                        writer.consume(static_cast<size_t>(sent));
+                        continue;
+                    }
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    {
+                        return true;    // resumed on EPOLLOUT
+                    }
+                    __close(session);
+                    return false;
+                }
+                return true;
+            }
+
+            void __close(Session* session)
+            {
+                ::close(session->fd);
+                session->fd = -1;
+                session->readable = false;
+                session->closing = false;
+                session->connection.reset();
+                session->writer.clear();
+                _closed.push_back(session);
+            }
+
+            int                                     _epoll_fd = -1;
+            int                                     _event_fd = -1;
+            std::vector<std::unique_ptr<Session>>   _sessions;  // every session this loop created
+            std::vector<Session*>                   _free;
+            std::vector<Session*>                   _closed;    // closed during the current batch
+        };
+
+        std::unique_ptr<__ServerLoop> __make_epoll_loop(const ServerOptions& options, const Handler& handler)
+        {
+            return std::make_unique<__EpollLoop>(options, handler);
+        }
+    }
+}
+#endif
@@ -0,0 +1,675 @@
+#include <llhttplus/server_loop.hpp>
+
+#if defined(__linux__) && defined(LLHTTPLUS_IO_URING)
+#include <liburing.h>
+#include <limits.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace llhttplus
+{
+    namespace detail
+    {
+        static constexpr unsigned __ring_entries = 1024;
+
+        static constexpr int __buffer_group = 0;
+
+        /* Operation of a completion, in the low bits of its user data; the
+         * other bits hold the session, if any.
+         */
+        enum __UringOp : uint64_t
+        {
+            __op_accept = 0,
+            __op_receive = 1,
+            __op_send = 2,
+            __op_shutdown = 3,
+            __op_wake = 4,
+            __op_cancel = 5,
+        };
+
+        static constexpr uint64_t __op_mask = 7;
+
+        /* Multishot receive with provided buffer rings needs Linux 6.0. */
+        static bool __kernel_supports_uring()
+        {
+            utsname name;
+            int major = 0;
+            int minor = 0;
+            if (::uname(&name) != 0 || std::sscanf(name.release, "%d.%d", &major, &minor) != 2)
+            {
+                return false;
+            }
+            return major > 6 || (major == 6 && minor >= 0);
+        }
+
+        /*
+         * io_uring backend.
+         *
+         * One multishot accept yields the connections, and one multishot
+         * receive per connection picks buffers from a ring this loop provides
+         * to the kernel. Requests are parsed right in these buffers; a buffer
+         * returns to the ring once every request view into it is released,
+         * i.e. after its requests are answered. Only a message cut by the end
+         * of a buffer, or bytes arriving while a buffer is still held, are
+         * copied into the connection's own `Connection` buffer, until that one
+         * is drained again.
+         *
+         * Each connection has at most one send in flight, so the writer's
+         * buffers stay put until it completes. The last send before closing
+         * is linked to the shutdown of the socket.
+         */
+        class __UringLoop final : public __ServerLoop
+        {
+        public:
+            __UringLoop(const ServerOptions& options, const Handler& handler)
+                : __ServerLoop(options, handler)
+            {
+            }
+
+            ~__UringLoop() override
+            {
+                stop();
+                if (_ring_ready)
+                {
+                    if (_buffer_ring != nullptr)
+                    {
+                        ::io_uring_free_buf_ring(&_ring, _buffer_ring, _buffer_count, __buffer_group);
+                    }
+                    ::io_uring_queue_exit(&_ring);
+                }
+                if (_event_fd >= 0)
+                {
+                    ::close(_event_fd);
+                }
+            }
+
+            /* Sets the ring and its provided buffers up. Returns 0 or errno,
+             * e.g. ENOSYS on kernels without the needed features, or EPERM
+             * where io_uring is disabled.
+             */
+            int open(int listen_fd) override
+            {
+                if (int err = __check_uring_options(_options))
+                {
+                    return err;
+                }
+                _buffer_count = static_cast<unsigned>(_options.io_uring_buffers);
+                _buffer_size = _options.io_uring_buffer_size;
+                if (!__kernel_supports_uring())
+                {
+                    return ENOSYS;
+                }
+
+                io_uring_params params;
+                std::memset(&params, 0, sizeof(params));
+                params.flags = IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN;
+                int err = ::io_uring_queue_init_params(__ring_entries, &_ring, &params);
+                if (err < 0)
+                {
+                    return -err;
+                }
+                _ring_ready = true;
+
+                _buffer_ring = ::io_uring_setup_buf_ring(&_ring, _buffer_count, __buffer_group, 0, &err);
+                if (_buffer_ring == nullptr)
+                {
+                    return -err;
+                }
+                _buffers.reset(new char[_buffer_count * _buffer_size]);
+                for (unsigned i = 0; i < _buffer_count; ++i)
+                {
+                    __recycle(static_cast<int>(i));
+                }
+                __publish();
+
+                _event_fd = ::eventfd(0, EFD_CLOEXEC);
+                if (_event_fd < 0)
+                {
+                    return errno;
+                }
+                _listen_fd = listen_fd;
+                return 0;
+            }
+
+            const char* backend() const override
+            {
+                return "io_uring";
+            }
+
+        private:
+            struct Session
+            {
+                explicit Session(const ServerOptions& options)
+                    : connection(options.receive_capacity, options.max_request_size, options.max_pipelined)
+                {
+                    parser.pause_on_message_complete(true);
+                }
+
+                Connection      connection;     // bytes copied out of provided buffers
+                CompactParser   parser;         // parses a provided buffer in place
+                CompactRequest  request;
+                ResponseWriter  writer;
+                msghdr          message;
+                int             fd = -1;
+                int             buffer = -1;    // provided buffer being parsed in place
+                char*           at = nullptr;   // its next message
+                char*           end = nullptr;
+                size_t          in_flight = 0;  // operations with a completion to come
+                bool            receiving = false;
+                bool            sending = false;
+                bool            shutting = false;   // a linked shutdown is in flight
+                bool            eof = false;
+                bool            closing = false;    // close once the output is written
+            };
+
+            static uint64_t __tag(Session* session, __UringOp op)
+            {
+                return reinterpret_cast<uint64_t>(session) | op;
+            }
+
+            io_uring_sqe* __sqe()
+            {
+                io_uring_sqe* sqe = ::io_uring_get_sqe(&_ring);
+                if (sqe == nullptr)
+                {
+                    ::io_uring_submit(&_ring);
+                    sqe = ::io_uring_get_sqe(&_ring);
+                }
+                return sqe;
+            }
+
+            void __wake() override
+            {
+                uint64_t one = 1;
+                (void)!::write(_event_fd, &one, sizeof(one));
+            }
+
+            void __run() override
+            {
+                __arm_accept();
+                io_uring_sqe* sqe = __sqe();
+                ::io_uring_prep_poll_add(sqe, _event_fd, POLLIN);
+                ::io_uring_sqe_set_data64(sqe, __op_wake);
+
+                bool stopping = false;
+                while (!stopping)
+                {
+                    int err = ::io_uring_submit_and_wait(&_ring, 1);
+                    if (err < 0 && err != -EINTR && err != -EAGAIN && err != -EBUSY)
+                    {
+                        break;
+                    }
+
+                    unsigned head;
+                    unsigned count = 0;
+                    io_uring_cqe* cqe;
+                    io_uring_for_each_cqe(&_ring, head, cqe)
+                    {
+                        ++count;
+                        stopping = __complete(cqe) || stopping;
+                    }
+                    ::io_uring_cq_advance(&_ring, count);
+                    __after_batch();
+                }
+
+                for (auto& session : _sessions)
+                {
+                    if (session->fd >= 0)
+                    {
+                        ::close(session->fd);
+                        session->fd = -1;
+                    }
+                }
+            }
+
+            /* Dispatches one completion. Returns true on the stop signal. */
+            bool __complete(const io_uring_cqe* cqe)
+            {
+                uint64_t data = ::io_uring_cqe_get_data64(cqe);
+                auto* session = reinterpret_cast<Session*>(data & ~__op_mask);
+                bool more = (cqe->flags & IORING_CQE_F_MORE) != 0;
+
+                switch (static_cast<__UringOp>(data & __op_mask))
+                {
+                case __op_accept:
+                    if (cqe->res >= 0)
+                    {
+                        __open(cqe->res);
+                    }
+                    if (!more)
+                    {
+                        __arm_accept();
+                    }
+                    break;
+                case __op_receive:
+                    __on_receive(session, cqe, more);
+                    break;
+                case __op_send:
+                    --session->in_flight;
+                    session->sending = false;
+                    if (session->fd < 0)
+                    {
+                        break;
+                    }
+                    if (cqe->res < 0)
+                    {
+                        __close(session);
+                        break;
+                    }
+                    session->writer.consume(static_cast<size_t>(cqe->res));
+                    __pump(session);
+                    break;
+                case __op_shutdown:
+                    --session->in_flight;
+                    session->shutting = false;
+
+                    /* Cancelled by a short send: the rest of the output goes
+                     * out with a new shutdown linked to its last send. The send
+                     * completion may come first, which `shutting` held back.
+                     */
+                    if (cqe->res == -ECANCELED)
+                    {
+                        __pump(session);
+                        break;
+                    }
+                    __close(session);
+                    break;
+                case __op_wake:
+                    return true;
+                case __op_cancel:
+                    break;
+                }
+                return false;
+            }
+
+            void __on_receive(Session* session, const io_uring_cqe* cqe, bool more)
+            {
+                int buffer = -1;
+                if (cqe->flags & IORING_CQE_F_BUFFER)
+                {
+                    buffer = static_cast<int>(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+                }
+                if (!more)
+                {
+                    --session->in_flight;
+                    session->receiving = false;
+                }
+
+                if (session->fd < 0)
+                {
+                    __recycle(buffer);
+                    return;
+                }
+
+                if (cqe->res > 0)
+                {
+                    __on_data(session, buffer, static_cast<size_t>(cqe->res));
+                }
+                else if (cqe->res == 0)
+                {
+                    session->eof = true;
+                    __pump(session);
+                    return;
+                }
+                else if (cqe->res == -ENOBUFS)
+                {
+                    /* Every buffer is held: receive again once one returns. */
+                    _starved.push_back(session);
+                    return;
+                }
+                else
+                {
+                    __close(session);
+                    return;
+                }
+
+                if (!more && session->fd >= 0 && !session->closing)
+                {
+                    __arm_receive(session);
+                }
+            }
+
+            void __on_data(Session* session, int buffer, size_t size)
+            {
+                char* data = _buffers.get() + static_cast<size_t>(buffer) * _buffer_size;
+                if (session->buffer < 0 && session->connection.empty())
+                {
+                    session->buffer = buffer;
+                    session->at = data;
+                    session->end = data + size;
+                }
+                else
+                {
+                    /* Bytes queue behind those held: copy both. */
+                    __spill(session);
+                    __copy(session, data, size);
+                    __recycle(buffer);
+                }
+                __pump(session);
+            }
+
+            /* Handles what was received, then sends the output. */
+            void __pump(Session* session)
+            {
+                if (session->fd < 0)
+                {
+                    return;
+                }
+
+                /* The writer may only grow while no send references it. */
+                if (!session->sending && !session->closing)
+                {
+                    if (session->buffer >= 0)
+                    {
+                        __parse_in_place(session);
+                    }
+                    if (session->buffer < 0)
+                    {
+                        __handle(session->connection, session->writer, &session->closing);
+
+                        /* The message in progress fills `max_request_size`. */
+                        if (!session->closing && session->writer.bytes() < _options.max_pending_output
+                            && session->connection.prepare().size == 0)
+                        {
+                            __reject(session->writer, 413);
+                            session->closing = true;
+                        }
+                    }
+
+                    if (session->eof && session->buffer < 0 && !session->closing
+                        && session->writer.bytes() < _options.max_pending_output)
+                    {
+                        /* Requests are never terminated by EOF. */
+                        if (session->connection.finish() != nullptr)
+                        {
+                            session->connection.pop();
+                        }
+                        session->closing = true;
+                    }
+                }
+                __flush(session);
+            }
+
+            /* Answers the requests of the held buffer until the output backs
+             * up; a message cut by the end of the buffer is copied.
+             */
+            void __parse_in_place(Session* session)
+            {
+                auto& parser = session->parser;
+                while (session->at < session->end && session->writer.bytes() < _options.max_pending_output)
+                {
+                    session->request.rebase(session->at);
+                    auto err = parser.execute(&session->request, session->at, session->end - session->at);
+                    if (err == HPE_PAUSED)
+                    {
+                        session->at = const_cast<char*>(parser.get_error_pos());
+                        parser.resume();
+                        bool close = parser.get_upgrade() || !parser.should_keep_alive();
+                        _handler(session->request, session->writer);
+                        if (close)
+                        {
+                            session->closing = true;
+                            break;
+                        }
+                        continue;
+                    }
+
+                    if (err != HPE_OK)
+                    {
+                        __reject(session->writer, 400);
+                        session->closing = true;
+                        break;
+                    }
+
+                    /* The connection parses the message again from its start. */
+                    parser.reset();
+                    if (!session->eof)
+                    {
+                        __copy(session, session->at, session->end - session->at);
+                    }
+                    session->at = session->end;
+                }
+
+                if (session->at == session->end || session->closing)
+                {
+                    __recycle(session->buffer);
+                    session->buffer = -1;
+                }
+            }
+
+            /* Copies the rest of the held buffer and returns it to the ring. */
+            void __spill(Session* session)
+            {
+                if (session->buffer >= 0)
+                {
+                    __copy(session, session->at, session->end - session->at);
+                    __recycle(session->buffer);
+                    session->buffer = -1;
+                }
+            }
+
+            void __copy(Session* session, const char* data, size_t size)
+            {
+                auto& connection = session->connection;
+                while (size > 0 && !session->closing)
+                {
+                    auto region = connection.prepare(size);
+                    if (region.size == 0)
+                    {
+                        /* The message in progress fills `max_request_size`. */
+                        __reject(session->writer, 413);
+                        session->closing = true;
+                        break;
+                    }
+
+                    size_t copied = std::min(size, region.size);
+                    std::memcpy(region.data, data, copied);
+                    connection.commit(copied);
+                    data += copied;
+                    size -= copied;
+                }
+            }
+
+            void __flush(Session* session)
+            {
+                auto& writer = session->writer;
+                if (session->sending || session->shutting)
+                {
+                    return;
+                }
+                if (writer.bytes() == 0)
+                {
+                    if (session->closing)
+                    {
+                        __shutdown(session, nullptr);
+                    }
+                    return;
+                }
+
+                std::memset(&session->message, 0, sizeof(session->message));
+                session->message.msg_iov = const_cast<iovec*>(writer.data());
+                session->message.msg_iovlen = std::min<size_t>(writer.size(), IOV_MAX);
+                bool last = session->closing && session->message.msg_iovlen == writer.size();
+
+                io_uring_sqe* sqe = __sqe();
+                ::io_uring_prep_sendmsg(sqe, session->fd, &session->message, MSG_NOSIGNAL | (last ? MSG_WAITALL : 0));
+                ::io_uring_sqe_set_data64(sqe, __tag(session, __op_send));
+                session->sending = true;
+                ++session->in_flight;
+
+                if (last)
+                {
+                    __shutdown(session, sqe);
+                }
+            }
+
+            /* Shuts the socket down for writing, after `send` if given. */
+            void __shutdown(Session* session, io_uring_sqe* send)
+            {
+                if (send != nullptr)
+                {
+                    ::io_uring_sqe_set_flags(send, IOSQE_IO_LINK);
+                }
+                io_uring_sqe* sqe = __sqe();
+                ::io_uring_prep_shutdown(sqe, session->fd, SHUT_WR);
+                ::io_uring_sqe_set_data64(sqe, __tag(session, __op_shutdown));
+                session->shutting = true;
+                ++session->in_flight;
+            }
+
+            void __arm_accept()
+            {
+                io_uring_sqe* sqe = __sqe();
+                ::io_uring_prep_multishot_accept(sqe, _listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+                ::io_uring_sqe_set_data64(sqe, __op_accept);
+            }
+
+            void __arm_receive(Session* session)
+            {
+                io_uring_sqe* sqe = __sqe();
+                ::io_uring_prep_recv_multishot(sqe, session->fd, nullptr, 0, 0);
+                sqe->flags |= IOSQE_BUFFER_SELECT;
+                sqe->buf_group = __buffer_group;
+                ::io_uring_sqe_set_data64(sqe, __tag(session, __op_receive));
+                session->receiving = true;
+                ++session->in_flight;
+            }
+
+            void __open(int fd)
+            {
+                int one = 1;
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+                Session* session;
+                if (_free.empty())
+                {
+                    _sessions.push_back(std::make_unique<Session>(_options));
+                    session = _sessions.back().get();
+                }
+                else
+                {
+                    session = _free.back();
+                    _free.pop_back();
+                }
+                session->fd = fd;
+                __arm_receive(session);
+            }
+
+            /* Closes the socket and cancels what is in flight; the session is
+             * reused once the last completion arrived.
+             */
+            void __close(Session* session)
+            {
+                if (session->fd < 0)
+                {
+                    return;
+                }
+                for (auto op : { __op_receive, __op_send, __op_shutdown })
+                {
+                    io_uring_sqe* sqe = __sqe();
+                    ::io_uring_prep_cancel64(sqe, __tag(session, op), IORING_ASYNC_CANCEL_ALL);
+                    ::io_uring_sqe_set_data64(sqe, __tag(session, __op_cancel));
+                }
+                ::close(session->fd);
+                session->fd = -1;
+                __recycle(session->buffer);
+                session->buffer = -1;
+                _closed.push_back(session);
+            }
+
+            void __recycle(int buffer)
+            {
+                if (buffer < 0)
+                {
+                    return;
+                }
+                ::io_uring_buf_ring_add(
+                    _buffer_ring,
+                    _buffers.get() + static_cast<size_t>(buffer) * _buffer_size,
+                    static_cast<unsigned>(_buffer_size),
+                    static_cast<unsigned short>(buffer),
+                    ::io_uring_buf_ring_mask(_buffer_count),
+                    _recycled++
+                );
+            }
+
+            /* Hands the recycled buffers to the kernel. */
+            void __publish()
+            {
+                if (_recycled > 0)
+                {
+                    ::io_uring_buf_ring_advance(_buffer_ring, _recycled);
+                    _recycled = 0;
+                }
+            }
+
+            void __after_batch()
+            {
+                bool returned = _recycled > 0;
+                __publish();
+
+                if (returned && !_starved.empty())
+                {
+                    for (Session* session : _starved)
+                    {
+                        if (session->fd >= 0 && !session->receiving && !session->closing)
+                        {
+                            __arm_receive(session);
+                        }
+                    }
+                    _starved.clear();
+                }
+
+                /* Sessions wait for the completions of their cancelled
+                 * operations before they are reused.
+                 */
+                auto waiting = _closed.begin();
+                for (Session* session : _closed)
+                {
+                    if (session->in_flight > 0)
+                    {
+                        *waiting++ = session;
+                        continue;
+                    }
+                    session->connection.reset();
+                    session->parser.reset();
+                    session->writer.clear();
+                    session->eof = false;
+                    session->closing = false;
+                    _free.push_back(session);
+                }
+                _closed.erase(waiting, _closed.end());
+            }
+
+            io_uring                                _ring;
+            bool                                    _ring_ready = false;
+            io_uring_buf_ring*                      _buffer_ring = nullptr;
+            std::unique_ptr<char[]>                 _buffers;
+            unsigned                                _buffer_count = 0;
+            size_t                                  _buffer_size = 0;
+            int                                     _recycled = 0;  // buffers added since the last publish
+            int                                     _event_fd = -1;
+            std::vector<std::unique_ptr<Session>>   _sessions;  // every session this loop created
+            std::vector<Session*>                   _free;
+            std::vector<Session*>                   _closed;    // waiting for their last completions
+            std::vector<Session*>                   _starved;   // receive stopped for lack of buffers
+        };
+
+        std::unique_ptr<__ServerLoop> __make_uring_loop(const ServerOptions& options, const Handler& handler)
+        {
+            return std::make_unique<__UringLoop>(options, handler);
+        }
+    }
+}
+#endif
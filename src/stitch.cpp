@@ -0,0 +1,106 @@
+#include <llhttplus/stitch.hpp>
+#include <llhttplus/metrics.hpp>
+#include <cstring>
+
+namespace llhttplus
+{
+    Stitcher::Stitcher(Arena* arena)
+        : _arena(arena)
+    {
+    }
+
+    void Stitcher::append(std::string_view* target, const char* at, size_t length)
+    {
+        if (target != _target)
+        {
+            close();
+            _target = target;
+            *_target = std::string_view(at, length);
+            return;
+        }
+
+        if (_pending != nullptr)
+        {
+            if (_size + length > _capacity)
+            {
+                __reserve(_size + length > _capacity * 2 ? _size + length : _capacity * 2);
+            }
+            std::memcpy(_pending + _size, at, length);
+            _size += length;
+            *_target = std::string_view(_pending, _size);
+        }
+        else if (at == _target->data() + _target->size())
+        {
+            *_target = std::string_view(_target->data(), _target->size() + length);
+        }
+        else
+        {
+            *_target = std::string_view(at, length);
+        }
+    }
+
+    void Stitcher::append_in_place(std::string_view* target, char* at, size_t length)
+    {
+        if (target == _target && _pending == nullptr && at != _target->data() + _target->size())
+        {
+            auto* end = const_cast<char*>(_target->data() + _target->size());
+            std::memmove(end, at, length);
+            at = end;
+        }
+        append(target, at, length);
+    }
+
+    bool Stitcher::is_open(const std::string_view* target) const
+    {
+        return _target == target;
+    }
+
+    void Stitcher::close()
+    {
+        _target = nullptr;
+        _pending = nullptr;
+        _size = 0;
+        _capacity = 0;
+    }
+
+    void Stitcher::detach()
+    {
+        if (_target == nullptr || _pending != nullptr)
+        {
+            return;
+        }
+
+        _size = _target->size();
+        __reserve(_size * 2 > 64 ? _size * 2 : 64);
+        *_target = std::string_view(_pending, _size);
+        ++_count;
+        _LLHTTP_METRIC_ADD(stitches, 1);
+    }
+
+    void Stitcher::clear()
+    {
+        close();
+        _count = 0;
+    }
+
+    size_t Stitcher::count() const
+    {
+        return _count;
+    }
+
+    void Stitcher::__reserve(size_t capacity)
+    {
+        auto* buffer = static_cast<char*>(_arena->allocate(capacity, 1));
+        if (_pending != nullptr)
+        {
+            std::memcpy(buffer, _pending, _size);
+            _arena->deallocate(_pending, _capacity, 1);
+        }
+        else
+        {
+            std::memcpy(buffer, _target->data(), _size);
+        }
+        _pending = buffer;
+        _capacity = capacity;
+    }
+}
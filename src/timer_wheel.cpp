@@ -0,0 +1,196 @@
+#include <llhttplus/timer_wheel.hpp>
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace llhttplus
+{
+    namespace detail
+    {
+        /* `bits` must not be 0. */
+        static size_t __lowest_bit(uint64_t bits)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward64(&index, bits);
+            return index;
+#else
+            return static_cast<size_t>(__builtin_ctzll(bits));
+#endif
+        }
+    }
+
+    void Timer::cancel()
+    {
+        if (_wheel != nullptr)
+        {
+            _wheel->__unlink(this);
+            --_wheel->_size;
+            _wheel = nullptr;
+        }
+    }
+
+    TimerWheel::TimerWheel(clock::duration resolution, clock::time_point start)
+        : _start(start)
+        , _resolution(std::max(resolution, clock::duration(1)))
+    {
+    }
+
+    TimerWheel::~TimerWheel()
+    {
+        for (Timer* head : _heads)
+        {
+            for (Timer* timer = head; timer != nullptr; timer = timer->_next)
+            {
+                timer->_wheel = nullptr;
+            }
+        }
+    }
+
+    void TimerWheel::arm(Timer& timer, clock::duration after)
+    {
+        timer.cancel();
+
+        /* Rounded up, and at least one tick: the current slot has been expired already. */
+        uint64_t ticks = after.count() <= 0 ? 1 : static_cast<uint64_t>((after + _resolution - clock::duration(1)) / _resolution);
+        timer._expires = _now + std::min(ticks, UINT64_MAX / 2);
+        timer._wheel = this;
+        __link(&timer);
+        ++_size;
+    }
+
+    size_t TimerWheel::advance(clock::time_point now, std::vector<Timer*>& expired)
+    {
+        if (now <= _start)
+        {
+            return 0;
+        }
+
+        constexpr uint64_t mask = __slots - 1;
+        size_t before = expired.size();
+        uint64_t target = static_cast<uint64_t>((now - _start) / _resolution);
+        while (_now < target)
+        {
+            uint64_t tick = _now + 1;
+            size_t index = tick & mask;
+            if (index != 0)
+            {
+                /* Jump to the next occupied slot of level 0, or to where it wraps. */
+                uint64_t pending = _occupied[0] >> index;
+                if (pending == 0)
+                {
+                    _now = std::min(target, tick | mask);
+                    continue;
+                }
+                tick += detail::__lowest_bit(pending);
+                if (tick > target)
+                {
+                    _now = target;
+                    break;
+                }
+                index = tick & mask;
+            }
+
+            _now = tick;
+            if (index == 0)
+            {
+                /* Levels which wrapped, from the top, as they move timers down. */
+                for (size_t level = __levels - 1; level > 0; --level)
+                {
+                    if ((tick & ((uint64_t(1) << (level * __bits)) - 1)) == 0)
+                    {
+                        __cascade(level, tick);
+                    }
+                }
+            }
+
+            while (Timer* timer = _heads[index])
+            {
+                __unlink(timer);
+                timer->_wheel = nullptr;
+                --_size;
+                expired.push_back(timer);
+            }
+        }
+        return expired.size() - before;
+    }
+
+    TimerWheel::clock::time_point TimerWheel::now() const
+    {
+        return _start + _resolution * static_cast<clock::rep>(_now);
+    }
+
+    size_t TimerWheel::size() const
+    {
+        return _size;
+    }
+
+    void TimerWheel::__link(Timer* timer)
+    {
+        /* Timers beyond the span park on the top level, and are linked again
+         * with their real expiry when that slot cascades.
+         */
+        uint64_t delta = std::min(timer->_expires - _now, __span - 1);
+        uint64_t expires = _now + delta;
+
+        size_t level = 0;
+        while (delta >= (uint64_t(1) << ((level + 1) * __bits)))
+        {
+            ++level;
+        }
+
+        size_t index = (expires >> (level * __bits)) & (__slots - 1);
+        size_t slot = level * __slots + index;
+        timer->_slot = static_cast<uint16_t>(slot);
+        timer->_prev = nullptr;
+        timer->_next = _heads[slot];
+        if (timer->_next != nullptr)
+        {
+            timer->_next->_prev = timer;
+        }
+        _heads[slot] = timer;
+        _occupied[level] |= uint64_t(1) << index;
+    }
+
+    void TimerWheel::__unlink(Timer* timer)
+    {
+        size_t slot = timer->_slot;
+        if (timer->_prev != nullptr)
+        {
+            timer->_prev->_next = timer->_next;
+        }
+        else
+        {
+            _heads[slot] = timer->_next;
+        }
+        if (timer->_next != nullptr)
+        {
+            timer->_next->_prev = timer->_prev;
+        }
+        if (_heads[slot] == nullptr)
+        {
+            _occupied[slot / __slots] &= ~(uint64_t(1) << (slot % __slots));
+        }
+        timer->_prev = nullptr;
+        timer->_next = nullptr;
+    }
+
+    void TimerWheel::__cascade(size_t level, uint64_t tick)
+    {
+        size_t index = (tick >> (level * __bits)) & (__slots - 1);
+        size_t slot = level * __slots + index;
+        Timer* timer = _heads[slot];
+        _heads[slot] = nullptr;
+        _occupied[level] &= ~(uint64_t(1) << index);
+
+        /* Each timer lands on a lower level, due at or after `tick`. */
+        while (timer != nullptr)
+        {
+            Timer* next = timer->_next;
+            __link(timer);
+            timer = next;
+        }
+    }
+}
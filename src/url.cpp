@@ -0,0 +1,235 @@
+#include <llhttplus/url.hpp>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define _LLHTTP_URL_SSE2
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace llhttplus
+{
+    namespace detail
+    {
+        static const char* __find_escape_scalar(const char* p, const char* end, bool plus)
+        {
+            for (; p < end; ++p)
+            {
+                if (*p == '%' || (plus && *p == '+'))
+                {
+                    break;
+                }
+            }
+            return p;
+        }
+
+        /* Returns the first `%` (or `+`) at or after `p`, or `end`. Targets are
+         * short, so 16 bytes per step is as wide as it pays to go.
+         */
+        static const char* __find_escape(const char* p, const char* end, bool plus)
+        {
+#if defined(_LLHTTP_URL_SSE2)
+            const __m128i percent = _mm_set1_epi8('%');
+            const __m128i space = _mm_set1_epi8(plus ? '+' : '%');
+            for (; end - p >= 16; p += 16)
+            {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+                    _mm_or_si128(_mm_cmpeq_epi8(x, percent), _mm_cmpeq_epi8(x, space))));
+                if (mask != 0)
+                {
+#if defined(_MSC_VER)
+                    unsigned long index;
+                    _BitScanForward(&index, mask);
+                    return p + index;
+#else
+                    return p + __builtin_ctz(mask);
+#endif
+                }
+            }
+#endif
+            return __find_escape_scalar(p, end, plus);
+        }
+
+        static int __hex(char c)
+        {
+            if (c >= '0' && c <= '9')
+            {
+                return c - '0';
+            }
+            c |= 0x20;
+            if (c >= 'a' && c <= 'f')
+            {
+                return c - 'a' + 10;
+            }
+            return -1;
+        }
+
+        /* Decodes `[p, end)` to `out`, which may be `p` itself. */
+        static size_t __decode(char* out, const char* p, const char* end, bool plus)
+        {
+            char* begin = out;
+            while (p < end)
+            {
+                const char* escape = __find_escape(p, end, plus);
+                if (out != p)
+                {
+                    std::memmove(out, p, escape - p);
+                }
+                out += escape - p;
+                p = escape;
+                if (p == end)
+                {
+                    break;
+                }
+
+                int high, low;
+                if (*p == '+')
+                {
+                    *out++ = ' ';
+                    ++p;
+                }
+                else if (end - p >= 3 && (high = __hex(p[1])) >= 0 && (low = __hex(p[2])) >= 0)
+                {
+                    *out++ = static_cast<char>(high << 4 | low);
+                    p += 3;
+                }
+                else
+                {
+                    *out++ = *p++;
+                }
+            }
+            return out - begin;
+        }
+    }
+
+    bool needs_decoding(std::string_view value, bool plus)
+    {
+        const char* end = value.data() + value.size();
+        return detail::__find_escape(value.data(), end, plus) != end;
+    }
+
+    std::string_view percent_decode(std::string_view value, std::pmr::memory_resource* resource, bool plus)
+    {
+        const char* end = value.data() + value.size();
+        const char* escape = detail::__find_escape(value.data(), end, plus);
+        if (escape == end)
+        {
+            return value;
+        }
+
+        /* The clean prefix is copied once, the rest decoded behind it. */
+        auto* out = static_cast<char*>(resource->allocate(value.size(), 1));
+        size_t prefix = escape - value.data();
+        std::memcpy(out, value.data(), prefix);
+        size_t length = prefix + detail::__decode(out + prefix, escape, end, plus);
+        return std::string_view(out, length);
+    }
+
+    size_t percent_decode_in_place(char* data, size_t length, bool plus)
+    {
+        return detail::__decode(data, data, data + length, plus);
+    }
+
+    QueryIterator::QueryIterator(std::string_view query)
+        : _rest(query)
+    {
+        __load();
+    }
+
+    QueryIterator& QueryIterator::operator++()
+    {
+        __load();
+        return *this;
+    }
+
+    void QueryIterator::__load()
+    {
+        while (!_rest.empty())
+        {
+            size_t amp = _rest.find('&');
+            std::string_view pair = _rest.substr(0, amp);
+            _rest = amp == std::string_view::npos ? std::string_view() : _rest.substr(amp + 1);
+            if (pair.empty())
+            {
+                continue;
+            }
+
+            size_t eq = pair.find('=');
+            if (eq == std::string_view::npos)
+            {
+                _param = { pair, std::string_view() };
+            }
+            else
+            {
+                _param = { pair.substr(0, eq), pair.substr(eq + 1) };
+            }
+            return;
+        }
+        _param = {};
+    }
+
+    void UrlView::__split() const
+    {
+        size_t path = 0;
+        if (!_url.empty() && _url[0] != '/')
+        {
+            /* Absolute form: skip the scheme and the authority. */
+            size_t scheme = _url.find("://");
+            if (scheme != std::string_view::npos && _url.find_first_of("/?#") > scheme)
+            {
+                path = std::min(_url.find_first_of("/?#", scheme + 3), _url.size());
+            }
+        }
+
+        size_t fragment = std::min(_url.find('#', path), _url.size());
+        size_t query = std::min(_url.substr(0, fragment).find('?', path), fragment);
+        _path = static_cast<uint32_t>(path);
+        _query = static_cast<uint32_t>(query);
+        _fragment = static_cast<uint32_t>(fragment);
+        _split = true;
+    }
+
+    std::string_view UrlView::path() const
+    {
+        if (!_split)
+        {
+            __split();
+        }
+        return _url.substr(_path, _query - _path);
+    }
+
+    std::string_view UrlView::query() const
+    {
+        if (!_split)
+        {
+            __split();
+        }
+        return _query == _fragment ? std::string_view() : _url.substr(_query + 1, _fragment - _query - 1);
+    }
+
+    std::string_view UrlView::fragment() const
+    {
+        if (!_split)
+        {
+            __split();
+        }
+        return _fragment == _url.size() ? std::string_view() : _url.substr(_fragment + 1);
+    }
+
+    std::string_view UrlView::param(std::string_view key) const
+    {
+        for (const auto& param : params())
+        {
+            if (param.key == key)
+            {
+                return param.value;
+            }
+        }
+        return std::string_view();
+    }
+}
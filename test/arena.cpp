@@ -0,0 +1,145 @@
+#include "llhttplus/llhttplus.hpp"
+#include "check.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+ * Arena: alignment, reuse of the retained blocks after reset() and
+ * release(), and Parser::reset() releasing arena-backed spilled headers so
+ * a parser in steady state stops going upstream.
+ */
+
+static bool __aligned(const void* p, size_t alignment)
+{
+	return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+}
+
+static std::string __request(size_t headers)
+{
+	std::string data = "GET /arena HTTP/1.1\r\n";
+	for (size_t i = 0; i < headers; ++i)
+	{
+		data += "X-Header-" + std::to_string(i) + ": value " + std::to_string(i) + "\r\n";
+	}
+	return data + "\r\n";
+}
+
+int main()
+{
+	{
+		llhttplus::Arena arena(256);
+		bool aligned = true;
+		bool distinct = true;
+		std::vector<std::pair<char*, size_t>> blocks;
+		static const size_t alignments[] = { 1, 2, 8, 16, 64 };
+		for (size_t i = 0; i < 100; ++i)
+		{
+			size_t size = i % 37 + 1;
+			size_t alignment = alignments[i % 5];
+			auto* p = static_cast<char*>(arena.allocate(size, alignment));
+			aligned &= __aligned(p, alignment);
+			std::memset(p, static_cast<int>(i), size);
+			blocks.push_back({ p, size });
+		}
+		for (size_t i = 0; i < blocks.size(); ++i)
+		{
+			for (size_t j = 0; j < blocks[i].second; ++j)
+			{
+				distinct &= blocks[i].first[j] == static_cast<char>(i);
+			}
+		}
+		__check(aligned, "allocations are aligned");
+		__check(distinct, "allocations do not overlap");
+		__check(arena.allocations() == 100 && arena.upstream_allocations() > 1, "allocations counted");
+	}
+
+	{
+		/* The same sequence after reset() gets the same memory. */
+		llhttplus::Arena arena(128);
+		std::vector<void*> first;
+		for (size_t i = 0; i < 20; ++i)
+		{
+			first.push_back(arena.allocate(i * 3 + 1, 8));
+		}
+		size_t upstream = arena.upstream_allocations();
+		size_t used = arena.bytes_used();
+
+		arena.reset();
+		__check(arena.bytes_used() == 0, "reset() rewinds");
+		std::vector<void*> second;
+		for (size_t i = 0; i < 20; ++i)
+		{
+			second.push_back(arena.allocate(i * 3 + 1, 8));
+		}
+		__check(second == first && arena.upstream_allocations() == upstream && arena.bytes_used() == used,
+			"reset() reuses every block");
+
+		arena.release();
+		__check(arena.bytes_used() == 0, "release() rewinds");
+		__check(arena.allocate(16, 8) != nullptr && arena.upstream_allocations() == upstream + 1, "release() returns the blocks");
+	}
+
+	{
+		/* Retained blocks too small for a request are skipped, in order. */
+		llhttplus::Arena arena(64);
+		void* small = arena.allocate(48, 8);
+		void* next = arena.allocate(48, 8);
+		void* large = arena.allocate(300, 16);
+		__check(arena.upstream_allocations() == 3 && next != small && __aligned(large, 16), "oversized request gets its own block");
+
+		arena.reset();
+		void* again = arena.allocate(300, 16);
+		__check(again == large && arena.upstream_allocations() == 3, "oversized block found after reset()");
+		arena.reset();
+		__check(arena.allocate(48, 8) == small, "first block first");
+		arena.deallocate(small, 48, 8);
+		__check(arena.allocate(8, 8) != small, "deallocate() does not reuse");
+	}
+
+	{
+		/* Spilled headers of an arena-backed request are released by Parser::reset(). */
+		llhttplus::Parser parser;
+		llhttplus::BasicRequest<2> request(&parser.arena());
+		std::string data = __request(20);
+		__check(parser.execute(&request, data) == HPE_OK && request.headers.size() == 20 && request.headers.spilled(),
+			"headers spill into the arena");
+		__check(request.get("x-header-19") == "value 19" && parser.arena().bytes_used() > 0, "spilled headers");
+
+		parser.reset();
+		__check(!request.headers.spilled() && request.headers.empty() && request.headers.capacity() == 2
+			&& parser.arena().bytes_used() == 0, "Parser::reset() releases them");
+
+		size_t upstream = parser.arena().upstream_allocations();
+		bool same = true;
+		for (size_t i = 0; i < 50; ++i)
+		{
+			same &= parser.execute(&request, data) == HPE_OK && request.get("x-header-7") == "value 7";
+			parser.reset();
+		}
+		__check(same && parser.arena().upstream_allocations() == upstream, "steady state stays in the arena's blocks");
+
+		/* Stitched values come from the arena as well. */
+		std::string head = data.substr(0, 40);
+		std::string rest = data.substr(40);
+		parser.execute(&request, head);
+		__check(parser.execute(&request, rest) == HPE_OK && parser.stitch_count() == 1 && request.get("x-header-0") == "value 0"
+			&& request.get("x-header-0").data() != head.data() + 33 && request.get("x-header-19") == "value 19", "stitched value");
+		parser.reset();
+		__check(parser.arena().upstream_allocations() == upstream, "stitching reuses the blocks");
+	}
+
+	{
+		/* A request with its own resource keeps its headers across Parser::reset(). */
+		llhttplus::Parser parser;
+		llhttplus::BasicRequest<2> request;
+		parser.execute(&request, __request(5));
+		parser.reset();
+		__check(request.headers.spilled() && request.headers.size() == 5 && request.get("x-header-4") == "value 4",
+			"other resources are left alone");
+	}
+
+	return __summary();
+}
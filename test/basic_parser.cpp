@@ -0,0 +1,171 @@
+#include "llhttplus/llhttplus.hpp"
+#include "llhttplus/basic_parser.hpp"
+#include "check.hpp"
+
+#include <string>
+
+/*
+ * BasicParser<Setting>: every callback the setting implements is called in
+ * llhttp's order with the parser and the right data, at every cut of the
+ * input, and the setting's _on_message_complete runs before the parser's own
+ * handling and can pause.
+ */
+
+class Recorder
+{
+public:
+	std::string log;
+	llhttplus::Parser* parser = nullptr;
+	bool same_parser = true;
+	int complete_result = 0;
+	bool completed_first = true;
+
+	int _on_message_begin(llhttplus::Parser* p) { return __event(p, "begin"); }
+	int _on_url(llhttplus::Parser* p, const char* at, size_t length) { return __data(p, "url", at, length); }
+	int _on_status(llhttplus::Parser* p, const char* at, size_t length) { return __data(p, "status", at, length); }
+	int _on_header_field(llhttplus::Parser* p, const char* at, size_t length) { return __data(p, "field", at, length); }
+	int _on_header_value(llhttplus::Parser* p, const char* at, size_t length) { return __data(p, "value", at, length); }
+	int _on_headers_complete(llhttplus::Parser* p) { return __event(p, "headers"); }
+	int _on_body(llhttplus::Parser* p, const char* at, size_t length) { return __data(p, "body", at, length); }
+	int _on_chunk_header(llhttplus::Parser* p) { return __event(p, "chunk"); }
+	int _on_chunk_complete(llhttplus::Parser* p) { return __event(p, "chunk-done"); }
+	int _on_url_complete(llhttplus::Parser* p) { return __event(p, "url-done"); }
+	int _on_status_complete(llhttplus::Parser* p) { return __event(p, "status-done"); }
+	int _on_header_field_complete(llhttplus::Parser* p) { return __event(p, "field-done"); }
+	int _on_header_value_complete(llhttplus::Parser* p) { return __event(p, "value-done"); }
+
+	int _on_message_complete(llhttplus::Parser* p);
+
+private:
+	int __event(llhttplus::Parser* p, const char* name)
+	{
+		same_parser &= p == parser;
+		log += std::string(name) + " ";
+		_open = nullptr;
+		return 0;
+	}
+
+	/* Pieces of one value are joined, so any cut of the input logs the same. */
+	int __data(llhttplus::Parser* p, const char* name, const char* at, size_t length)
+	{
+		same_parser &= p == parser;
+		if (_open == name)
+		{
+			log.erase(log.size() - 2);
+		}
+		else
+		{
+			log += std::string(name) + "(";
+		}
+		log.append(at, length).append(") ");
+		_open = name;
+		return 0;
+	}
+
+	const char* _open = nullptr;
+};
+
+/* Exposes what `Parser::__on_message_complete()` records. */
+class RecordingParser : public llhttplus::BasicParser<Recorder>
+{
+public:
+	RecordingParser()
+	{
+		callbacks().parser = this;
+	}
+
+	bool batch_completed() const
+	{
+		return _batch_completed;
+	}
+};
+
+int Recorder::_on_message_complete(llhttplus::Parser* p)
+{
+	/* The parser marks the message complete only after this returns. */
+	completed_first &= !static_cast<RecordingParser*>(p)->batch_completed();
+	__event(p, "complete");
+	return complete_result;
+}
+
+static const std::string __request =
+	"POST /upload?x=1 HTTP/1.1\r\nHost: h\r\nTransfer-Encoding: chunked\r\n\r\n"
+	"3\r\nabc\r\n2;ext=1\r\nde\r\n0\r\nTrailer: t\r\n\r\n";
+
+static const std::string __request_log =
+	"begin url(/upload?x=1) url-done field(Host) field-done value(h) value-done "
+	"field(Transfer-Encoding) field-done value(chunked) value-done headers "
+	"chunk body(abc) chunk-done chunk body(de) chunk-done chunk "
+	"field(Trailer) field-done value(t) value-done chunk-done complete ";
+
+static const std::string __response = "HTTP/1.1 404 Not Found\r\nContent-Length: 4\r\n\r\ngone";
+
+static const std::string __response_log =
+	"begin status(Not Found) status-done field(Content-Length) field-done value(4) value-done headers "
+	"body(gone) complete ";
+
+int main()
+{
+	{
+		bool same = true;
+		for (size_t cut = 0; cut <= __request.size(); ++cut)
+		{
+			RecordingParser parser;
+			llhttplus::Request request;
+			same &= parser.execute(&request, __request.data(), cut) == HPE_OK
+				&& parser.execute(&request, __request.data() + cut, __request.size() - cut) == HPE_OK
+				&& parser.callbacks().log == __request_log && parser.callbacks().same_parser;
+		}
+		__check(same, "request callbacks in order at every cut");
+
+		same = true;
+		for (size_t cut = 0; cut <= __response.size(); ++cut)
+		{
+			RecordingParser parser;
+			llhttplus::Request request;
+			same &= parser.execute(&request, __response.data(), cut) == HPE_OK
+				&& parser.execute(&request, __response.data() + cut, __response.size() - cut) == HPE_OK
+				&& parser.callbacks().log == __response_log && parser.callbacks().same_parser;
+		}
+		__check(same, "response callbacks in order at every cut");
+
+		RecordingParser parser;
+		llhttplus::Request request;
+		__check(parser.execute(&request, __request + __request) == HPE_OK
+			&& parser.callbacks().log == __request_log + __request_log, "pipelined messages");
+		__check(request.url.empty() && request.headers.empty(), "a setting without storage leaves the request alone");
+	}
+
+	{
+		/* The setting runs first: the batch sees the message only after it. */
+		std::string data = __request + __request;
+		RecordingParser parser;
+		llhttplus::Request slots[2];
+		auto result = parser.execute_batch(slots, 2, data.data(), data.size());
+		__check(result.completed == 2 && result.error == HPE_OK && parser.callbacks().completed_first,
+			"setting's _on_message_complete before the parser's");
+	}
+
+	{
+		std::string data = __request + "GET /next HTTP/1.1\r\n\r\n";
+		RecordingParser parser;
+		parser.callbacks().complete_result = HPE_PAUSED;
+		llhttplus::Request request;
+		__check(parser.execute(&request, data) == HPE_PAUSED && parser.callbacks().log == __request_log,
+			"_on_message_complete can pause");
+		const char* rest = parser.get_error_pos();
+		__check(rest == data.data() + __request.size(), "paused after the message");
+
+		parser.resume();
+		parser.callbacks().complete_result = 0;
+		parser.callbacks().log.clear();
+		__check(parser.execute(&request, rest, data.data() + data.size() - rest) == HPE_OK
+			&& parser.callbacks().log == "begin url(/next) url-done headers complete ", "and resumes with the next message");
+
+		RecordingParser failing;
+		failing.callbacks().complete_result = -1;
+		__check(failing.execute(&request, __request) == HPE_CB_MESSAGE_COMPLETE, "_on_message_complete can fail");
+	}
+
+	return __summary();
+}
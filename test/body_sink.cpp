@@ -0,0 +1,239 @@
+#include "llhttplus/llhttplus.hpp"
+#include "check.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__LP64__)
+#include <sys/syscall.h>
+#define _LLHTTP_TEST_STALLED_WRITE 1
+#endif
+
+/*
+ * Body sinks: FunctionSink, IovecSink and FdSink receive Content-Length and
+ * chunked bodies arriving in pieces, a sink returning an error stops
+ * parsing, and FdSink reports failed and stalled writes.
+ */
+
+#if defined(_LLHTTP_TEST_STALLED_WRITE)
+static int __stalled_fd = -1;
+
+/* Replaces pwrite() for this program: the stalled descriptor accepts nothing
+ * without reporting an error, which no real file does reliably.
+ */
+extern "C" ssize_t pwrite(int fd, const void* buf, size_t count, off_t offset)
+{
+	if (fd == __stalled_fd)
+	{
+		return 0;
+	}
+	return syscall(SYS_pwrite64, fd, buf, count, offset);
+}
+#endif
+
+static const std::string __sized = "POST /sized HTTP/1.1\r\nContent-Length: 26\r\n\r\nabcdefghijklmnopqrstuvwxyz";
+
+static const std::string __chunked =
+	"POST /chunked HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+	"3\r\nabc\r\n1;ext=1\r\nd\r\n10\r\nefghijklmnopqrst\r\n6\r\nuvwxyz\r\n0\r\n\r\n";
+
+static const std::string __alphabet = "abcdefghijklmnopqrstuvwxyz";
+
+/* Counts finish() calls and can fail either call. */
+class RecordingSink : public llhttplus::BodySink
+{
+public:
+	int write(const llhttplus::RequestBase&, const char* at, size_t length) override
+	{
+		body.append(at, length);
+		++writes;
+		return body.size() >= fail_after ? write_error : 0;
+	}
+
+	int finish(const llhttplus::RequestBase& request) override
+	{
+		++finishes;
+		finished_url = std::string(request.url);
+		return finish_error;
+	}
+
+	std::string body;
+	std::string finished_url;
+	size_t writes = 0;
+	size_t finishes = 0;
+	size_t fail_after = SIZE_MAX;
+	int write_error = 0;
+	int finish_error = 0;
+};
+
+/* Feeds `data` in pieces of `piece` bytes out of one buffer. */
+static llhttp_errno_t __feed(llhttplus::Parser& parser, llhttplus::RequestBase& request, const std::string& data, size_t piece)
+{
+	for (size_t at = 0; at < data.size(); at += piece)
+	{
+		size_t length = std::min(piece, data.size() - at);
+		auto err = parser.execute(&request, data.data() + at, length);
+		if (err != HPE_OK)
+		{
+			return err;
+		}
+	}
+	return HPE_OK;
+}
+
+static std::string __read_all(int fd)
+{
+	std::string out;
+	char buffer[256];
+	ssize_t n;
+	while ((n = ::pread(fd, buffer, sizeof(buffer), static_cast<off_t>(out.size()))) > 0)
+	{
+		out.append(buffer, static_cast<size_t>(n));
+	}
+	return out;
+}
+
+int main()
+{
+	{
+		bool same = true;
+		for (const auto* data : { &__sized, &__chunked })
+		{
+			for (size_t piece = 1; piece <= data->size(); ++piece)
+			{
+				std::string body;
+				size_t calls = 0;
+				llhttplus::FunctionSink sink([&](const char* at, size_t length) {
+					body.append(at, length);
+					++calls;
+				});
+				llhttplus::Parser parser;
+				llhttplus::Request request;
+				request.body_sink = &sink;
+				same &= __feed(parser, request, *data, piece) == HPE_OK && parser.parse_done() && body == __alphabet
+					&& request.body.empty() && request.body_sink == &sink && calls >= 1;
+			}
+		}
+		__check(same, "FunctionSink receives bodies in pieces");
+	}
+
+	{
+		/* Spans point into the caller's buffer, which stays alive here. */
+		bool same = true;
+		for (size_t piece = 1; piece <= __chunked.size(); ++piece)
+		{
+			llhttplus::IovecSink sink;
+			llhttplus::Parser parser;
+			llhttplus::Request request;
+			request.body_sink = &sink;
+			same &= __feed(parser, request, __chunked, piece) == HPE_OK;
+
+			std::string body;
+			for (size_t i = 0; i < sink.size(); ++i)
+			{
+				auto* base = static_cast<const char*>(sink.data()[i].iov_base);
+				same &= base >= __chunked.data() && base < __chunked.data() + __chunked.size();
+				body.append(base, sink.data()[i].iov_len);
+			}
+			same &= body == __alphabet && sink.bytes() == 26 && (piece > 16 || sink.size() >= 4);
+		}
+		__check(same, "IovecSink references every span");
+
+		llhttplus::IovecSink sink;
+		llhttplus::Parser parser;
+		llhttplus::Request request;
+		request.body_sink = &sink;
+		parser.execute(&request, __sized);
+		sink.clear();
+		__check(sink.size() == 0 && sink.bytes() == 0, "IovecSink::clear()");
+	}
+
+	{
+		RecordingSink sink;
+		llhttplus::Parser parser;
+		llhttplus::Request request;
+		request.body_sink = &sink;
+		std::string pipelined = __sized + __chunked + "GET /empty HTTP/1.1\r\n\r\n";
+		__check(parser.execute(&request, pipelined) == HPE_OK && sink.body == __alphabet + __alphabet && sink.finishes == 3
+			&& sink.finished_url == "/empty", "finish() once per message, also without a body");
+
+		RecordingSink failing;
+		failing.fail_after = 5;
+		failing.write_error = HPE_USER;
+		llhttplus::Parser stopped;
+		request.body_sink = &failing;
+		__check(__feed(stopped, request, __chunked, 4) == HPE_USER && failing.body.size() >= 5 && failing.body.size() < 26
+			&& failing.finishes == 0, "write() error stops parsing");
+		__check(stopped.execute(&request, std::string_view("more")) == HPE_USER, "and the error stays");
+
+		RecordingSink pausing;
+		pausing.fail_after = 3;
+		pausing.write_error = HPE_PAUSED;
+		llhttplus::Parser paused;
+		request.body_sink = &pausing;
+		auto err = paused.execute(&request, __sized);
+		const char* rest = paused.get_error_pos();
+		pausing.write_error = 0;
+		paused.resume();
+		__check(err == HPE_PAUSED && paused.execute(&request, rest, __sized.data() + __sized.size() - rest) == HPE_OK
+			&& pausing.body == __alphabet && pausing.finishes == 1, "write() can pause");
+
+		RecordingSink refusing;
+		refusing.finish_error = HPE_USER;
+		llhttplus::Parser refused;
+		request.body_sink = &refusing;
+		__check(refused.execute(&request, __sized) != HPE_OK && refusing.body == __alphabet, "finish() error stops parsing");
+
+		llhttplus::FunctionSink limited([](const char*, size_t length) { return length > 4 ? HPE_USER : 0; });
+		llhttplus::Parser function;
+		request.body_sink = &limited;
+		__check(__feed(function, request, __sized, 4) == HPE_OK, "FunctionSink result, small pieces");
+		function.reset();
+		__check(function.execute(&request, __sized) == HPE_USER, "FunctionSink result, one piece");
+	}
+
+	{
+		int fds[2];
+		__check(::pipe(fds) == 0, "pipe");
+		llhttplus::FdSink sink(fds[1]);
+		llhttplus::Parser parser;
+		llhttplus::Request request;
+		request.body_sink = &sink;
+		__check(__feed(parser, request, __chunked, 7) == HPE_OK && sink.written() == 26 && sink.error() == 0, "FdSink write()");
+		char buffer[64] = {};
+		__check(::read(fds[0], buffer, sizeof(buffer)) == 26 && std::string(buffer) == __alphabet, "written to the pipe");
+		::close(fds[0]);
+		::close(fds[1]);
+
+		FILE* file = std::tmpfile();
+		int fd = fileno(file);
+		llhttplus::FdSink at_offset(fd, 10);
+		llhttplus::Parser positioned;
+		request.body_sink = &at_offset;
+		__check(__feed(positioned, request, __sized, 5) == HPE_OK && at_offset.written() == 26, "FdSink pwrite()");
+		__check(__read_all(fd) == std::string(10, '\0') + __alphabet, "written at the offset");
+
+		llhttplus::FdSink closed(-1);
+		llhttplus::Parser failed;
+		request.body_sink = &closed;
+		__check(failed.execute(&request, __sized) == HPE_USER && closed.error() == EBADF && closed.written() == 0,
+			"failed write keeps errno");
+
+#if defined(_LLHTTP_TEST_STALLED_WRITE)
+		__stalled_fd = fd;
+		llhttplus::FdSink stalled(fd, 0);
+		llhttplus::Parser stuck;
+		request.body_sink = &stalled;
+		__check(stuck.execute(&request, __sized) == HPE_USER && stalled.error() == EIO && stalled.written() == 0,
+			"write without progress is EIO");
+		__stalled_fd = -1;
+#endif
+		std::fclose(file);
+	}
+
+	return __summary();
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#ifndef _LLHTTP_TEST_CHECK_HPP_
+#define _LLHTTP_TEST_CHECK_HPP_
+#include <iostream>
+
+/*
+ * Checks shared by the test executables. Each check prints one line; `main()`
+ * returns `__summary()`, which is non-zero if any check failed so CTest
+ * reports it.
+ */
+
+inline int __failures = 0;
+
+inline void __check(bool ok, const char* what)
+{
+	std::cout << (ok ? "ok   " : "FAIL ") << what << std::endl;
+	if (!ok)
+	{
+		++__failures;
+	}
+}
+
+inline int __summary()
+{
+	std::cout << (__failures == 0 ? "all passed" : "FAILED") << std::endl;
+	return __failures == 0 ? 0 : 1;
+}
+
+/* For `main()` to return when a test cannot run here; CTest's SKIP_RETURN_CODE. */
+inline int __skip(const char* why)
+{
+	std::cout << "skipped: " << why << std::endl;
+	return 77;
+}
+
+#endif
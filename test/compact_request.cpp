@@ -0,0 +1,96 @@
+#include "llhttplus/compact_request.hpp"
+#include "check.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+ * CompactRequest: after parsing, the buffer is moved within itself or
+ * copied elsewhere and rebase()d, and the url, header and body views follow
+ * it; the same while a message is only partly received. Spans outside the
+ * base are rejected.
+ */
+
+static const std::string __message =
+	"POST /compact/path?q=1 HTTP/1.1\r\nHost: example\r\nX-Long-Header: some longer value\r\n"
+	"Transfer-Encoding: chunked\r\n\r\n4\r\nbody\r\n6;x=y\r\n in 3 \r\n6\r\nchunks\r\n0\r\n\r\n";
+
+static bool __parsed(const llhttplus::CompactRequest& request)
+{
+	return request.method == HTTP_POST && request.version_major == 1 && request.version_minor == 1
+		&& request.view(request.url) == "/compact/path?q=1" && request.headers.size() == 3
+		&& request.header(0).first == "Host" && request.header(0).second == "example"
+		&& request.get("x-long-header") == "some longer value" && request.get("transfer-encoding") == "chunked"
+		&& request.view(request.body) == "body in 3 chunks";
+}
+
+int main()
+{
+	{
+		std::vector<char> buffer(__message.begin(), __message.end());
+		llhttplus::CompactParser parser;
+		llhttplus::CompactRequest request;
+		request.rebase(buffer.data());
+		__check(parser.execute(&request, buffer.data(), buffer.size()) == HPE_OK && __parsed(request), "parsed");
+
+		/* Moved forward within the same buffer. */
+		size_t shift = 37;
+		buffer.resize(buffer.size() + shift);
+		std::memmove(buffer.data() + shift, buffer.data(), __message.size());
+		std::memset(buffer.data(), '#', shift);
+		request.rebase(buffer.data() + shift);
+		__check(__parsed(request), "moved forward and rebased");
+
+		/* Moved back to the front. */
+		std::memmove(buffer.data(), buffer.data() + shift, __message.size());
+		std::memset(buffer.data() + __message.size(), '#', shift);
+		request.rebase(request.base() - shift);
+		__check(__parsed(request), "moved back and rebased");
+
+		/* Copied to another buffer, the old one overwritten. */
+		std::vector<char> copy(buffer.begin(), buffer.begin() + __message.size());
+		std::fill(buffer.begin(), buffer.end(), '#');
+		request.rebase(copy.data());
+		__check(__parsed(request), "copied and rebased");
+
+		llhttplus::CompactRequest assigned = request;
+		copy.insert(copy.begin(), 5, '#');
+		assigned.rebase(copy.data() + 5);
+		__check(__parsed(assigned) && assigned.view(assigned.url).data() == copy.data() + 5 + 5, "copied request");
+	}
+
+	{
+		/* Cut at every position and moved to a larger buffer in between, as a
+		 * connection does when its receive buffer grows.
+		 */
+		bool same = true;
+		for (size_t cut = 0; cut <= __message.size(); ++cut)
+		{
+			std::vector<char> first(__message.begin(), __message.begin() + cut);
+			llhttplus::CompactParser parser;
+			llhttplus::CompactRequest request;
+			request.rebase(first.data());
+			same &= parser.execute(&request, first.data(), first.size()) == HPE_OK;
+
+			std::vector<char> grown(__message.size() + 16, '#');
+			std::memcpy(grown.data() + 16, first.data(), first.size());
+			std::fill(first.begin(), first.end(), '#');
+			std::memcpy(grown.data() + 16 + cut, __message.data() + cut, __message.size() - cut);
+			request.rebase(grown.data() + 16);
+			same &= parser.execute(&request, grown.data() + 16 + cut, __message.size() - cut) == HPE_OK
+				&& parser.parse_done() && __parsed(request);
+		}
+		__check(same, "moved while partly received");
+	}
+
+	{
+		std::string data = __message;
+		llhttplus::CompactParser parser;
+		llhttplus::CompactRequest request;
+		request.rebase(data.data() + 10);
+		__check(parser.execute(&request, data.data(), data.size()) == HPE_USER, "span before the base");
+	}
+
+	return __summary();
+}
@@ -0,0 +1,213 @@
+#include "llhttplus/connection.hpp"
+#include "check.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+ * Connection: pipelined messages cut at every position, compaction and
+ * growth around live and partial messages, the size limit, keep-alive,
+ * upgrades, EOF and popping an empty connection.
+ */
+
+struct Message
+{
+	std::string url;
+	std::string body;
+
+	bool operator==(const Message& other) const
+	{
+		return url == other.url && body == other.body;
+	}
+};
+
+/* Receives `data` in pieces of at most `piece` bytes, popping each message. */
+static std::vector<Message> __receive(llhttplus::Connection& connection, const std::string& data, size_t piece)
+{
+	std::vector<Message> messages;
+	for (size_t at = 0; at < data.size();)
+	{
+		auto region = connection.prepare();
+		size_t size = std::min({ piece, region.size, data.size() - at });
+		if (size == 0)
+		{
+			break;
+		}
+		std::memcpy(region.data, data.data() + at, size);
+		connection.commit(size);
+		at += size;
+		while (auto* request = connection.next())
+		{
+			messages.push_back({ std::string(request->view(request->url)), std::string(request->view(request->body)) });
+			connection.pop();
+		}
+	}
+	return messages;
+}
+
+static void __commit(llhttplus::Connection& connection, std::string_view data)
+{
+	auto region = connection.prepare(data.size());
+	std::memcpy(region.data, data.data(), data.size());
+	connection.commit(data.size());
+}
+
+int main()
+{
+	static const std::string pipelined =
+		"GET /1 HTTP/1.1\r\nHost: a\r\n\r\n"
+		"POST /2 HTTP/1.1\r\nHost: a\r\nContent-Length: 5\r\n\r\nhello"
+		"POST /3 HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n2\r\nde\r\n0\r\n\r\n"
+		"GET /4 HTTP/1.1\r\n\r\n";
+	const std::vector<Message> expected = { { "/1", "" }, { "/2", "hello" }, { "/3", "abcde" }, { "/4", "" } };
+
+	{
+		bool same = true;
+		for (size_t piece = 1; piece <= pipelined.size(); ++piece)
+		{
+			llhttplus::Connection connection;
+			same &= __receive(connection, pipelined, piece) == expected && connection.empty() && connection.keep_alive();
+		}
+		__check(same, "pipelined messages split across commits");
+
+		/* Cut once at every position, into a buffer that has to compact and grow. */
+		bool small = true;
+		for (size_t cut = 0; cut <= pipelined.size(); ++cut)
+		{
+			llhttplus::Connection connection(16, 1024);
+			auto messages = __receive(connection, pipelined.substr(0, cut), 16);
+			auto rest = __receive(connection, pipelined.substr(cut), 16);
+			messages.insert(messages.end(), rest.begin(), rest.end());
+			small &= messages == expected;
+		}
+		__check(small, "pipelined messages through a small buffer");
+	}
+
+	{
+		/* The live first message and the partial second one are moved to the front. */
+		llhttplus::Connection connection(64, 4096);
+		__commit(connection, "GET /skip HTTP/1.1\r\n\r\n");
+		auto* skipped = connection.next();
+		__check(skipped != nullptr && connection.live() == 1, "first message");
+		connection.pop();
+
+		__commit(connection, "GET /live HTTP/1.1\r\nHost: x\r\n\r\nPOST /partial HTTP/1.1\r\nContent-Length: 6\r\n\r\nab");
+		auto* live = connection.next();
+		__check(live != nullptr && connection.next() == nullptr && connection.live() == 1, "live and partial message");
+
+		auto region = connection.prepare(200);
+		__check(region.size >= 200 && connection.front().view(connection.front().url) == "/live"
+			&& connection.front().get("host") == "x", "live message is rebased by compaction");
+		std::memcpy(region.data, "cdef", 4);
+		connection.commit(4);
+		auto* partial = connection.next();
+		__check(partial != nullptr && partial->view(partial->url) == "/partial" && partial->view(partial->body) == "abcdef",
+			"partial message is finished after compaction");
+		__check(connection.front().view(connection.front().url) == "/live", "live message survives");
+		connection.pop();
+		connection.pop();
+		__check(connection.empty() && connection.unparsed().empty(), "all popped");
+	}
+
+	{
+		/* Only the bytes in front of the oldest live message are dropped. */
+		llhttplus::Connection connection(32, 32, 4);
+		__commit(connection, "GET /a HTTP/1.1\r\n\r\n");
+		__check(connection.next() != nullptr, "message in a full buffer");
+		auto region = connection.prepare(16);
+		__check(region.size < 16 && connection.front().view(connection.front().url) == "/a",
+			"live message is kept when space runs out");
+		connection.pop();
+		region = connection.prepare(32);
+		__check(region.size == 32, "buffer reused once nothing is live");
+	}
+
+	{
+		llhttplus::Connection connection(64, 128);
+		std::string head = "POST /big HTTP/1.1\r\nContent-Length: 1000\r\n\r\n";
+		auto messages = __receive(connection, head + std::string(1000, 'x'), 64);
+		auto region = connection.prepare();
+		__check(messages.empty() && region.size == 0 && connection.keep_alive() && connection.error() == HPE_OK,
+			"message over max_capacity fills the buffer");
+
+		llhttplus::Connection fits(64, 128);
+		messages = __receive(fits, "POST /fit HTTP/1.1\r\nContent-Length: 60\r\n\r\n" + std::string(60, 'y'), 64);
+		__check(messages.size() == 1 && messages[0].body == std::string(60, 'y'), "message within max_capacity");
+	}
+
+	{
+		llhttplus::Connection connection;
+		__commit(connection, "GET /close HTTP/1.1\r\nConnection: close\r\n\r\nGET /more HTTP/1.1\r\n\r\n");
+		auto* request = connection.next();
+		__check(request != nullptr && !connection.keep_alive() && connection.next() == nullptr
+			&& connection.error() == HPE_OK, "no messages after Connection: close");
+		__check(connection.unparsed() == "GET /more HTTP/1.1\r\n\r\n", "bytes after it are left");
+
+		llhttplus::Connection old;
+		__commit(old, "GET /old HTTP/1.0\r\n\r\n");
+		__check(old.next() != nullptr && !old.keep_alive(), "HTTP/1.0 closes");
+
+		llhttplus::Connection old_keep_alive;
+		__commit(old_keep_alive, "GET /old HTTP/1.0\r\nConnection: keep-alive\r\n\r\nGET /again HTTP/1.0\r\n\r\n");
+		__check(old_keep_alive.next() != nullptr && old_keep_alive.keep_alive(), "HTTP/1.0 with keep-alive stays open");
+		old_keep_alive.pop();
+		__check(old_keep_alive.next() != nullptr && !old_keep_alive.keep_alive(), "HTTP/1.0 without keep-alive after it");
+
+		llhttplus::Connection upgrade;
+		__commit(upgrade, "GET /ws HTTP/1.1\r\nConnection: Upgrade\r\nUpgrade: websocket\r\n\r\nframe");
+		__check(upgrade.next() != nullptr && upgrade.upgraded() && !upgrade.keep_alive() && upgrade.unparsed() == "frame",
+			"upgrade leaves the following bytes");
+
+		llhttplus::Connection bad;
+		__commit(bad, "GET /ok HTTP/1.1\r\n\r\nGET /bad HTTP/1.1\r\nBad Header\r\n\r\n");
+		__check(bad.next() != nullptr && bad.keep_alive(), "message before the error");
+		bad.pop();
+		__check(bad.next() == nullptr && !bad.keep_alive() && bad.error() != HPE_OK, "parse error closes");
+	}
+
+	{
+		/* A response without length ends with the connection. */
+		llhttplus::Connection connection;
+		__commit(connection, "HTTP/1.1 200 OK\r\n\r\nuntil the end");
+		__check(connection.next() == nullptr, "body without length waits for EOF");
+		auto* response = connection.finish();
+		__check(response != nullptr && response->view(response->body) == "until the end" && !connection.keep_alive()
+			&& connection.live() == 1, "finish() completes it");
+
+		llhttplus::Connection partial;
+		__commit(partial, "GET /cut HTTP/1.1\r\nHost: ");
+		__check(partial.next() == nullptr && partial.finish() == nullptr && partial.error() != HPE_OK
+			&& !partial.keep_alive(), "EOF in a request is an error");
+
+		llhttplus::Connection idle;
+		__check(idle.finish() == nullptr && idle.error() == HPE_OK && !idle.keep_alive(), "EOF between messages");
+		__commit(idle, "GET / HTTP/1.1\r\n\r\n");
+		__check(idle.next() == nullptr, "nothing parsed after EOF");
+	}
+
+	{
+		llhttplus::Connection connection;
+		connection.pop();
+		__check(connection.live() == 0 && connection.empty(), "pop() on an empty connection does nothing");
+		__check(__receive(connection, pipelined, 7) == expected, "connection works afterwards");
+		connection.pop();
+		__check(connection.live() == 0 && connection.empty(), "pop() after the last message does nothing");
+
+		/* At most max_pipelined messages are live. */
+		llhttplus::Connection limited(1024, 1024, 2);
+		__commit(limited, pipelined);
+		__check(limited.next() != nullptr && limited.next() != nullptr && limited.next() == nullptr && limited.live() == 2,
+			"next() stops at max_pipelined");
+		limited.pop();
+		auto* third = limited.next();
+		__check(third != nullptr && third->view(third->url) == "/3", "and goes on after pop()");
+
+		limited.reset();
+		__check(limited.empty() && limited.keep_alive() && __receive(limited, pipelined, 1024) == expected,
+			"reset() for another peer");
+	}
+
+	return __summary();
+}
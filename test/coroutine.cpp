@@ -0,0 +1,252 @@
+#include "llhttplus/coroutine.hpp"
+#include "check.hpp"
+
+#include <coroutine>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <vector>
+
+/*
+ * Test of AsyncConnection against an in-memory source which suspends on
+ * every read, resumed by a queue standing in for an event loop.
+ */
+
+static std::deque<std::coroutine_handle<>> __ready;
+
+static void __run_until_idle()
+{
+	while (!__ready.empty())
+	{
+		auto coroutine = __ready.front();
+		__ready.pop_front();
+		coroutine.resume();
+	}
+}
+
+/* Hands out `input` in pieces of at most `piece` bytes, one per read. */
+struct Source
+{
+	struct Read
+	{
+		bool await_ready()
+		{
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> coroutine)
+		{
+			__ready.push_back(coroutine);
+		}
+
+		size_t await_resume()
+		{
+			++source->reads;
+			size_t size = std::min({ out.size(), source->piece, source->input.size() - source->offset });
+			std::memcpy(out.data(), source->input.data() + source->offset, size);
+			source->offset += size;
+			return size;
+		}
+
+		Source*			source;
+		std::span<char>	out;
+	};
+
+	Read read_some(std::span<char> out)
+	{
+		return Read{ this, out };
+	}
+
+	std::string	input;
+	size_t		piece = SIZE_MAX;
+	size_t		offset = 0;
+	size_t		reads = 0;
+};
+
+struct Message
+{
+	std::string	target;
+	std::string	host;
+	std::string	body;
+};
+
+/* Reads every message, the body `chunk` bytes at a time unless `skip_body`. */
+static llhttplus::Task<> __read_all(llhttplus::AsyncConnection<Source>& connection, std::vector<Message>* messages,
+	size_t chunk, bool skip_body)
+{
+	while (auto* request = co_await connection.next_request())
+	{
+		Message message;
+		message.target = request->view(request->url);
+		message.host = request->get("Host");
+		if (!skip_body)
+		{
+			std::vector<char> buffer(chunk);
+			while (size_t n = co_await connection.body().read_some(buffer))
+			{
+				message.body.append(buffer.data(), n);
+			}
+		}
+		messages->push_back(std::move(message));
+	}
+}
+
+static std::vector<Message> __read(Source& source, size_t chunk = 3, bool skip_body = false,
+	llhttp_errno_t* error = nullptr, size_t max_capacity = 1024 * 1024)
+{
+	llhttplus::AsyncConnection<Source> connection(source, 4096, max_capacity);
+	std::vector<Message> messages;
+	auto task = __read_all(connection, &messages, chunk, skip_body);
+	task.start();
+	__run_until_idle();
+	if (!task.done())
+	{
+		messages.clear();
+	}
+	if (error != nullptr)
+	{
+		*error = connection.error();
+	}
+	return messages;
+}
+
+static const char __pipelined[] =
+	"GET /1 HTTP/1.1\r\nHost: a\r\n\r\n"
+	"POST /2 HTTP/1.1\r\nHost: b\r\nContent-Length: 11\r\n\r\nhello world"
+	"POST /3 HTTP/1.1\r\nHost: c\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n2\r\nde\r\n0\r\nX-Trailer: t\r\n\r\n"
+	"GET /4 HTTP/1.1\r\nHost: d\r\n\r\n";
+
+static bool __expected(const std::vector<Message>& messages, bool bodies)
+{
+	return messages.size() == 4
+		&& messages[0].target == "/1" && messages[0].host == "a" && messages[0].body.empty()
+		&& messages[1].target == "/2" && messages[1].host == "b" && messages[1].body == (bodies ? "hello world" : "")
+		&& messages[2].target == "/3" && messages[2].host == "c" && messages[2].body == (bodies ? "abcde" : "")
+		&& messages[3].target == "/4" && messages[3].host == "d";
+}
+
+int main()
+{
+	{
+		Source source;
+		source.input = __pipelined;
+		auto messages = __read(source);
+		__check(__expected(messages, true), "pipelined requests with bodies");
+		/* one read for all bytes, one for EOF */
+		__check(source.reads == 2, "suspends only when more bytes are needed");
+	}
+
+	{
+		Source source;
+		source.input = __pipelined;
+		source.piece = 1;
+		__check(__expected(__read(source), true), "input byte by byte");
+	}
+
+	{
+		Source source;
+		source.input = __pipelined;
+		__check(__expected(__read(source, 3, true), false), "unread bodies are skipped");
+	}
+
+	{
+		/* far larger than max_capacity, so it can only pass if it is not buffered */
+		std::string body;
+		for (size_t i = 0; body.size() < 1024 * 1024; ++i)
+		{
+			body += std::to_string(i) + ",";
+		}
+		Source source;
+		source.input = "PUT /big HTTP/1.1\r\nHost: e\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body
+			+ "GET /after HTTP/1.1\r\nHost: f\r\n\r\n";
+		source.piece = 1500;
+		llhttp_errno_t error;
+		auto messages = __read(source, 1000, false, &error, 8 * 1024);
+		__check(error == HPE_OK && messages.size() == 2 && messages[0].host == "e" && messages[0].body == body
+			&& messages[1].target == "/after", "body streamed through a small buffer");
+	}
+
+	{
+		Source source;
+		source.input = std::string("GET /head HTTP/1.1\r\nX-Long: ") + std::string(16 * 1024, 'x') + "\r\n\r\n";
+		llhttp_errno_t error;
+		auto messages = __read(source, 3, false, &error, 8 * 1024);
+		__check(messages.empty() && error == HPE_USER, "head over max_capacity");
+	}
+
+	{
+		Source source;
+		source.input = "GET / HTTP/1.1\r\nHost: a\r\n\r\nGET / HTTP/1.1\r\nBad Header\r\n\r\n";
+		llhttp_errno_t error;
+		auto messages = __read(source, 3, false, &error);
+		__check(messages.size() == 1 && error != HPE_OK, "malformed request");
+	}
+
+	{
+		Source source;
+		source.input = "POST / HTTP/1.1\r\nContent-Length: 10\r\n\r\nshort";
+		llhttp_errno_t error;
+		auto messages = __read(source, 3, false, &error);
+		__check(messages.size() == 1 && messages[0].body == "short" && error == HPE_INVALID_EOF_STATE, "EOF within a body");
+	}
+
+	{
+		Source source;
+		source.input = "GET /1 HTTP/1.1\r\nConnection: close\r\n\r\nGET /2 HTTP/1.1\r\n\r\n";
+		auto messages = __read(source);
+		__check(messages.size() == 1 && messages[0].target == "/1", "Connection: close");
+	}
+
+	{
+		/* frames are recycled by the connection's pool once it has warmed up */
+		struct Counting : std::pmr::memory_resource
+		{
+			void* do_allocate(size_t bytes, size_t alignment) override
+			{
+				++allocations;
+				return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+			}
+
+			void do_deallocate(void* p, size_t bytes, size_t alignment) override
+			{
+				std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+			}
+
+			bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+			{
+				return this == &other;
+			}
+
+			size_t allocations = 0;
+		} counting;
+
+		Source source;
+		for (int i = 0; i < 1000; ++i)
+		{
+			source.input += "POST /" + std::to_string(i) + " HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello";
+		}
+		source.piece = 7;
+
+		llhttplus::AsyncConnection<Source> connection(source, 4096, 1024 * 1024, &counting);
+		std::vector<Message> messages;
+		auto task = __read_all(connection, &messages, 3, false);
+		task.start();
+		size_t warm = 0;
+		while (!__ready.empty())
+		{
+			auto coroutine = __ready.front();
+			__ready.pop_front();
+			coroutine.resume();
+			if (messages.size() == 10 && warm == 0)
+			{
+				warm = counting.allocations;
+			}
+		}
+		__check(task.done() && messages.size() == 1000 && messages[999].body == "hello", "many suspensions");
+		__check(warm != 0 && counting.allocations == warm, "frames come from the connection pool");
+	}
+	return __summary();
+}
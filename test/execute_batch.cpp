@@ -0,0 +1,172 @@
+#include "llhttplus/llhttplus.hpp"
+#include "check.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+ * Parser::execute_batch: more pipelined messages than slots, a message cut
+ * at every position of the buffer and finished by the next batch, and an
+ * error in the middle of a batch.
+ */
+
+struct Message
+{
+	std::string url;
+	std::string body;
+
+	bool operator==(const Message& other) const
+	{
+		return url == other.url && body == other.body;
+	}
+};
+
+static const std::string __messages[] = {
+	"GET /1 HTTP/1.1\r\nHost: a\r\n\r\n",
+	"POST /2 HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello",
+	"POST /3 HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n0\r\n\r\n",
+	"GET /4 HTTP/1.1\r\nAccept: */*\r\n\r\n",
+	"PUT /5 HTTP/1.1\r\nContent-Length: 3\r\n\r\nxyz",
+};
+
+static const std::vector<Message> __expected = {
+	{ "/1", "" }, { "/2", "hello" }, { "/3", "abc" }, { "/4", "" }, { "/5", "xyz" },
+};
+
+static Message __message(const llhttplus::RequestBase& request)
+{
+	return { std::string(request.url), std::string(request.body) };
+}
+
+int main()
+{
+	std::string pipelined;
+	std::vector<size_t> ends;
+	for (const auto& message : __messages)
+	{
+		pipelined += message;
+		ends.push_back(pipelined.size());
+	}
+
+	{
+		/* Two slots for five messages: each batch stops after the second. */
+		llhttplus::Parser parser;
+		std::vector<llhttplus::Request> slots(2);
+		std::vector<Message> messages;
+		std::vector<size_t> consumed;
+		size_t at = 0;
+		while (at < pipelined.size())
+		{
+			auto result = parser.execute_batch(slots.data(), slots.size(), pipelined.data() + at, pipelined.size() - at);
+			if (result.error != HPE_OK || result.completed == 0)
+			{
+				break;
+			}
+			for (size_t i = 0; i < result.completed; ++i)
+			{
+				messages.push_back(__message(slots[i]));
+			}
+			at += result.consumed;
+			consumed.push_back(at);
+		}
+		__check(messages == __expected, "messages over several batches");
+		__check(consumed == std::vector<size_t>{ ends[1], ends[3], ends[4] }, "consumed stops after the last filled slot");
+
+		auto result = parser.execute_batch(slots.data(), 0, pipelined.data(), pipelined.size());
+		__check(result.completed == 0 && result.consumed == 0 && result.error == HPE_OK, "no slots");
+	}
+
+	{
+		/* Cut at every position; the partial message finishes in the next batch. */
+		bool same = true;
+		bool consumed = true;
+		for (size_t cut = 0; cut <= pipelined.size(); ++cut)
+		{
+			llhttplus::Parser parser;
+			std::vector<llhttplus::Request> slots(8);
+			auto first = parser.execute_batch(slots.data(), slots.size(), pipelined.data(), cut);
+			size_t whole = 0;
+			while (whole < ends.size() && ends[whole] <= cut)
+			{
+				++whole;
+			}
+			consumed &= first.error == HPE_OK && first.consumed == cut && first.completed == whole;
+
+			auto second = parser.execute_batch(slots.data() + first.completed, slots.size() - first.completed,
+				pipelined.data() + cut, pipelined.size() - cut);
+			consumed &= second.error == HPE_OK && second.consumed == pipelined.size() - cut;
+
+			std::vector<Message> messages;
+			for (size_t i = 0; i < first.completed + second.completed; ++i)
+			{
+				messages.push_back(__message(slots[i]));
+			}
+			same &= messages == __expected;
+		}
+		__check(consumed, "a cut message is consumed and left in the next slot");
+		__check(same, "the next batch completes it");
+	}
+
+	{
+		/* The same cut, with the rest in another buffer. */
+		bool same = true;
+		for (size_t cut = 0; cut <= pipelined.size(); ++cut)
+		{
+			llhttplus::Parser parser;
+			std::vector<llhttplus::Request> slots(8);
+			std::string head = pipelined.substr(0, cut);
+			std::string rest = pipelined.substr(cut);
+			auto first = parser.execute_batch(slots.data(), slots.size(), head.data(), head.size());
+			auto second = parser.execute_batch(slots.data() + first.completed, slots.size() - first.completed,
+				rest.data(), rest.size());
+			for (size_t i = 0; i < first.completed + second.completed && i < __expected.size(); ++i)
+			{
+				/* A body cut in two keeps only its last piece, see `DefaultSetting`. */
+				auto message = __message(slots[i]);
+				same &= message.url == __expected[i].url
+					&& __expected[i].body.size() >= message.body.size()
+					&& __expected[i].body.compare(__expected[i].body.size() - message.body.size(), std::string::npos, message.body) == 0;
+			}
+			same &= first.completed + second.completed == __expected.size();
+		}
+		__check(same, "a message cut across two buffers");
+	}
+
+	{
+		std::string bad = "GET /bad HTTP/1.1\r\nBad Header: x\r\n\r\n";
+		std::string data = __messages[0] + __messages[1] + bad + __messages[3];
+		size_t bad_begin = ends[1];
+
+		llhttplus::Parser parser;
+		std::vector<llhttplus::Request> slots(8);
+		auto result = parser.execute_batch(slots.data(), slots.size(), data.data(), data.size());
+		__check(result.completed == 2 && result.error == HPE_INVALID_HEADER_TOKEN && __message(slots[1]) == __expected[1],
+			"messages before the error are completed");
+		__check(result.consumed > bad_begin && result.consumed < bad_begin + bad.size()
+			&& parser.get_error_pos() == data.data() + result.consumed, "consumed points at the error");
+
+		result = parser.execute_batch(slots.data(), slots.size(), data.data() + result.consumed, data.size() - result.consumed);
+		__check(result.completed == 0 && result.error == HPE_INVALID_HEADER_TOKEN, "the error stays");
+
+		/* Failing in the first slot, nothing is completed. */
+		llhttplus::Parser first;
+		result = first.execute_batch(slots.data(), slots.size(), bad.data(), bad.size());
+		__check(result.completed == 0 && result.error == HPE_INVALID_HEADER_TOKEN && result.consumed < bad.size(),
+			"error in the first message");
+	}
+
+	{
+		/* Batches mix with execute() on the same parser. */
+		llhttplus::Parser parser;
+		std::vector<llhttplus::Request> slots(1);
+		auto result = parser.execute_batch(slots.data(), slots.size(), pipelined.data(), pipelined.size());
+		__check(result.completed == 1 && result.consumed == ends[0], "one slot");
+
+		llhttplus::Request request;
+		auto rest = std::string_view(pipelined).substr(ends[0], ends[1] - ends[0]);
+		__check(parser.execute(&request, rest) == HPE_OK && __message(request) == __expected[1], "execute() after a batch");
+	}
+
+	return __summary();
+}
@@ -0,0 +1,144 @@
+#include "llhttplus/llhttplus.hpp"
+#include "check.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/*
+ * Parser::execute_in_place: chunked bodies with chunk extensions and
+ * trailers end up as one contiguous view into the caller's buffer, and
+ * stay whole when chunks are split across calls.
+ */
+
+static const std::string __chunked =
+	"POST /upload HTTP/1.1\r\nHost: a\r\nTransfer-Encoding: chunked\r\n\r\n"
+	"5;name=value\r\nhello\r\n"
+	"1\r\n \r\n"
+	"a;a;b=\"quoted;\"\r\nwonderful \r\n"
+	"5\r\nworld\r\n"
+	"0;last\r\nChecksum: 42\r\nExpires: never\r\n\r\n";
+
+static const std::string __body = "hello wonderful world";
+
+static bool __trailers(const llhttplus::RequestBase& request)
+{
+	return request.get("checksum") == "42" && request.get(llhttplus::KnownHeader::Expires) == "never"
+		&& request.get(llhttplus::KnownHeader::Host) == "a" && request.headers.size() == 4;
+}
+
+int main()
+{
+	{
+		std::string buffer = __chunked;
+		llhttplus::Parser parser;
+		llhttplus::Request request;
+		__check(parser.execute_in_place(&request, buffer.data(), buffer.size()) == HPE_OK && parser.parse_done(),
+			"chunked message");
+		__check(request.body == __body, "chunk framing and extensions are removed");
+		__check(request.body.data() >= buffer.data() && request.body.data() + request.body.size() <= buffer.data() + buffer.size()
+			&& parser.stitch_count() == 0, "body is a view into the buffer");
+		__check(__trailers(request) && request.url == "/upload", "trailers are headers");
+
+		/* execute() on the same input keeps the last chunk only. */
+		llhttplus::Parser plain;
+		llhttplus::Request last;
+		__check(plain.execute(&last, __chunked) == HPE_OK && last.body == "world", "without in place");
+	}
+
+	{
+		/* The next pipelined message is left where it is. */
+		std::string next = "POST /next HTTP/1.1\r\nContent-Length: 4\r\n\r\nnext";
+		std::string buffer = __chunked + next;
+		llhttplus::Parser parser;
+		parser.pause_on_message_complete(true);
+		llhttplus::Request first;
+		llhttplus::Request second;
+		__check(parser.execute_in_place(&first, buffer.data(), buffer.size()) == HPE_PAUSED && first.body == __body,
+			"first message");
+		char* rest = const_cast<char*>(parser.get_error_pos());
+		__check(rest == buffer.data() + __chunked.size() && std::string(rest) == next, "next message untouched");
+		parser.resume();
+		__check(parser.execute_in_place(&second, rest, buffer.data() + buffer.size() - rest) == HPE_PAUSED
+			&& second.url == "/next" && second.body == "next" && first.body == __body, "second message");
+	}
+
+	{
+		/* Split once at every position, each part in its own buffer. */
+		bool whole = true;
+		bool viewed = true;
+		for (size_t cut = 0; cut <= __chunked.size(); ++cut)
+		{
+			std::string head = __chunked.substr(0, cut);
+			std::string rest = __chunked.substr(cut);
+			llhttplus::Parser parser;
+			llhttplus::Request request;
+			bool ok = parser.execute_in_place(&request, head.data(), head.size()) == HPE_OK
+				&& parser.execute_in_place(&request, rest.data(), rest.size()) == HPE_OK;
+			whole &= ok && parser.parse_done() && request.body == __body && __trailers(request);
+
+			/* The body stays in the buffer holding all of it, unless it is
+			 * still open at the end of the call, as more chunks might follow.
+			 */
+			size_t body_begin = __chunked.find("5;name");
+			size_t body_end = __chunked.find("Checksum") + 1;
+			if (cut <= body_begin)
+			{
+				viewed &= request.body.data() >= rest.data() && request.body.data() < rest.data() + rest.size();
+			}
+			else if (cut >= body_end)
+			{
+				viewed &= request.body.data() >= head.data() && request.body.data() < head.data() + head.size();
+			}
+		}
+		__check(whole, "chunks split across two calls");
+		__check(viewed, "no copy unless the body is split");
+	}
+
+	{
+		/* Many chunks in pieces of every size, each piece in a fresh buffer. */
+		std::string message = "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n";
+		std::string body;
+		for (size_t i = 1; i <= 40; ++i)
+		{
+			std::string payload(i % 17 + 1, static_cast<char>('a' + i % 26));
+			char size[8];
+			snprintf(size, sizeof(size), "%zx", payload.size());
+			message += std::string(size) + (i % 3 == 0 ? ";ext=" + std::to_string(i) : "") + "\r\n" + payload + "\r\n";
+			body += payload;
+		}
+		message += "0\r\n\r\n";
+
+		bool same = true;
+		for (size_t piece = 1; piece <= 64; ++piece)
+		{
+			llhttplus::Parser parser;
+			llhttplus::Request request;
+			std::vector<std::string> pieces;
+			pieces.reserve(message.size());
+			for (size_t at = 0; at < message.size(); at += piece)
+			{
+				pieces.push_back(message.substr(at, piece));
+				same &= parser.execute_in_place(&request, pieces.back().data(), pieces.back().size()) == HPE_OK;
+			}
+			same &= parser.parse_done() && request.body == body;
+		}
+		__check(same, "chunks in pieces of every size");
+	}
+
+	{
+		std::string buffer = "POST / HTTP/1.1\r\nContent-Length: 5\r\n\r\nplain";
+		llhttplus::Parser parser;
+		llhttplus::Request request;
+		__check(parser.execute_in_place(&request, buffer.data(), buffer.size()) == HPE_OK && request.body == "plain"
+			&& request.body.data() == buffer.data() + buffer.size() - 5, "Content-Length body is left in place");
+
+		std::string empty = "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n0\r\n\r\n";
+		llhttplus::Request none;
+		parser.reset();
+		__check(parser.execute_in_place(&none, empty.data(), empty.size()) == HPE_OK && none.body.empty(),
+			"empty chunked body");
+	}
+
+	return __summary();
+}
@@ -0,0 +1,188 @@
+#include "llhttplus/basic_parser.hpp"
+#include "llhttplus/default_setting.hpp"
+#include "check.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+ * Parser::execute_fast: every request, on the fast path or not, must give the
+ * same request and leave the parser in the same state as llhttp does, and
+ * parsers with other settings must never take it.
+ */
+
+static const char* __requests[] = {
+	/* common shape, taken by the fast path */
+	"GET /fast HTTP/1.1\r\nHost: github.com\r\n\r\n",
+	"GET / HTTP/1.1\r\n\r\n",
+	"HEAD /index.html?q=1 HTTP/1.1\r\nHost: a\r\nAccept: */*\r\nUser-Agent: test/1.0\r\nX-Custom:  padded\r\n\r\n",
+	"POST /submit HTTP/1.1\r\nHost: a\r\nContent-Type: text/plain\r\nContent-Length: 5\r\n\r\nhello",
+	"PUT /item HTTP/1.1\r\nContent-Length: 0\r\n\r\n",
+	"DELETE /item/1 HTTP/1.1\r\nCookie: a=1\r\nCookie: b=2\r\n\r\n",
+	"OPTIONS * HTTP/1.1\r\nHost: a\r\n\r\n",
+	"PATCH /x HTTP/1.1\r\nContent-Length: 3\r\nConnection: keep-alive\r\n\r\nabc",
+	"GET /old HTTP/1.0\r\nConnection: keep-alive\r\n\r\n",
+	"GET /empty HTTP/1.1\r\nX-Empty:\r\nHost: a\r\n\r\n",
+	/* anything else, left to llhttp */
+	"GET /close HTTP/1.1\r\nConnection: close\r\n\r\n",
+	"GET /old HTTP/1.0\r\n\r\n",
+	"POST /chunked HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhello\r\n0\r\n\r\n",
+	"GET /upgrade HTTP/1.1\r\nConnection: Upgrade\r\nUpgrade: websocket\r\n\r\n",
+	"COPY /file HTTP/1.1\r\nHost: a\r\n\r\n",
+	"GET /trailing HTTP/1.1\r\nHost: a \r\n\r\n",
+	"GET /partial HTTP/1.1\r\nHost: a\r\n",
+	"POST /short HTTP/1.1\r\nContent-Length: 10\r\n\r\nabc",
+	"GET /bad HTTP/1.1\r\nBad Header: x\r\n\r\n",
+};
+
+static bool __same(const llhttplus::RequestBase& a, const llhttplus::RequestBase& b)
+{
+	if (a.method != b.method || a.url != b.url || a.version_major != b.version_major
+		|| a.version_minor != b.version_minor || a.status != b.status || a.body != b.body
+		|| a.headers.size() != b.headers.size()
+		|| std::memcmp(a.header_index, b.header_index, sizeof(a.header_index)) != 0)
+	{
+		return false;
+	}
+	for (size_t i = 0; i < a.headers.size(); ++i)
+	{
+		if (a.headers[i] != b.headers[i])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool __same_state(llhttplus::Parser& a, llhttplus::Parser& b)
+{
+	return a.get_type() == b.get_type() && a.get_method() == b.get_method()
+		&& a.get_http_major() == b.get_http_major() && a.get_http_minor() == b.get_http_minor()
+		&& a.get_upgrade() == b.get_upgrade() && a.should_keep_alive() == b.should_keep_alive();
+}
+
+int main()
+{
+	static const char next[] = "GET /next HTTP/1.1\r\nHost: b\r\n\r\n";
+
+	{
+		bool same = true;
+		bool state = true;
+		bool then = true;
+		size_t taken = 0;
+		for (const char* data : __requests)
+		{
+			llhttplus::Parser fast;
+			llhttplus::Parser slow;
+			llhttplus::Request fast_request;
+			llhttplus::Request slow_request;
+			auto fast_err = fast.execute_fast(&fast_request, data, std::strlen(data));
+			auto slow_err = slow.execute(&slow_request, data, std::strlen(data));
+			same &= fast_err == slow_err && (slow_err != HPE_OK || __same(fast_request, slow_request));
+			state &= fast_err != HPE_OK || __same_state(fast, slow);
+			taken += fast.fast_path_count();
+
+			/* The parser goes on from the state the fast path left, on either path. */
+			if (fast_err == HPE_OK && slow.message_needs_eof() == 0)
+			{
+				fast_err = fast.execute_fast(&fast_request, next, std::strlen(next));
+				slow_err = slow.execute(&slow_request, next, std::strlen(next));
+				then &= fast_err == slow_err
+					&& (slow_err != HPE_OK || (__same(fast_request, slow_request) && __same_state(fast, slow)));
+			}
+		}
+		__check(same, "fast path and llhttp give the same request");
+		__check(state, "fast path leaves the parser state llhttp leaves");
+		__check(then, "next message parses the same");
+		__check(taken == 10, "common requests take the fast path");
+	}
+
+	{
+		/* After a message which closes the connection llhttp takes nothing more. */
+		static const char* closing[] = {
+			"GET /close HTTP/1.1\r\nConnection: close\r\n\r\n",
+			"GET /old HTTP/1.0\r\n\r\n",
+			"POST /old HTTP/1.0\r\nContent-Length: 1\r\n\r\nx",
+		};
+		bool rejected = true;
+		bool lenient = true;
+		for (const char* data : closing)
+		{
+			llhttplus::Parser parser;
+			llhttplus::Parser slow;
+			llhttplus::Request request;
+			auto err = parser.execute_fast(&request, data, std::strlen(data));
+			slow.execute(&request, data, std::strlen(data));
+			bool same = parser.should_keep_alive() == slow.should_keep_alive();
+			err = err == HPE_OK ? parser.execute_fast(&request, next, std::strlen(next)) : err;
+			auto slow_err = slow.execute(&request, next, std::strlen(next));
+			rejected &= same && err == HPE_CLOSED_CONNECTION && slow_err == err && parser.fast_path_count() == 0;
+
+			llhttplus::Parser lenient_parser;
+			lenient_parser.set_lenient_keep_alive(1);
+			err = lenient_parser.execute_fast(&request, data, std::strlen(data));
+			err = err == HPE_OK ? lenient_parser.execute_fast(&request, next, std::strlen(next)) : err;
+			lenient &= err == HPE_OK && lenient_parser.fast_path_count() == 1 && request.url == "/next";
+		}
+		__check(rejected, "execute_fast after a closing message");
+		__check(lenient, "execute_fast after a closing message with lenient keep-alive");
+
+		/* llhttp clears the flags after a message, so HTTP/1.0 reads as closing. */
+		static const char old[] = "GET /old HTTP/1.0\r\nConnection: keep-alive\r\n\r\n";
+		llhttplus::Parser fast;
+		llhttplus::Parser slow;
+		llhttplus::Request request;
+		fast.execute_fast(&request, old, std::strlen(old));
+		slow.execute(&request, old, std::strlen(old));
+		__check(fast.fast_path_count() == 1 && fast.should_keep_alive() == slow.should_keep_alive(),
+			"should_keep_alive after HTTP/1.0 keep-alive");
+		auto fast_err = fast.execute_fast(&request, next, std::strlen(next));
+		auto slow_err = slow.execute(&request, next, std::strlen(next));
+		__check(fast_err == HPE_OK && slow_err == HPE_OK && fast.fast_path_count() == 2,
+			"HTTP/1.0 keep-alive stays open");
+	}
+
+	{
+		const char* data = __requests[2];
+		llhttplus::BasicParser<llhttplus::DefaultSetting> basic;
+		llhttplus::Request request;
+		__check(basic.execute_fast(&request, data, std::strlen(data)) == HPE_OK && basic.fast_path_count() == 1,
+			"BasicParser<DefaultSetting> takes the fast path");
+
+		llhttplus::BasicParser<llhttplus::FilteredSetting<llhttplus::CaptureOnly<llhttplus::KnownHeader::Host>>> filtered;
+		llhttplus::Request filtered_request;
+		auto err = filtered.execute_fast(&filtered_request, data, std::strlen(data));
+		__check(err == HPE_OK && filtered.fast_path_count() == 0 && filtered_request.headers.size() == 1
+			&& filtered_request.get(llhttplus::KnownHeader::Host) == "a", "header filters are honoured");
+
+		llhttplus::DefaultSetting setting;
+		llhttplus::Parser explicit_default(&setting);
+		__check(explicit_default.execute_fast(&request, data, std::strlen(data)) == HPE_OK
+			&& explicit_default.fast_path_count() == 1, "Parser with a DefaultSetting takes the fast path");
+	}
+
+	{
+		/* Custom callbacks must see every message. */
+		class Counting : public llhttplus::ParserSetting<Counting>
+		{
+		public:
+			int _on_message_complete(llhttplus::Parser*)
+			{
+				++messages;
+				return 0;
+			}
+
+			int messages = 0;
+		};
+
+		const char* data = __requests[0];
+		Counting setting;
+		llhttplus::Parser parser(&setting);
+		llhttplus::Request request;
+		auto err = parser.execute_fast(&request, data, std::strlen(data));
+		__check(err == HPE_OK && setting.messages == 1 && parser.fast_path_count() == 0, "custom callbacks are called");
+	}
+
+	return __summary();
+}
@@ -0,0 +1,109 @@
+#include "llhttplus/llhttplus.hpp"
+#include "llhttplus/basic_parser.hpp"
+#include "llhttplus/default_setting.hpp"
+#include "check.hpp"
+
+#include <string>
+#include <vector>
+
+/*
+ * Header filters: CaptureOnly and CaptureExcept by KnownHeader, and
+ * CaptureNamed and CaptureExceptNamed by name, ignoring case, for known and
+ * custom headers, also with names split across execute() calls.
+ */
+
+inline constexpr std::string_view __edge_headers[] = { "Host", "x-api-key", "X-TENANT" };
+inline constexpr std::string_view __noisy_headers[] = { "Cookie", "Baggage", "traceparent" };
+
+using Named = llhttplus::FilteredSetting<llhttplus::CaptureNamed<__edge_headers>>;
+using ExceptNamed = llhttplus::FilteredSetting<llhttplus::CaptureExceptNamed<__noisy_headers>>;
+using Only = llhttplus::FilteredSetting<llhttplus::CaptureOnly<llhttplus::KnownHeader::Host, llhttplus::KnownHeader::Cookie>>;
+using Except = llhttplus::FilteredSetting<llhttplus::CaptureExcept<llhttplus::KnownHeader::Cookie>>;
+
+static_assert(llhttplus::CaptureNamed<__edge_headers>::capture("X-API-KEY", llhttplus::KnownHeader::Unknown),
+	"name filters are constexpr");
+static_assert(!llhttplus::CaptureNamed<__edge_headers>::capture("X-Api-Ke", llhttplus::KnownHeader::Unknown),
+	"names are compared whole");
+
+static const std::string __request =
+	"GET / HTTP/1.1\r\n"
+	"Host: example\r\n"
+	"Cookie: session=1\r\n"
+	"X-Api-Key: secret\r\n"
+	"Traceparent: 00-abc\r\n"
+	"x-tenant: t1\r\n"
+	"Baggage: a=b\r\n"
+	"X-Other: other\r\n"
+	"\r\n";
+
+template<class Setting>
+static std::vector<std::string> __names(const std::string& data, size_t cut)
+{
+	llhttplus::BasicParser<Setting> parser;
+	llhttplus::Request request;
+	std::vector<std::string> names;
+	if (parser.execute(&request, data.data(), cut) != HPE_OK
+		|| parser.execute(&request, data.data() + cut, data.size() - cut) != HPE_OK
+		|| !parser.parse_done())
+	{
+		return { "error" };
+	}
+	for (const auto& header : request.headers)
+	{
+		names.emplace_back(std::string(header.first) + "=" + std::string(header.second));
+	}
+	return names;
+}
+
+template<class Setting>
+static bool __every_cut(const std::vector<std::string>& expected)
+{
+	bool same = true;
+	for (size_t cut = 0; cut <= __request.size(); ++cut)
+	{
+		same &= __names<Setting>(__request, cut) == expected;
+	}
+	return same;
+}
+
+int main()
+{
+	{
+		__check(__every_cut<Named>({ "Host=example", "X-Api-Key=secret", "x-tenant=t1" }), "CaptureNamed");
+		__check(__every_cut<ExceptNamed>({ "Host=example", "X-Api-Key=secret", "x-tenant=t1", "X-Other=other" }),
+			"CaptureExceptNamed");
+		__check(__every_cut<Only>({ "Host=example", "Cookie=session=1" }), "CaptureOnly");
+		__check(__every_cut<Except>({ "Host=example", "X-Api-Key=secret", "Traceparent=00-abc", "x-tenant=t1",
+			"Baggage=a=b", "X-Other=other" }), "CaptureExcept");
+		__check(__every_cut<llhttplus::DefaultSetting>({ "Host=example", "Cookie=session=1", "X-Api-Key=secret",
+			"Traceparent=00-abc", "x-tenant=t1", "Baggage=a=b", "X-Other=other" }), "CaptureAll");
+	}
+
+	{
+		/* Kept headers are indexed and found by name, dropped ones are not. */
+		llhttplus::BasicParser<Named> parser;
+		llhttplus::Request request;
+		__check(parser.execute(&request, __request) == HPE_OK, "request");
+		__check(request.get(llhttplus::KnownHeader::Host) == "example" && request.get("X-TENANT") == "t1"
+			&& request.get("x-api-key") == "secret", "kept headers");
+		__check(request.get(llhttplus::KnownHeader::Cookie).empty() && request.get("baggage").empty(), "dropped headers");
+
+		llhttplus::BasicParser<ExceptNamed> except;
+		__check(except.execute(&request, __request) == HPE_OK && request.get(llhttplus::KnownHeader::Cookie).empty()
+			&& request.get("x-other") == "other" && request.get(llhttplus::KnownHeader::Host) == "example", "except by name");
+	}
+
+	{
+		/* Only the captured value is stitched. */
+		std::string big_cookie = "GET / HTTP/1.1\r\nCookie: " + std::string(2048, 'c') + "\r\nX-Api-Key: k\r\n\r\n";
+		llhttplus::BasicParser<Named> parser;
+		llhttplus::Request request;
+		size_t cut = big_cookie.find("ccc") + 100;
+		__check(parser.execute(&request, big_cookie.data(), cut) == HPE_OK
+			&& parser.execute(&request, big_cookie.data() + cut, big_cookie.size() - cut) == HPE_OK
+			&& parser.stitch_count() == 0 && parser.arena().bytes_used() == 0 && request.headers.size() == 1,
+			"dropped value is never copied");
+	}
+
+	return __summary();
+}
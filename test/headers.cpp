@@ -0,0 +1,143 @@
+#include "llhttplus/llhttplus.hpp"
+#include "check.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * HeaderList and BasicRequest<N>: exactly N and N + 1 headers, copying and
+ * moving spilled and inline lists, and clear() keeping the capacity.
+ */
+
+static const std::vector<std::string> __names = [] {
+	std::vector<std::string> names;
+	for (size_t i = 0; i < 40; ++i)
+	{
+		names.push_back("Name-" + std::to_string(i));
+	}
+	return names;
+}();
+
+static void __fill(llhttplus::HeaderList& list, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		list.push_back({ __names[i], "value" });
+	}
+}
+
+static bool __holds(const llhttplus::HeaderList& list, size_t count)
+{
+	bool same = list.size() == count;
+	for (size_t i = 0; same && i < count; ++i)
+	{
+		same &= list[i].first == __names[i] && list[i].second == "value";
+	}
+	return same;
+}
+
+static std::string __request(size_t headers)
+{
+	std::string data = "GET / HTTP/1.1\r\nHost: h\r\n";
+	for (size_t i = 1; i < headers; ++i)
+	{
+		data += __names[i] + ": value\r\n";
+	}
+	return data + "\r\n";
+}
+
+int main()
+{
+	{
+		llhttplus::Header storage[4];
+		llhttplus::HeaderList list(storage, 4, std::pmr::get_default_resource());
+		__check(list.empty() && list.capacity() == 4 && !list.spilled() && list.begin() == list.end(), "empty list");
+
+		__fill(list, 4);
+		__check(__holds(list, 4) && !list.spilled() && list.begin() == storage && list.capacity() == 4,
+			"exactly N headers stay inline");
+		list.push_back({ __names[4], "value" });
+		__check(__holds(list, 5) && list.spilled() && list.begin() != storage && list.capacity() == 8,
+			"N + 1 headers spill");
+		for (size_t i = 5; i < 40; ++i)
+		{
+			list.push_back({ __names[i], "value" });
+		}
+		__check(__holds(list, 40) && list.capacity() >= 40, "growing keeps every header");
+
+		size_t capacity = list.capacity();
+		auto* data = list.begin();
+		list.clear();
+		__check(list.empty() && list.spilled() && list.capacity() == capacity && list.begin() == data, "clear() keeps the capacity");
+		__fill(list, 30);
+		__check(__holds(list, 30) && list.begin() == data, "refilled without growing");
+		list.pop_back();
+		__check(__holds(list, 29), "pop_back()");
+
+		list.release();
+		__check(list.empty() && !list.spilled() && list.capacity() == 4 && list.begin() == storage, "release() goes inline");
+
+		llhttplus::Header none[1];
+		llhttplus::HeaderList zero(none, 0, std::pmr::get_default_resource());
+		zero.push_back({ "a", "b" });
+		__check(zero.spilled() && zero.size() == 1 && zero.capacity() == 8, "no inline capacity");
+	}
+
+	{
+		llhttplus::Header storage[2];
+		llhttplus::HeaderList spilled(storage, 2, std::pmr::get_default_resource());
+		__fill(spilled, 10);
+
+		llhttplus::Header other_storage[2];
+		llhttplus::HeaderList copy(other_storage, 2, std::pmr::get_default_resource());
+		copy = spilled;
+		__check(__holds(copy, 10) && copy.spilled() && copy.begin() != spilled.begin(), "copy of a spilled list");
+		spilled.clear();
+		__check(__holds(copy, 10), "copy is independent");
+
+		llhttplus::Header small_storage[2];
+		llhttplus::HeaderList small(small_storage, 2, std::pmr::get_default_resource());
+		__fill(small, 2);
+		copy = small;
+		__check(__holds(copy, 2) && copy.spilled(), "copying fewer headers keeps the spilled storage");
+		auto& self = copy;
+		copy = self;
+		__check(__holds(copy, 2), "self-assignment");
+	}
+
+	{
+		/* Requests copy their header list and index. */
+		llhttplus::Parser parser;
+		llhttplus::BasicRequest<4> request;
+		std::string data = __request(4);
+		__check(parser.execute(&request, data) == HPE_OK && request.headers.size() == 4 && !request.headers.spilled(),
+			"request with exactly N headers");
+		std::string more = __request(5);
+		__check(parser.execute(&request, more) == HPE_OK && request.headers.size() == 5 && request.headers.spilled()
+			&& request.get(llhttplus::KnownHeader::Host) == "h" && request.get("name-4") == "value", "request with N + 1 headers");
+
+		std::string many = __request(30);
+		__check(parser.execute(&request, many) == HPE_OK && request.headers.size() == 30, "spilled request");
+		llhttplus::BasicRequest<4> copy(request);
+		__check(copy.headers.size() == 30 && copy.headers.spilled() && copy.headers.begin() != request.headers.begin()
+			&& copy.get(llhttplus::KnownHeader::Host) == "h" && copy.get("name-29") == "value" && copy.url == "/",
+			"copied request");
+
+		llhttplus::BasicRequest<4> moved(std::move(copy));
+		__check(moved.headers.size() == 30 && moved.get("name-29") == "value" && moved.get(llhttplus::KnownHeader::Host) == "h",
+			"moved request");
+
+		llhttplus::BasicRequest<4> assigned;
+		assigned = moved;
+		moved.clear();
+		__check(assigned.headers.size() == 30 && assigned.get("name-17") == "value" && moved.headers.empty()
+			&& moved.get(llhttplus::KnownHeader::Host).empty(), "assigned request is independent");
+
+		size_t capacity = request.headers.capacity();
+		__check(parser.execute(&request, data) == HPE_OK && request.headers.size() == 4 && request.headers.capacity() == capacity
+			&& request.get("name-29").empty(), "next message reuses the capacity");
+	}
+
+	return __summary();
+}
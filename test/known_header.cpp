@@ -0,0 +1,124 @@
+#include "llhttplus/llhttplus.hpp"
+#include "check.hpp"
+
+#include <cctype>
+#include <string>
+
+/*
+ * classify_header(): every KnownHeader round-trips in any case, and near
+ * misses of each name (one byte changed, added or missing) are Unknown,
+ * checked against a linear search. Also RequestBase::get() by enum and by
+ * name.
+ */
+
+static llhttplus::KnownHeader __reference(std::string_view name)
+{
+	for (size_t i = 0; i < llhttplus::known_header_count; ++i)
+	{
+		if (llhttplus::detail::__iequals(name, llhttplus::known_header_names[i]))
+		{
+			return static_cast<llhttplus::KnownHeader>(i);
+		}
+	}
+	return llhttplus::KnownHeader::Unknown;
+}
+
+static std::string __case(std::string_view name, int (*convert)(int))
+{
+	std::string out(name);
+	for (auto& c : out)
+	{
+		c = static_cast<char>(convert(static_cast<unsigned char>(c)));
+	}
+	return out;
+}
+
+static_assert(llhttplus::classify_header("content-length") == llhttplus::KnownHeader::ContentLength,
+	"classify_header() is constexpr");
+
+int main()
+{
+	{
+		bool round_trip = true;
+		bool any_case = true;
+		for (size_t i = 0; i < llhttplus::known_header_count; ++i)
+		{
+			auto known = static_cast<llhttplus::KnownHeader>(i);
+			auto name = llhttplus::known_header_names[i];
+			round_trip &= llhttplus::classify_header(name) == known;
+
+			std::string mixed(name);
+			for (size_t j = 0; j < mixed.size(); j += 2)
+			{
+				mixed[j] = static_cast<char>(std::toupper(static_cast<unsigned char>(mixed[j])));
+			}
+			any_case &= llhttplus::classify_header(__case(name, ::tolower)) == known
+				&& llhttplus::classify_header(__case(name, ::toupper)) == known
+				&& llhttplus::classify_header(mixed) == known;
+		}
+		__check(round_trip, "every known header classifies as itself");
+		__check(any_case, "case is ignored");
+	}
+
+	{
+		static const char replacements[] = { 'x', 'Z', '-', '_', '0', ' ', '\0', '\x80', '\xff' };
+		bool near = true;
+		size_t misses = 0;
+		for (auto name : llhttplus::known_header_names)
+		{
+			std::string base(name);
+			std::string candidates[] = { base.substr(1), base.substr(0, base.size() - 1), base + "x", "x" + base, base + " " };
+			for (const auto& candidate : candidates)
+			{
+				near &= llhttplus::classify_header(candidate) == __reference(candidate);
+				misses += __reference(candidate) == llhttplus::KnownHeader::Unknown;
+			}
+
+			/* Every byte, including the ones the hash looks at. */
+			for (size_t at = 0; at < base.size(); ++at)
+			{
+				for (char c : replacements)
+				{
+					std::string changed = base;
+					changed[at] = c;
+					near &= llhttplus::classify_header(changed) == __reference(changed);
+					misses += __reference(changed) == llhttplus::KnownHeader::Unknown;
+				}
+			}
+		}
+		__check(near && misses > 1000, "near misses are Unknown");
+
+		__check(llhttplus::classify_header("") == llhttplus::KnownHeader::Unknown
+			&& llhttplus::classify_header("X-Custom") == llhttplus::KnownHeader::Unknown
+			&& llhttplus::classify_header("Unknown") == llhttplus::KnownHeader::Unknown
+			&& llhttplus::classify_header(std::string(300, 'a')) == llhttplus::KnownHeader::Unknown, "custom names");
+
+		/* Names which hash like a known header but differ elsewhere. */
+		bool same_hash = true;
+		for (auto name : llhttplus::known_header_names)
+		{
+			if (name.size() < 5)
+			{
+				continue;
+			}
+			std::string changed(name);
+			changed[1] = changed[1] == 'q' ? 'r' : 'q';
+			same_hash &= llhttplus::classify_header(changed) == __reference(changed);
+		}
+		__check(same_hash, "bytes outside the hash are compared");
+	}
+
+	{
+		llhttplus::Parser parser;
+		llhttplus::Request request;
+		std::string data = "GET / HTTP/1.1\r\nHOST: first\r\nx-custom: a\r\nHost: second\r\nX-Custom: b\r\nContent-Type: t\r\n\r\n";
+		__check(parser.execute(&request, data) == HPE_OK, "request");
+		__check(request.get(llhttplus::KnownHeader::Host) == "first" && request.get("host") == "first"
+			&& request.get("hOsT") == "first", "first occurrence of a known header");
+		__check(request.get("X-CUSTOM") == "a" && request.get("x-other").empty(), "custom headers by name");
+		__check(request.get(llhttplus::KnownHeader::ContentType) == "t" && request.get(llhttplus::KnownHeader::Accept).empty(),
+			"absent known header");
+	}
+
+	return __summary();
+}
@@ -1,9 +1,17 @@
 ﻿#include "llhttplus/llhttplus.hpp"
+#include "llhttplus/basic_parser.hpp"
+#include "llhttplus/compact_request.hpp"
+#include "llhttplus/connection.hpp"
+#include "llhttplus/default_setting.hpp"
+#include "llhttplus/parser_group.hpp"
+#include "llhttplus/response_writer.hpp"
+#include "llhttplus/router.hpp"
+#include "llhttplus/url.hpp"
 
-#include <windows.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <cstring>
 #include <iostream>
 
 static char data[] =
@@ -40,6 +48,19 @@ static char data_no_complete2[] =
 "Cache-Control: max-age=0\r\n\r\nb\r\nhello world\r\n0\r\n\r\n";
 
 
+static char data_pipelined[] =
+"GET /first HTTP/1.1\r\n"
+"Host: github.com\r\n\r\n"
+"POST /second HTTP/1.1\r\n"
+"Host: github.com\r\n"
+"Content-Length: 5\r\n\r\nhello"
+"GET /third HTTP/1.1\r\n"
+"Host: github.com\r\n\r\n";
+
+static char data_chunked[] =
+"POST /chunked HTTP/1.1\r\n"
+"Transfer-Encoding: chunked\r\n\r\n"
+"6\r\nhello \r\n5\r\nworld\r\n0\r\n\r\n";
 
 int main(int argc, char* argv[])
 {
@@ -63,10 +84,12 @@ int main(int argc, char* argv[])
 	}
 
 	std::cout << "body:" << request.body << std::endl;
+	std::cout << "host:" << request.get(llhttplus::KnownHeader::Host)
+		<< " dnt:" << request.get("dnt") << std::endl;
 	parser.reset();
 
 	/* not complete message */
-	llhttplus::Request requestw;
+	llhttplus::Request requestw(&parser.arena());
 	rst = parser.execute(&requestw, data_no_complete1, std::strlen(data_no_complete1));
 	std::cout << "finish status:" << parser.finish() << std::endl;
 	rst = parser.execute(&requestw, data_no_complete2, std::strlen(data_no_complete2));
@@ -86,7 +109,122 @@ int main(int argc, char* argv[])
 	}
 
 	std::cout << "body:" << requestw.body << std::endl;
+	std::cout << "stitches:" << parser.stitch_count() << std::endl;
+	std::cout << "arena allocations:" << parser.arena().allocations()
+		<< " upstream:" << parser.arena().upstream_allocations() << std::endl;
+
+	/* pipelined messages, statically dispatched callbacks */
+	llhttplus::BasicParser<llhttplus::DefaultSetting> static_parser;
+	llhttplus::Request slots[4];
+	auto batch = static_parser.execute_batch(slots, 4, data_pipelined, std::strlen(data_pipelined));
+	std::cout << "completed:" << batch.completed << " consumed:" << batch.consumed
+		<< " error:" << static_parser.errno_name(batch.error) << std::endl;
+
+	for (size_t i = 0; i < batch.completed; ++i)
+	{
+		std::cout << "method:" << static_parser.method_name(slots[i].method) << " url:" << slots[i].url
+			<< " body:" << slots[i].body << std::endl;
+	}
 	
+	/* body streamed to a sink */
+	std::string streamed;
+	llhttplus::FunctionSink sink([&streamed](const char* at, size_t length) { streamed.append(at, length); });
+	llhttplus::Request sunk;
+	sunk.body_sink = &sink;
+	parser.reset();
+	parser.execute(&sunk, data_no_complete1, std::strlen(data_no_complete1));
+	parser.execute(&sunk, data_no_complete2, std::strlen(data_no_complete2));
+	std::cout << "streamed body:" << streamed << std::endl;
+
+	/* chunked body compacted in place */
+	std::string mutable_data(data_chunked);
+	llhttplus::Request compacted;
+	parser.reset();
+	parser.execute_in_place(&compacted, mutable_data.data(), mutable_data.length());
+	std::cout << "compacted body:" << compacted.body << std::endl;
+
+	/* only selected headers are stored */
+	llhttplus::BasicParser<llhttplus::FilteredSetting<
+		llhttplus::CaptureOnly<llhttplus::KnownHeader::Host, llhttplus::KnownHeader::Connection>>> filtered_parser;
+	llhttplus::Request filtered;
+	filtered_parser.execute(&filtered, data, std::strlen(data));
+	for (const auto& header : filtered.headers)
+	{
+		std::cout << "filtered key:" << header.first << " value:" << header.second << std::endl;
+	}
+
+	/* offsets survive moving the buffer */
+	std::string moved_data(data_chunked);
+	llhttplus::CompactParser compact_parser;
+	llhttplus::CompactRequest compact;
+	compact.rebase(moved_data.data());
+	compact_parser.execute(&compact, moved_data.data(), moved_data.length());
+	std::string relocated(moved_data);
+	compact.rebase(relocated.data());
+	moved_data.assign(moved_data.length(), 'x');
+	std::cout << "compact url:" << compact.view(compact.url) << " body:" << compact.view(compact.body)
+		<< " te:" << compact.get("transfer-encoding") << std::endl;
+
+	/* pipelined messages received in fragments */
+	llhttplus::Connection connection(16);
+	for (size_t pos = 0, len = std::strlen(data_pipelined); pos < len; )
+	{
+		auto region = connection.prepare();
+		size_t received = std::min<size_t>(region.size, std::min<size_t>(len - pos, 10));
+		std::memcpy(region.data, data_pipelined + pos, received);
+		connection.commit(received);
+		pos += received;
+		while (auto* message = connection.next())
+		{
+			std::cout << "connection url:" << message->view(message->url) << std::endl;
+			connection.pop();
+		}
+	}
+	std::cout << "keep-alive:" << connection.keep_alive() << std::endl;
+
+	/* URL parts without copies; decoding only where there is an escape */
+	llhttplus::UrlView url("/search/caf%C3%A9?q=a+b%26c&lang=en#top");
+	std::cout << "url path:" << url.path() << " decoded:" << url.decoded_path(&parser.arena())
+		<< " fragment:" << url.fragment() << std::endl;
+	for (const auto& param : url.params())
+	{
+		std::cout << "param key:" << param.key << " value:" << llhttplus::percent_decode(param.value, &parser.arena(), true)
+			<< std::endl;
+	}
+
+	/* routing on method and path, captures point into the url */
+	llhttplus::Router router;
+	router.add(HTTP_GET, "/repos/:owner/:repo");
+	int blob = router.add(HTTP_GET, "/repos/:owner/:repo/blob/*path");
+	router.compile();
+	auto route = router.match(HTTP_GET, "/repos/nodejs/llhttp/blob/src/llhttp.c?plain=1");
+	std::cout << "route:" << (route.route == blob) << " owner:" << route.get("owner") << " path:" << route.get("path")
+		<< std::endl;
+
+	/* several connections parsed in one pass, completions grouped */
+	llhttplus::Parser first_parser, second_parser;
+	llhttplus::Request first_request, second_request;
+	const char first_data[] = "GET /a HTTP/1.1\r\nHost: a\r\n\r\n";
+	const char second_data[] = "GET /b HTTP/1.1\r\nHost: ";
+	llhttplus::ParseJob jobs[] = {
+		{ &first_parser, &first_request, first_data, sizeof(first_data) - 1 },
+		{ &second_parser, &second_request, second_data, sizeof(second_data) - 1 },
+	};
+	llhttplus::ParserGroup group;
+	group.execute_many(jobs, 2);
+	std::cout << "group completed:" << group.completed().size() << " failed:" << group.failed().size() << std::endl;
+
+#if !defined(_WIN32)
+	/* response referencing the body instead of copying it */
+	static const char greeting[] = "hello world";
+	llhttplus::ResponseWriter writer;
+	writer.status(200);
+	writer.date();
+	writer.header(llhttplus::header_blocks::content_type_text);
+	writer.body(greeting, std::strlen(greeting));
+	std::cout << "response iovecs:" << writer.size() << " bytes:" << writer.bytes() << std::endl;
+#endif
+
 	return 0;
 }
 
@@ -0,0 +1,110 @@
+#include "llhttplus/llhttplus.hpp"
+#include "llhttplus/metrics.hpp"
+#include "check.hpp"
+
+#include <cstring>
+#include <string>
+#include <thread>
+
+/*
+ * Parser counters, built with LLHTTPLUS_METRICS and LLHTTPLUS_METRICS_TICKS:
+ * bytes, calls, messages, callbacks, pauses, stitches and errors for known
+ * input, and counters of exited threads.
+ */
+
+static uint64_t __callbacks(const llhttplus::MetricsSnapshot& s, llhttplus::Callback callback)
+{
+	return s.callbacks[static_cast<size_t>(callback)];
+}
+
+static uint64_t __errors(const llhttplus::MetricsSnapshot& s)
+{
+	uint64_t errors = 0;
+	for (auto n : s.errors)
+	{
+		errors += n;
+	}
+	return errors;
+}
+
+int main()
+{
+	using llhttplus::Callback;
+
+	__check(llhttplus::metrics_enabled(), "counters compiled in");
+
+	{
+		static const char data[] = "GET / HTTP/1.1\r\nHost: a\r\n\r\n"
+			"POST /p HTTP/1.1\r\nHost: a\r\nContent-Length: 3\r\n\r\nabc";
+		auto before = llhttplus::metrics_snapshot();
+		llhttplus::Parser parser;
+		llhttplus::Request request;
+		auto err = parser.execute(&request, data, std::strlen(data));
+		auto after = llhttplus::metrics_snapshot();
+
+		__check(err == HPE_OK && after.bytes - before.bytes == std::strlen(data)
+			&& after.executes - before.executes == 1 && after.messages - before.messages == 2, "bytes, calls and messages");
+		__check(__callbacks(after, Callback::on_message_begin) - __callbacks(before, Callback::on_message_begin) == 2
+			&& __callbacks(after, Callback::on_header_field) - __callbacks(before, Callback::on_header_field) == 3
+			&& __callbacks(after, Callback::on_body) - __callbacks(before, Callback::on_body) == 1
+			&& __callbacks(after, Callback::on_message_complete) - __callbacks(before, Callback::on_message_complete) == 2,
+			"callbacks");
+		__check(after.execute_ticks > before.execute_ticks, "time in execute()");
+		__check(__errors(after) == __errors(before) && after.pauses == before.pauses, "no errors or pauses");
+	}
+
+	{
+		/* A value split across calls is stitched; a paused message is counted. */
+		static const char first[] = "GET /split HTTP/1.1\r\nHost: exa";
+		static const char second[] = "mple.com\r\n\r\nGET /next HTTP/1.1\r\n\r\n";
+		auto before = llhttplus::metrics_snapshot();
+		llhttplus::Parser parser;
+		llhttplus::Request request;
+		parser.pause_on_message_complete(true);
+		parser.execute(&request, first, std::strlen(first));
+		auto err = parser.execute(&request, second, std::strlen(second));
+		auto after = llhttplus::metrics_snapshot();
+
+		__check(err == HPE_PAUSED && request.get(llhttplus::KnownHeader::Host) == "example.com"
+			&& after.stitches - before.stitches == 1, "stitched values");
+		__check(after.pauses - before.pauses == 1 && after.executes - before.executes == 2, "pauses");
+	}
+
+	{
+		static const char data[] = "GET /bad HTTP/1.1\r\nBad Header: x\r\n\r\n";
+		auto before = llhttplus::metrics_snapshot();
+		llhttplus::Parser parser;
+		llhttplus::Request request;
+		auto err = parser.execute(&request, data, std::strlen(data));
+		auto after = llhttplus::metrics_snapshot();
+		__check(err != HPE_OK && after.errors[err] - before.errors[err] == 1 && __errors(after) - __errors(before) == 1,
+			"errors by code");
+	}
+
+	{
+		static const char data[] = "GET /fast HTTP/1.1\r\nHost: a\r\n\r\n";
+		auto before = llhttplus::metrics_snapshot();
+		llhttplus::Parser parser;
+		llhttplus::Request request;
+		parser.execute_fast(&request, data, std::strlen(data));
+		auto after = llhttplus::metrics_snapshot();
+		__check(parser.fast_path_count() == 1 && after.fast_path_messages - before.fast_path_messages == 1
+			&& after.messages - before.messages == 1 && after.bytes - before.bytes == std::strlen(data), "fast path");
+	}
+
+	{
+		static const char data[] = "GET /thread HTTP/1.1\r\n\r\n";
+		auto before = llhttplus::metrics_snapshot();
+		std::thread thread([] {
+			llhttplus::Parser parser;
+			llhttplus::Request request;
+			parser.execute(&request, data, std::strlen(data));
+		});
+		thread.join();
+		auto after = llhttplus::metrics_snapshot();
+		__check(after.messages - before.messages == 1 && after.bytes - before.bytes == std::strlen(data),
+			"counters of exited threads are kept");
+	}
+
+	return __summary();
+}
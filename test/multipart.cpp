@@ -0,0 +1,344 @@
+#include "llhttplus/multipart.hpp"
+#include "check.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+/*
+ * MultipartSink: parts, headers and payload for every way of cutting the
+ * body, boundaries from Content-Type, errors, and a large upload streamed
+ * without allocating.
+ */
+
+static std::atomic<size_t> __allocations{ 0 };
+
+void* operator new(size_t size)
+{
+	__allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+struct Part
+{
+	std::string	disposition;
+	std::string	type;
+	std::string	data;
+	bool		ended = false;
+};
+
+/* Keeps everything, and counts payload not handed out in place. */
+class CollectSink : public llhttplus::MultipartSink
+{
+public:
+	int part_begin(const llhttplus::RequestBase& part) override
+	{
+		collected.push_back({ std::string(part.get(llhttplus::KnownHeader::ContentDisposition)),
+			std::string(part.get("content-type")), std::string() });
+		return 0;
+	}
+
+	int part_data(const llhttplus::RequestBase& part, const char* at, size_t length) override
+	{
+		collected.back().data.append(at, length);
+		if (at < input_begin || at + length > input_end)
+		{
+			copied += length;
+		}
+		return 0;
+	}
+
+	int part_end(const llhttplus::RequestBase& part) override
+	{
+		collected.back().ended = true;
+		return 0;
+	}
+
+	std::vector<Part>	collected;
+	const char*			input_begin = nullptr;
+	const char*			input_end = nullptr;
+	size_t				copied = 0;
+};
+
+/* Sums the payload, allocating nothing. */
+class HashSink : public llhttplus::MultipartSink
+{
+public:
+	int part_data(const llhttplus::RequestBase& part, const char* at, size_t length) override
+	{
+		for (size_t i = 0; i < length; ++i)
+		{
+			hash = (hash ^ static_cast<unsigned char>(at[i])) * 1099511628211u;
+		}
+		bytes += length;
+		return 0;
+	}
+
+	uint64_t	hash = 14695981039346656037u;
+	size_t		bytes = 0;
+};
+
+static const std::string __boundary = "----WebKitFormBoundary7MA4YWxkTrZu0gW";
+
+static std::string __body()
+{
+	std::string d = "--" + __boundary;
+	return "This is the preamble, to be ignored.\r\n"
+		+ d + "\r\n"
+		"Content-Disposition: form-data; name=\"title\"\r\n"
+		"\r\n"
+		"Quarterly report\r\n"
+		+ d + "  \r\n"
+		"Content-Disposition: form-data; name=\"file\"; filename=\"report.bin\"\r\n"
+		"Content-Type: application/octet-stream\r\n"
+		"\r\n"
+		"line one\r\n\r\n--" + __boundary.substr(0, 20) + " not a delimiter\r\n-\r\n--\r"
+		+ std::string("\0\x01\xff binary", 10) + "\r\n"
+		+ d + "\r\n"
+		"\r\n"
+		"part without headers\r\n"
+		+ d + "--\r\n"
+		"This is the epilogue, also ignored.\r\n";
+}
+
+static bool __expected(const std::vector<Part>& parts)
+{
+	return parts.size() == 3
+		&& parts[0].disposition == "form-data; name=\"title\"" && parts[0].data == "Quarterly report"
+		&& parts[1].disposition == "form-data; name=\"file\"; filename=\"report.bin\""
+		&& parts[1].type == "application/octet-stream"
+		&& parts[1].data == "line one\r\n\r\n--" + __boundary.substr(0, 20) + " not a delimiter\r\n-\r\n--\r"
+			+ std::string("\0\x01\xff binary", 10)
+		&& parts[2].disposition.empty() && parts[2].data == "part without headers"
+		&& parts[0].ended && parts[1].ended && parts[2].ended;
+}
+
+static llhttplus::Request __request(const std::string& content_type)
+{
+	static std::string storage;
+	storage = "POST /upload HTTP/1.1\r\nContent-Type: " + content_type + "\r\n\r\n";
+	llhttplus::Request request;
+	llhttplus::Parser parser;
+	parser.execute(&request, storage);
+	return request;
+}
+
+int main()
+{
+	__check(llhttplus::multipart_boundary("multipart/form-data; boundary=abc") == "abc"
+		&& llhttplus::multipart_boundary("Multipart/Mixed; charset=utf-8;BOUNDARY=\"a b:c\"") == "a b:c"
+		&& llhttplus::multipart_boundary("multipart/form-data; boundary=x; charset=utf-8") == "x"
+		&& llhttplus::multipart_boundary("text/plain; boundary=abc").empty()
+		&& llhttplus::multipart_boundary("multipart/form-data").empty(), "boundary parameter");
+
+	std::string body = __body();
+	auto request = __request("multipart/form-data; boundary=" + __boundary);
+
+	{
+		/* Through the parser, the boundary taken from the request. */
+		std::string data = "POST /upload HTTP/1.1\r\n"
+			"Content-Type: multipart/form-data; boundary=\"" + __boundary + "\"\r\n"
+			"Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+		CollectSink sink;
+		llhttplus::Parser parser;
+		llhttplus::Request parsed;
+		parsed.body_sink = &sink;
+		sink.input_begin = data.data();
+		sink.input_end = data.data() + data.size();
+		auto err = parser.execute(&parsed, data);
+		__check(err == HPE_OK && __expected(sink.collected) && sink.parts() == 3, "parts of a request body");
+		__check(sink.copied == 0, "payload in one span is never copied");
+	}
+
+	{
+		bool ok = true;
+		size_t copied = 0;
+		for (size_t cut = 0; cut <= body.size(); ++cut)
+		{
+			std::string first = body.substr(0, cut);
+			std::string second = body.substr(cut);
+			CollectSink sink;
+			sink.reset(__boundary);
+			sink.input_begin = first.data();
+			sink.input_end = first.data() + first.size();
+			ok &= sink.write(request, first.data(), first.size()) == 0;
+			sink.input_begin = second.data();
+			sink.input_end = second.data() + second.size();
+			ok &= sink.write(request, second.data(), second.size()) == 0;
+			ok &= sink.finish(request) == 0 && __expected(sink.collected);
+			copied = std::max(copied, sink.copied);
+		}
+		__check(ok, "body cut anywhere in two");
+		__check(copied < __boundary.size() + 4, "held back bytes stay under one delimiter");
+	}
+
+	{
+		CollectSink sink;
+		sink.reset(__boundary);
+		bool ok = true;
+		for (char c : body)
+		{
+			ok &= sink.write(request, &c, 1) == 0;
+		}
+		__check(ok && sink.finish(request) == 0 && __expected(sink.collected), "body byte by byte");
+	}
+
+	{
+		/* Part headers which would frame an HTTP body must not frame the payload. */
+		std::string d = "--" + __boundary;
+		std::string framed = d + "\r\n"
+			"Content-Length: 5\r\n\r\n"
+			"longer than five\r\n"
+			+ d + "\r\n"
+			"Transfer-Encoding: chunked\r\n\r\n"
+			"not chunked\r\n"
+			+ d + "\r\n"
+			"Content-Length: 3\r\nTransfer-Encoding: chunked\r\n\r\n"
+			"both\r\n"
+			+ d + "\r\n"
+			"Connection: upgrade\r\nUpgrade: websocket\r\n\r\n"
+			"no upgrade\r\n"
+			+ d + "--\r\n";
+		bool ok = true;
+		for (size_t cut = 0; cut <= framed.size(); ++cut)
+		{
+			CollectSink sink;
+			sink.reset(__boundary);
+			ok &= sink.write(request, framed.data(), cut) == 0;
+			ok &= sink.write(request, framed.data() + cut, framed.size() - cut) == 0;
+			ok &= sink.finish(request) == 0 && sink.collected.size() == 4
+				&& sink.collected[0].data == "longer than five" && sink.collected[1].data == "not chunked"
+				&& sink.collected[2].data == "both" && sink.collected[3].data == "no upgrade";
+		}
+		__check(ok, "Content-Length and Transfer-Encoding in part headers");
+	}
+
+	{
+		/* Chunked, and two messages on one connection with different boundaries. */
+		std::string other = "other-boundary";
+		std::string second_body = "--" + other + "\r\nContent-Disposition: form-data; name=\"x\"\r\n\r\n1\r\n--" + other + "--";
+		std::string data = "POST /upload HTTP/1.1\r\n"
+			"Content-Type: multipart/form-data; boundary=" + __boundary + "\r\n"
+			"Transfer-Encoding: chunked\r\n\r\n";
+		for (size_t i = 0; i < body.size(); i += 37)
+		{
+			std::string chunk = body.substr(i, 37);
+			char size[16];
+			std::snprintf(size, sizeof(size), "%zx\r\n", chunk.size());
+			data += size + chunk + "\r\n";
+		}
+		data += "0\r\n\r\n";
+		data += "POST /upload HTTP/1.1\r\n"
+			"Content-Type: multipart/form-data; boundary=" + other + "\r\n"
+			"Content-Length: " + std::to_string(second_body.size()) + "\r\n\r\n" + second_body;
+
+		CollectSink sink;
+		llhttplus::Parser parser;
+		llhttplus::Request parsed;
+		parsed.body_sink = &sink;
+		auto err = parser.execute(&parsed, data);
+		bool second = sink.collected.size() == 4 && sink.parts() == 1 && sink.collected[3].data == "1";
+		sink.collected.resize(3);
+		__check(err == HPE_OK && __expected(sink.collected), "chunked body");
+		__check(second, "next message brings its own boundary");
+	}
+
+	{
+		struct Case
+		{
+			const char*					name;
+			std::string					body;
+			llhttplus::MultipartError	error;
+			size_t						max_head;
+		};
+		std::string d = "--" + __boundary;
+		Case cases[] = {
+			{ "truncated body", d + "\r\n\r\nno close delimiter", llhttplus::MultipartError::truncated, 16384 },
+			{ "bad framing", d + "x\r\n\r\n", llhttplus::MultipartError::framing, 16384 },
+			{ "bad part header", d + "\r\nno colon here\r\n\r\n", llhttplus::MultipartError::head, 16384 },
+			{ "part headers too large", d + "\r\nX-Long: " + std::string(200, 'a') + "\r\n\r\n", llhttplus::MultipartError::head_too_large, 64 },
+		};
+		for (const auto& c : cases)
+		{
+			struct Sink : llhttplus::MultipartSink
+			{
+				using MultipartSink::MultipartSink;
+				int part_data(const llhttplus::RequestBase&, const char*, size_t) override
+				{
+					return 0;
+				}
+			} sink(c.max_head);
+			sink.reset(__boundary);
+			int ret = sink.write(request, c.body.data(), c.body.size());
+			if (ret == 0)
+			{
+				ret = sink.finish(request);
+			}
+			__check(ret == HPE_USER && sink.error() == c.error, c.name);
+		}
+
+		HashSink sink;
+		auto plain = __request("text/plain");
+		__check(sink.write(plain, "x", 1) == HPE_USER && sink.error() == llhttplus::MultipartError::boundary,
+			"missing boundary");
+	}
+
+	{
+		/* 64 MB in 64 KB spans: constant memory, nothing allocated once warm. */
+		const size_t total = 64 << 20;
+		const size_t span = 64 << 10;
+		std::vector<char> payload(span);
+		uint64_t state = 0x9e3779b97f4a7c15;
+		for (auto& c : payload)
+		{
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			c = static_cast<char>(state);
+		}
+		std::string head = "--" + __boundary + "\r\nContent-Disposition: form-data; name=\"upload\"; filename=\"big.bin\"\r\n\r\n";
+		std::string tail = "\r\n--" + __boundary + "--\r\n";
+
+		HashSink sink;
+		HashSink reference;
+		sink.reset(__boundary);
+		bool ok = sink.write(request, head.data(), head.size()) == 0;
+		ok &= sink.write(request, payload.data(), span) == 0;
+		size_t allocations = __allocations.load();
+		for (size_t sent = span; sent < total; sent += span)
+		{
+			ok &= sink.write(request, payload.data(), span) == 0;
+		}
+		ok &= sink.write(request, tail.data(), tail.size()) == 0;
+		ok &= sink.finish(request) == 0;
+		allocations = __allocations.load() - allocations;
+		for (size_t sent = 0; sent < total; sent += span)
+		{
+			reference.part_data(request, payload.data(), span);
+		}
+		__check(ok && sink.bytes == total && sink.hash == reference.hash, "large upload streamed intact");
+		__check(allocations == 0, "no allocation while streaming");
+	}
+
+	return __summary();
+}
@@ -0,0 +1,131 @@
+#include "llhttplus/parser_group.hpp"
+#include "llhttplus/compact_request.hpp"
+#include "check.hpp"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * ParserGroup::execute_many: results and grouping of complete, partial,
+ * paused and failing jobs, for job counts around the prefetch distances,
+ * and jobs without a request.
+ */
+
+static const char* __inputs[] = {
+	"GET /complete HTTP/1.1\r\nHost: a\r\n\r\n",
+	"GET /partial HTTP/1.1\r\nHost: ",
+	"GET /paused HTTP/1.1\r\n\r\nGET /after HTTP/1.1\r\n\r\n",
+	"GET /bad HTTP/1.1\r\nBad Header: x\r\n\r\n",
+	"GET /ok HTTP/1.1\r\n\r\nGET /bad HTTP/1.1\r\nBad Header: x\r\n\r\n",
+};
+
+enum Kind { complete, partial, paused, failing, complete_then_failing };
+
+int main()
+{
+	{
+		bool results = true;
+		bool grouped = true;
+		for (size_t distance : { 1, 4 })
+		{
+			for (size_t count : { 0, 1, 3, 7, 8, 9, 17, 40 })
+			{
+				std::vector<std::unique_ptr<llhttplus::Parser>> parsers;
+				std::vector<llhttplus::Request> requests(count);
+				std::vector<llhttplus::ParseJob> jobs;
+				for (size_t i = 0; i < count; ++i)
+				{
+					parsers.push_back(std::make_unique<llhttplus::Parser>());
+					auto kind = static_cast<Kind>(i % 5);
+					parsers.back()->pause_on_message_complete(kind == paused);
+					const char* data = __inputs[kind];
+					jobs.push_back({ parsers.back().get(), &requests[i], data, std::strlen(data) });
+				}
+
+				llhttplus::ParserGroup group(distance);
+				group.execute_many(jobs);
+
+				std::vector<uint32_t> completed;
+				std::vector<uint32_t> failed;
+				for (size_t i = 0; i < count; ++i)
+				{
+					const auto& job = jobs[i];
+					switch (static_cast<Kind>(i % 5))
+					{
+					case complete:
+						results &= job.error == HPE_OK && job.completed && requests[i].url == "/complete";
+						completed.push_back(static_cast<uint32_t>(i));
+						break;
+					case partial:
+						results &= job.error == HPE_OK && !job.completed && requests[i].url == "/partial";
+						break;
+					case paused:
+						results &= job.error == HPE_PAUSED && job.completed && requests[i].url == "/paused";
+						completed.push_back(static_cast<uint32_t>(i));
+						break;
+					case failing:
+						results &= job.error == HPE_INVALID_HEADER_TOKEN && !job.completed;
+						failed.push_back(static_cast<uint32_t>(i));
+						break;
+					case complete_then_failing:
+						results &= job.error == HPE_INVALID_HEADER_TOKEN && job.completed;
+						failed.push_back(static_cast<uint32_t>(i));
+						break;
+					}
+				}
+				grouped &= group.completed() == completed && group.failed() == failed;
+			}
+		}
+		__check(results, "every job gets the result of execute()");
+		__check(grouped, "completed and failed jobs are listed in order");
+	}
+
+	{
+		/* A later batch starts its lists anew and a parser goes on where it stopped. */
+		llhttplus::Parser parser;
+		llhttplus::Request request;
+		llhttplus::ParserGroup group;
+		const char* first = __inputs[partial];
+		llhttplus::ParseJob job{ &parser, &request, first, std::strlen(first) };
+		group.execute_many(&job, 1);
+		__check(group.completed().empty() && group.failed().empty() && !job.completed, "partial message");
+
+		const char* rest = "a\r\n\r\n";
+		job = { &parser, &request, rest, std::strlen(rest) };
+		group.execute_many(&job, 1);
+		__check(group.completed().size() == 1 && job.completed && request.get(llhttplus::KnownHeader::Host) == "a",
+			"message completed by the next batch");
+	}
+
+	{
+		/* CompactParser fills the request it is bound to, the job has none. */
+		std::vector<std::string> buffers;
+		std::vector<llhttplus::CompactParser> parsers(12);
+		std::vector<llhttplus::CompactRequest> requests(12);
+		std::vector<llhttplus::ParseJob> jobs;
+		for (size_t i = 0; i < parsers.size(); ++i)
+		{
+			buffers.push_back("GET /compact/" + std::to_string(i) + " HTTP/1.1\r\nHost: c\r\n\r\n");
+		}
+		for (size_t i = 0; i < parsers.size(); ++i)
+		{
+			requests[i].rebase(buffers[i].data());
+			parsers[i].callbacks().bind(&requests[i]);
+			jobs.push_back({ &parsers[i], nullptr, buffers[i].data(), buffers[i].size() });
+		}
+
+		llhttplus::ParserGroup group(2);
+		group.execute_many(jobs);
+		bool parsed = group.completed().size() == jobs.size();
+		for (size_t i = 0; i < requests.size(); ++i)
+		{
+			parsed &= requests[i].view(requests[i].url) == "/compact/" + std::to_string(i)
+				&& requests[i].get("host") == "c";
+		}
+		__check(parsed, "jobs without a request");
+	}
+
+	return __summary();
+}
@@ -0,0 +1,150 @@
+#include "llhttplus/parser_pool.hpp"
+#include "llhttplus/default_setting.hpp"
+#include "check.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * ParserPool: alignment, recycling with kept capacity, custom settings and
+ * pairs released by other threads.
+ */
+
+static std::string __request(size_t headers)
+{
+	std::string data = "GET /pool HTTP/1.1\r\n";
+	for (size_t i = 0; i < headers; ++i)
+	{
+		data += "X-Header-" + std::to_string(i) + ": value\r\n";
+	}
+	return data + "\r\n";
+}
+
+static bool __parse(llhttplus::PooledParser* pooled, const std::string& data)
+{
+	return pooled->parser.execute(&pooled->request, data) == HPE_OK && pooled->request.url == "/pool";
+}
+
+int main()
+{
+	{
+		llhttplus::ParserPool pool(8);
+		__check(pool.size() >= 8, "reserve constructs pairs up front");
+
+		std::vector<llhttplus::PooledParser*> pooled;
+		bool aligned = true;
+		for (size_t i = 0; i < 8; ++i)
+		{
+			pooled.push_back(pool.acquire());
+			aligned &= reinterpret_cast<uintptr_t>(pooled.back()) % 64 == 0;
+		}
+		__check(aligned, "pairs are cache line aligned");
+		__check(pool.size() == 8, "reserved pairs are handed out first");
+
+		size_t size = pool.size();
+		for (auto* p : pooled)
+		{
+			pool.release(p);
+		}
+		for (size_t i = 0; i < 100; ++i)
+		{
+			pool.release(pool.acquire());
+		}
+		__check(pool.size() == size, "recycling does not grow the pool");
+	}
+
+	{
+		llhttplus::ParserPool pool;
+		auto* pooled = pool.acquire();
+		__check(__parse(pooled, __request(100)), "parse many headers");
+		size_t capacity = pooled->request.headers.capacity();
+		pool.release(pooled);
+
+		auto* again = pool.acquire();
+		__check(again == pooled, "released pair is reused");
+		__check(again->request.headers.empty() && again->request.url.empty(), "request is cleared");
+		__check(again->request.headers.capacity() == capacity && capacity >= 100, "header capacity is kept");
+		__check(__parse(again, __request(3)) && again->request.headers.size() == 3, "recycled parser parses");
+		pool.release(again);
+	}
+
+	{
+		llhttplus::DefaultSetting setting;
+		llhttplus::ParserPool pool(&setting, 1);
+		auto* pooled = pool.acquire();
+		__check(pooled->parser.setting() == static_cast<void*>(&setting), "pool uses the given setting");
+		std::string data = __request(2);
+		__check(pooled->parser.execute_fast(&pooled->request, data.data(), data.size()) == HPE_OK
+			&& pooled->parser.fast_path_count() == 1, "DefaultSetting pool takes the fast path");
+		pool.release(pooled);
+	}
+
+	{
+		/* Custom callbacks must see messages passed to execute_fast. */
+		class Counting : public llhttplus::ParserSetting<Counting>
+		{
+		public:
+			int _on_url(llhttplus::Parser*, const char*, size_t)
+			{
+				++urls;
+				return 0;
+			}
+
+			int urls = 0;
+		};
+
+		Counting setting;
+		llhttplus::ParserPool pool(&setting, 1);
+		auto* pooled = pool.acquire();
+		std::string data = __request(2);
+		auto err = pooled->parser.execute_fast(&pooled->request, data.data(), data.size());
+		__check(err == HPE_OK && setting.urls == 1 && pooled->parser.fast_path_count() == 0,
+			"custom setting pool skips the fast path");
+		pool.release(pooled);
+	}
+
+	{
+		/* Pairs handed to workers come back through the return list. */
+		llhttplus::ParserPool pool;
+		std::set<llhttplus::PooledParser*> seen;
+		bool parsed = true;
+		for (int round = 0; round < 50; ++round)
+		{
+			std::vector<llhttplus::PooledParser*> batch;
+			for (int i = 0; i < 32; ++i)
+			{
+				batch.push_back(pool.acquire());
+				seen.insert(batch.back());
+			}
+
+			std::vector<std::thread> workers;
+			std::vector<char> results(4, 1);
+			for (int w = 0; w < 4; ++w)
+			{
+				workers.emplace_back([&, w] {
+					for (size_t i = w; i < batch.size(); i += 4)
+					{
+						results[w] &= __parse(batch[i], __request(i % 40));
+						pool.release(batch[i]);
+					}
+				});
+			}
+			for (auto& worker : workers)
+			{
+				worker.join();
+			}
+			for (char result : results)
+			{
+				parsed &= result != 0;
+			}
+		}
+		__check(parsed, "pairs parse on other threads");
+		__check(seen.size() == pool.size() && pool.size() <= 48, "pairs released by other threads are reused");
+	}
+
+	return __summary();
+}
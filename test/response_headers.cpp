@@ -0,0 +1,99 @@
+#include "llhttplus/response_headers.hpp"
+#include "check.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <thread>
+
+/*
+ * format_http_date() against strftime() for random and edge timestamps, and
+ * the per-second cache of http_date() across a second boundary.
+ */
+
+static std::string __format(int64_t seconds)
+{
+	char out[llhttplus::http_date_length];
+	llhttplus::format_http_date(out, seconds);
+	return std::string(out, sizeof(out));
+}
+
+static std::string __strftime(int64_t seconds)
+{
+	time_t t = static_cast<time_t>(seconds);
+	tm utc;
+	gmtime_r(&t, &utc);
+	char out[64];
+	size_t length = std::strftime(out, sizeof(out), "%a, %d %b %Y %H:%M:%S GMT", &utc);
+	return std::string(out, length);
+}
+
+int main()
+{
+	{
+		/* Years 1900 to 9999, where IMF-fixdate has four digits. */
+		const int64_t first = -2208988800;
+		const int64_t last = 253402300799;
+		static const int64_t edges[] = {
+			first, last, -1, 0, 1, 86399, 86400,
+			951782400,      // 2000-02-29
+			4107542400,     // 2100-03-01
+			1700000000, 2147483647, 2147483648,
+		};
+
+		bool same = true;
+		for (int64_t seconds : edges)
+		{
+			same &= __format(seconds) == __strftime(seconds);
+		}
+		uint64_t state = 0x9e3779b97f4a7c15;
+		for (int i = 0; i < 200000; ++i)
+		{
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			int64_t seconds = first + static_cast<int64_t>(state % static_cast<uint64_t>(last - first + 1));
+			same &= __format(seconds) == __strftime(seconds);
+		}
+		__check(same, "format_http_date matches strftime");
+	}
+
+	{
+		__check(llhttplus::detail::__date_header_line() == "Date: " + std::string(llhttplus::http_date()) + "\r\n",
+			"Date header line");
+
+		/* The coarse clock may lag the precise one by a tick. */
+		auto second_of = [](const std::string& date, int64_t before, int64_t after) {
+			for (int64_t seconds = before - 1; seconds <= after; ++seconds)
+			{
+				if (__format(seconds) == date)
+				{
+					return seconds;
+				}
+			}
+			return INT64_MIN;
+		};
+
+		int64_t now = std::time(nullptr);
+		std::string date(llhttplus::http_date());
+		int64_t second = second_of(date, now, std::time(nullptr));
+		bool current = second != INT64_MIN;
+		bool refreshed = false;
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+		while (current && !refreshed && std::chrono::steady_clock::now() < deadline)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			now = std::time(nullptr);
+			std::string next(llhttplus::http_date());
+			int64_t next_second = second_of(next, now, std::time(nullptr));
+			current = next_second != INT64_MIN;
+			refreshed = next_second == second + 1;
+			current &= refreshed || next_second == second;
+		}
+		__check(current, "cached date is the current second");
+		__check(refreshed, "cache refreshes at the next second");
+	}
+
+	return __summary();
+}
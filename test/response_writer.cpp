@@ -0,0 +1,191 @@
+#include "llhttplus/response_writer.hpp"
+#include "check.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * ResponseWriter: serialized bytes and iovec layout of referenced, copied,
+ * multi-part and chunked bodies, and consume() stopping inside an entry,
+ * also while more output is added and the buffer grows.
+ */
+
+static std::string __flatten(const llhttplus::ResponseWriter& writer)
+{
+	std::string out;
+	for (size_t i = 0; i < writer.size(); ++i)
+	{
+		out.append(static_cast<const char*>(writer.data()[i].iov_base), writer.data()[i].iov_len);
+	}
+	return out;
+}
+
+static std::vector<size_t> __lengths(const llhttplus::ResponseWriter& writer)
+{
+	std::vector<size_t> lengths;
+	for (size_t i = 0; i < writer.size(); ++i)
+	{
+		lengths.push_back(writer.data()[i].iov_len);
+	}
+	return lengths;
+}
+
+/* Whether `bytes()` agrees with the entries. */
+static bool __counted(const llhttplus::ResponseWriter& writer)
+{
+	return __flatten(writer).size() == writer.bytes();
+}
+
+int main()
+{
+	{
+		static const char body[] = "hello world";
+		llhttplus::ResponseWriter writer;
+		writer.status(200);
+		writer.header("Content-Type", "text/plain");
+		writer.body(body, 11);
+
+		std::string head = "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: 11\r\n\r\n";
+		__check(__flatten(writer) == head + "hello world" && __counted(writer), "body() bytes");
+		__check(writer.size() == 2 && writer.data()[0].iov_len == head.size() && writer.data()[1].iov_base == body
+			&& writer.data()[1].iov_len == 11, "head in one entry, body referenced");
+	}
+
+	{
+		llhttplus::ResponseWriter writer;
+		writer.status(200, "Fine");
+		writer.status(299);
+		writer.status(404);
+		writer.header("Zero", uint64_t(0));
+		writer.header("Max", UINT64_MAX);
+		writer.header("Ten", uint64_t(10));
+		writer.end_headers();
+		__check(__flatten(writer) == "HTTP/1.1 200 Fine\r\nHTTP/1.1 299 \r\nHTTP/1.1 404 Not Found\r\n"
+			"Zero: 0\r\nMax: 18446744073709551615\r\nTen: 10\r\n\r\n" && writer.size() == 1, "status lines and numbers");
+
+		writer.clear();
+		writer.status(204);
+		writer.header(llhttplus::header_blocks::connection_close);
+		writer.end_headers();
+		auto lines = llhttplus::header_blocks::connection_close.lines();
+		__check(__flatten(writer) == "HTTP/1.1 204 No Content\r\nConnection: close\r\n\r\n" && writer.size() == 3
+			&& writer.data()[1].iov_base == lines.data() && writer.data()[1].iov_len == lines.size(),
+			"header block referenced, not copied");
+	}
+
+	{
+		static const char first[] = "abc";
+		static const char second[] = "defgh";
+		iovec parts[] = {
+			{ const_cast<char*>(first), 3 },
+			{ const_cast<char*>(second), 0 },
+			{ const_cast<char*>(second), 5 },
+		};
+		llhttplus::ResponseWriter writer;
+		writer.status(200);
+		writer.body(parts, 3);
+		__check(__flatten(writer) == "HTTP/1.1 200 OK\r\nContent-Length: 8\r\n\r\nabcdefgh" && __counted(writer),
+			"multi-part body bytes");
+		__check(writer.size() == 3 && writer.data()[1].iov_base == first && writer.data()[2].iov_base == second,
+			"one entry per non-empty part");
+	}
+
+	{
+		std::string body = "copied";
+		llhttplus::ResponseWriter writer;
+		writer.status(200);
+		writer.copy_body(body.data(), body.size());
+		writer.status(200);
+		writer.copy_body("", 0);
+		body.assign("xxxxxx");
+		__check(__flatten(writer) == "HTTP/1.1 200 OK\r\nContent-Length: 6\r\n\r\ncopied"
+			"HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n", "copy_body() bytes outlive the source");
+		__check(writer.size() == 1 && __counted(writer), "copied bodies share the head's entry");
+	}
+
+	{
+		static const char hello[] = "hello";
+		static const char letters[] = "abcdefghijklmnopqrstuvwxyz";
+		llhttplus::ResponseWriter writer;
+		writer.status(200);
+		writer.begin_chunked();
+		writer.chunk(hello, 5);
+		writer.chunk(hello, 0);
+		writer.chunk(letters, 26);
+		writer.end_chunked("Checksum: 1\r\n");
+
+		std::string head = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n";
+		__check(__flatten(writer) == head + "5\r\nhello\r\n1a\r\nabcdefghijklmnopqrstuvwxyz\r\n0\r\nChecksum: 1\r\n\r\n",
+			"chunked bytes, empty chunk skipped, trailers");
+		__check(__lengths(writer) == std::vector<size_t>{ head.size() + 3, 5, 6, 26, 2 + 3 + 13 + 2 }
+			&& writer.data()[1].iov_base == hello && writer.data()[3].iov_base == letters, "chunked layout");
+
+		writer.clear();
+		writer.status(200);
+		writer.begin_chunked();
+		writer.end_chunked();
+		__check(__flatten(writer) == head + "0\r\n\r\n" && writer.size() == 1, "chunked without chunks");
+	}
+
+	{
+		static const char body[] = "0123456789";
+		llhttplus::ResponseWriter writer;
+		writer.status(200);
+		writer.body(body, 10);
+		std::string all = __flatten(writer);
+		size_t head = writer.data()[0].iov_len;
+
+		writer.consume(5);
+		__check(writer.size() == 2 && writer.data()[0].iov_len == head - 5 && __flatten(writer) == all.substr(5)
+			&& __counted(writer), "consume() inside the first entry");
+		writer.consume(head - 5);
+		__check(writer.size() == 1 && writer.data()[0].iov_base == body && writer.bytes() == 10,
+			"consume() up to an entry boundary");
+		writer.consume(3);
+		__check(writer.size() == 1 && writer.data()[0].iov_base == body + 3 && writer.data()[0].iov_len == 7
+			&& __counted(writer), "consume() inside the body");
+		writer.consume(7);
+		__check(writer.size() == 0 && writer.bytes() == 0, "everything consumed");
+
+		writer.status(200);
+		writer.body(body, 10);
+		writer.consume(head + 2);
+		__check(writer.size() == 1 && writer.data()[0].iov_base == body + 2, "consume() across an entry");
+		writer.consume(100);
+		__check(writer.size() == 0 && writer.bytes() == 0, "consume() more than is left");
+	}
+
+	{
+		/* Chunks added between partial writes, growing the buffer in between. */
+		std::string expected;
+		std::string written;
+		static const char data[] = "chunk data";
+		llhttplus::ResponseWriter writer;
+		writer.status(200);
+		writer.begin_chunked();
+		expected = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n";
+		for (size_t i = 0; i < 64; ++i)
+		{
+			writer.chunk(data, 10);
+			expected += "a\r\nchunk data\r\n";
+			if (i % 8 == 7)
+			{
+				std::string trailer(300, 'x');
+				writer.header("X", trailer);
+				expected += "X: " + trailer + "\r\n";
+			}
+
+			std::string pending = __flatten(writer);
+			size_t step = (i * 7) % (pending.size() + 1);
+			written += pending.substr(0, step);
+			writer.consume(step);
+		}
+		writer.end_chunked();
+		expected += "0\r\n\r\n";
+		written += __flatten(writer);
+		__check(written == expected && __counted(writer), "partial writes while the buffer grows");
+	}
+
+	return __summary();
+}
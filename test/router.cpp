@@ -0,0 +1,144 @@
+#include "llhttplus/router.hpp"
+#include "check.hpp"
+
+#include <string>
+
+/*
+ * Router: precedence of text over `:param` over `*wildcard`, backtracking,
+ * empty wildcards, rejected patterns, the capture limit, query and fragment,
+ * and methods without routes.
+ */
+
+int main()
+{
+	{
+		llhttplus::Router router;
+		int wildcard = router.add(HTTP_GET, "/users/*rest");
+		int param = router.add(HTTP_GET, "/users/:id");
+		int text = router.add(HTTP_GET, "/users/me");
+		router.compile();
+
+		__check(wildcard == 0 && param == 1 && text == 2 && router.size() == 3, "ids in order of adding");
+		auto match = router.match(HTTP_GET, "/users/me");
+		__check(match.route == text && match.size == 0, "text wins over a capture");
+		match = router.match(HTTP_GET, "/users/42");
+		__check(match.route == param && match.size == 1 && match.get("id") == "42", "capture wins over a wildcard");
+		match = router.match(HTTP_GET, "/users/42/posts");
+		__check(match.route == wildcard && match.get("rest") == "42/posts" && match.get("id").empty(),
+			"wildcard takes the rest");
+		match = router.match(HTTP_GET, "/users/mine");
+		__check(match.route == param && match.get("id") == "mine", "text prefix of a segment is no match");
+	}
+
+	{
+		llhttplus::Router router;
+		int text = router.add(HTTP_GET, "/a/b/d");
+		int param = router.add(HTTP_GET, "/a/:x/c");
+		int deep = router.add(HTTP_GET, "/a/:x/:y/e");
+		int wildcard = router.add(HTTP_GET, "/a/*rest");
+		router.compile();
+
+		auto match = router.match(HTTP_GET, "/a/b/d");
+		__check(match.route == text && match.size == 0, "text branch");
+		match = router.match(HTTP_GET, "/a/b/c");
+		__check(match.route == param && match.size == 1 && match.get("x") == "b", "backtracks from a text branch");
+		match = router.match(HTTP_GET, "/a/b/d/e");
+		__check(match.route == deep && match.size == 2 && match.get("x") == "b" && match.get("y") == "d",
+			"backtracks deeper");
+		match = router.match(HTTP_GET, "/a/b/z");
+		__check(match.route == wildcard && match.size == 1 && match.get("rest") == "b/z",
+			"captures of failed branches are dropped");
+	}
+
+	{
+		llhttplus::Router router;
+		int files = router.add(HTTP_GET, "/files/*path");
+		int root = router.add(HTTP_GET, "/*all");
+		router.compile();
+
+		auto match = router.match(HTTP_GET, "/files/");
+		__check(match.route == files && match.size == 1 && match.get("path").empty(), "wildcard matching nothing");
+		match = router.match(HTTP_GET, "/files/a/b.txt");
+		__check(match.route == files && match.get("path") == "a/b.txt", "wildcard over segments");
+		match = router.match(HTTP_GET, "/");
+		__check(match.route == root && match.get("all").empty(), "root wildcard matching nothing");
+		match = router.match(HTTP_GET, "/files");
+		__check(match.route == root && match.get("all") == "files", "path shorter than a text node");
+	}
+
+	{
+		llhttplus::Router router;
+		__check(router.add(HTTP_GET, "/a/:id") == 0, "first route");
+		__check(router.add(HTTP_GET, "/a/:id") == -1, "same pattern again");
+		__check(router.add(HTTP_GET, "/a/:name") == -1, "capture named differently");
+		__check(router.add(HTTP_GET, "/a/:name/b") == -1, "capture named differently further down");
+		__check(router.add(HTTP_POST, "/a/:id") == 1, "same pattern for another method");
+		__check(router.add(HTTP_GET, "") == -1 && router.add(HTTP_GET, "a/b") == -1, "pattern without leading slash");
+		__check(router.add(HTTP_GET, "/a/:") == -1 && router.add(HTTP_GET, "/b/*") == -1, "capture without name");
+		__check(router.add(HTTP_GET, "/c/*rest/d") == -1, "wildcard before the end");
+		__check(router.add(static_cast<llhttp_method_t>(64), "/x") == -1, "method out of range");
+		__check(router.size() == 2, "rejected routes are not counted");
+		__check(router.add(HTTP_GET, "/a:b/c*d") == 2, "colon and star inside a segment are text");
+		router.compile();
+		__check(router.match(HTTP_GET, "/a:b/c*d").route == 2, "text with colon and star");
+	}
+
+	{
+		std::string eight;
+		std::string nine;
+		std::string path;
+		for (int i = 0; i < 9; ++i)
+		{
+			std::string segment = "/:p" + std::to_string(i);
+			nine += segment;
+			if (i < 8)
+			{
+				eight += segment;
+				path += "/" + std::to_string(i);
+			}
+		}
+
+		llhttplus::Router router;
+		__check(router.add(HTTP_GET, nine) == -1, "more than max_route_params captures");
+		int route = router.add(HTTP_GET, eight);
+		__check(route == 0, "max_route_params captures");
+		router.compile();
+		auto match = router.match(HTTP_GET, path);
+		__check(match.route == route && match.size == llhttplus::max_route_params && match.get("p0") == "0"
+			&& match.get("p7") == "7", "all captures filled");
+	}
+
+	{
+		llhttplus::Router router;
+		int route = router.add(HTTP_GET, "/search/:term");
+		router.compile();
+
+		auto match = router.match(HTTP_GET, "/search/cats?page=2#top");
+		__check(match.route == route && match.get("term") == "cats", "query and fragment are ignored");
+		match = router.match(HTTP_GET, "/search/cats#top?x");
+		__check(match.route == route && match.get("term") == "cats", "fragment before a question mark");
+		match = router.match(HTTP_GET, "http://example.com/search/dogs?x=1");
+		__check(match.route == route && match.get("term") == "dogs", "absolute-form URL");
+		__check(!router.match(HTTP_GET, "/search/?q=cats"), "empty capture before the query");
+		__check(!router.match(HTTP_GET, "/search/a%2Fb/c"), "captures are not decoded");
+	}
+
+	{
+		llhttplus::Router router;
+		router.add(HTTP_GET, "/only-get");
+		router.compile();
+		__check(!router.match(HTTP_POST, "/only-get"), "method without routes");
+		__check(!router.match(static_cast<llhttp_method_t>(200), "/only-get"), "method out of range");
+		__check(!router.match(HTTP_GET, "/other"), "no route");
+
+		llhttplus::Router empty;
+		empty.compile();
+		__check(!empty.match(HTTP_GET, "/"), "router without routes");
+
+		llhttplus::Router uncompiled;
+		uncompiled.add(HTTP_GET, "/x");
+		__check(!uncompiled.match(HTTP_GET, "/x"), "routes match only after compile()");
+	}
+
+	return __summary();
+}
@@ -0,0 +1,279 @@
+#include "llhttplus/server.hpp"
+#include "check.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Loopback test of llhttplus_server: keep-alive, pipelining, bodies, errors
+ * and concurrent clients against a server with several loops.
+ */
+
+static int __connect(uint16_t port)
+{
+	int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+	timeval timeout{ 5, 0 };
+	::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		::close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+static bool __send(int fd, const std::string& data)
+{
+	size_t sent = 0;
+	while (sent < data.size())
+	{
+		ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+		if (n <= 0)
+		{
+			return false;
+		}
+		sent += static_cast<size_t>(n);
+	}
+	return true;
+}
+
+struct Response
+{
+	int			status;
+	std::string	body;
+};
+
+/* Reads `count` responses; stops early on EOF or timeout. */
+static std::vector<Response> __receive(int fd, size_t count, bool* eof = nullptr)
+{
+	llhttplus::Connection connection;
+	std::vector<Response> responses;
+	while (responses.size() < count)
+	{
+		auto region = connection.prepare();
+		ssize_t n = ::recv(fd, region.data, region.size, 0);
+		if (n <= 0)
+		{
+			if (eof != nullptr)
+			{
+				*eof = n == 0;
+			}
+			break;
+		}
+		connection.commit(static_cast<size_t>(n));
+		while (auto* response = connection.next())
+		{
+			responses.push_back({ connection.parser().get_status_code(), std::string(response->view(response->body)) });
+			connection.pop();
+		}
+	}
+	return responses;
+}
+
+/* Returns false, without checking anything, if io_uring was asked for but the server runs on epoll. */
+static bool __test(bool io_uring)
+{
+	llhttplus::ServerOptions options;
+	options.address = "127.0.0.1";
+	options.port = 0;
+	options.threads = 2;
+	options.max_request_size = 64 * 1024;
+	options.io_uring = io_uring;
+	options.io_uring_buffers = 64;
+
+	/* echoes the body of POST, answers GET with the target, or with `large` for /large */
+	static const std::string large(8 << 20, 'L');
+	llhttplus::Server server(options, [](const llhttplus::CompactRequest& request, llhttplus::ResponseWriter& response) {
+		response.status(200);
+		response.header(llhttplus::header_blocks::content_type_text);
+		if (request.view(request.url) == "/large")
+		{
+			response.body(large.data(), large.size());
+			return;
+		}
+		auto body = request.view(request.body.length != 0 ? request.body : request.url);
+		response.copy_body(body.data(), body.size());
+	});
+
+	int err = server.start();
+	__check(err == 0, "start");
+	if (err != 0)
+	{
+		std::cout << std::strerror(err) << std::endl;
+		return true;
+	}
+	std::cout << "port:" << server.port() << " loops:" << server.threads() << " backend:" << server.backend() << std::endl;
+	if (io_uring && std::strcmp(server.backend(), "io_uring") != 0)
+	{
+		server.stop();
+		return false;
+	}
+
+	{
+		int fd = __connect(server.port());
+		__send(fd, "GET /hello HTTP/1.1\r\nHost: localhost\r\n\r\n");
+		auto responses = __receive(fd, 1);
+		__check(responses.size() == 1 && responses[0].status == 200 && responses[0].body == "/hello", "keep-alive GET");
+
+		__send(fd, "GET /again HTTP/1.1\r\nHost: localhost\r\n\r\n");
+		responses = __receive(fd, 1);
+		__check(responses.size() == 1 && responses[0].body == "/again", "second request on the same connection");
+		::close(fd);
+	}
+
+	{
+		int fd = __connect(server.port());
+		__send(fd,
+			"GET /1 HTTP/1.1\r\nHost: localhost\r\n\r\n"
+			"POST /2 HTTP/1.1\r\nHost: localhost\r\nContent-Length: 5\r\n\r\nhello"
+			"POST /3 HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n2\r\nde\r\n0\r\n\r\n");
+		auto responses = __receive(fd, 3);
+		__check(responses.size() == 3 && responses[0].body == "/1" && responses[1].body == "hello"
+			&& responses[2].body == "abcde", "pipelined requests with bodies");
+		::close(fd);
+	}
+
+	{
+		int fd = __connect(server.port());
+		std::string request = "POST /split HTTP/1.1\r\nHost: localhost\r\nContent-Length: 4\r\n\r\nabcd";
+		for (char c : request)
+		{
+			__send(fd, std::string(1, c));
+		}
+		auto responses = __receive(fd, 1);
+		__check(responses.size() == 1 && responses[0].body == "abcd", "request sent byte by byte");
+		::close(fd);
+	}
+
+	{
+		int fd = __connect(server.port());
+		__send(fd, "GET /bye HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+		bool eof = false;
+		auto responses = __receive(fd, 2, &eof);
+		__check(responses.size() == 1 && eof, "Connection: close");
+		::close(fd);
+	}
+
+	{
+		/* The output outgrows the socket buffers before the connection is shut down. */
+		int fd = __connect(server.port());
+		__send(fd, "GET /large HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		std::string received;
+		char buffer[65536];
+		ssize_t n;
+		while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0)
+		{
+			received.append(buffer, static_cast<size_t>(n));
+		}
+		__check(n == 0 && received.size() > large.size()
+			&& received.compare(received.size() - large.size(), large.size(), large) == 0,
+			"large response before Connection: close");
+		::close(fd);
+	}
+
+	{
+		int fd = __connect(server.port());
+		__send(fd, "GET / HTTP/1.1\r\nHost: localhost\r\nBad Header\r\n\r\n");
+		bool eof = false;
+		auto responses = __receive(fd, 2, &eof);
+		__check(responses.size() == 1 && responses[0].status == 400 && eof, "malformed request");
+		::close(fd);
+	}
+
+	{
+		int fd = __connect(server.port());
+		/* exactly fills the receive buffer, so the server reads every byte before closing */
+		std::string head = "POST /big HTTP/1.1\r\nHost: localhost\r\nContent-Length: 100000\r\n\r\n";
+		__send(fd, head + std::string(options.max_request_size - head.size(), 'x'));
+		bool eof = false;
+		auto responses = __receive(fd, 2, &eof);
+		__check(responses.size() == 1 && responses[0].status == 413 && eof, "request over max_request_size");
+		::close(fd);
+	}
+
+	{
+		std::vector<std::thread> clients;
+		std::vector<int> answered(8, 0);
+		for (size_t i = 0; i < answered.size(); ++i)
+		{
+			clients.emplace_back([&, i] {
+				int fd = __connect(server.port());
+				for (int n = 0; n < 100; ++n)
+				{
+					std::string target = "/" + std::to_string(i) + "/" + std::to_string(n);
+					__send(fd, "GET " + target + " HTTP/1.1\r\nHost: localhost\r\n\r\n");
+					auto responses = __receive(fd, 1);
+					answered[i] += responses.size() == 1 && responses[0].body == target;
+				}
+				::close(fd);
+			});
+		}
+		int total = 0;
+		for (size_t i = 0; i < clients.size(); ++i)
+		{
+			clients[i].join();
+			total += answered[i];
+		}
+		__check(total == 800, "concurrent clients");
+	}
+
+	server.stop();
+	__check(server.threads() == 0, "stop");
+	return true;
+}
+
+static void __test_options()
+{
+	auto start = [](bool io_uring, size_t buffers, size_t buffer_size) {
+		llhttplus::ServerOptions options;
+		options.address = "127.0.0.1";
+		options.port = 0;
+		options.threads = 1;
+		options.io_uring = io_uring;
+		options.io_uring_buffers = buffers;
+		options.io_uring_buffer_size = buffer_size;
+		llhttplus::Server server(options, [](const llhttplus::CompactRequest&, llhttplus::ResponseWriter& response) {
+			response.status(204);
+		});
+		int err = server.start();
+		server.stop();
+		return err;
+	};
+
+	__check(start(true, 1000, 4096) == EINVAL, "io_uring_buffers not a power of two");
+	__check(start(true, 64, 0) == EINVAL, "io_uring_buffer_size of zero");
+	__check(start(false, 1000, 0) == 0, "io_uring options ignored without io_uring");
+}
+
+int main(int argc, char* argv[])
+{
+	/* `server_test io_uring` runs on io_uring, or is skipped where it is not built or not supported */
+	if (argc > 1 && std::strcmp(argv[1], "io_uring") == 0)
+	{
+		if (!__test(true))
+		{
+			return __skip("io_uring backend not built or not supported");
+		}
+		return __summary();
+	}
+	__test(false);
+	__test_options();
+	return __summary();
+}
@@ -0,0 +1,77 @@
+#include "llhttplus/llhttplus.hpp"
+#include "check.hpp"
+
+#include <cstring>
+#include <memory_resource>
+#include <string>
+
+/*
+ * Values split across execute() calls: joined into the arena, so the caller's
+ * buffers may be reused, and not continued into another request passed in
+ * the middle of a value.
+ */
+
+int main()
+{
+	{
+		std::string first = "GET /sp";
+		std::string second = "lit HTTP/1.1\r\nHost: exa";
+		std::string third = "mple.com\r\n\r\n";
+		llhttplus::Parser parser;
+		llhttplus::Request request;
+		parser.execute(&request, first);
+		first.assign(first.size(), '#');
+		parser.execute(&request, second);
+		second.assign(second.size(), '#');
+		auto err = parser.execute(&request, third);
+		__check(err == HPE_OK && request.url == "/split" && request.get(llhttplus::KnownHeader::Host) == "example.com",
+			"split values are joined");
+		__check(parser.stitch_count() == 2, "only open values are copied");
+	}
+
+	{
+		/* Both requests get their headers from the same storage, so the
+		 * second one's first header lies where the open one of the first did.
+		 */
+		class Reused : public std::pmr::memory_resource
+		{
+			void* do_allocate(size_t, size_t) override
+			{
+				return _storage;
+			}
+
+			void do_deallocate(void*, size_t, size_t) override
+			{
+			}
+
+			bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+			{
+				return this == &other;
+			}
+
+			alignas(64) unsigned char _storage[4096];
+		};
+
+		Reused storage;
+		llhttplus::Parser parser;
+		llhttplus::BasicRequest<0> first(&storage);
+		static const char head[] = "GET / HTTP/1.1\r\nHo";
+		parser.execute(&first, head, std::strlen(head));
+		__check(first.headers.size() == 1 && first.headers[0].first == "Ho", "open value kept in the first request");
+
+		llhttplus::BasicRequest<0> second(&storage);
+		static const char rest[] = "st: a\r\n\r\n";
+		auto err = parser.execute(&second, rest, std::strlen(rest));
+		/* What the second request holds of a header begun in the first one
+		 * is not specified, only that nothing is joined across requests.
+		 */
+		__check(err == HPE_OK && second.headers.size() <= 1
+			&& (second.headers.empty() || second.headers[0].first != "Host"), "value is not continued into another request");
+
+		static const char next[] = "GET /next HTTP/1.1\r\nHost: b\r\n\r\n";
+		err = parser.execute(&second, next, std::strlen(next));
+		__check(err == HPE_OK && second.url == "/next" && second.get(llhttplus::KnownHeader::Host) == "b", "next message");
+	}
+
+	return __summary();
+}
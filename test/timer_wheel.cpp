@@ -0,0 +1,186 @@
+#include "llhttplus/timer_wheel.hpp"
+#include "llhttplus/basic_parser.hpp"
+#include "llhttplus/default_setting.hpp"
+#include "check.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/*
+ * TimerWheel against a brute-force reference, and DeadlineSetting driven by
+ * a parser.
+ */
+
+using namespace std::chrono_literals;
+using Clock = llhttplus::TimerWheel::clock;
+
+struct Reference
+{
+	llhttplus::Timer	timer;
+	int64_t				deadline = -1;	// ms since start, -1 if not armed
+};
+
+static uint64_t __next(uint64_t* state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+	return *state;
+}
+
+int main()
+{
+	const auto start = Clock::time_point() + 1h;
+
+	{
+		llhttplus::TimerWheel wheel(1ms, start);
+		llhttplus::Timer a, b, c;
+		wheel.arm(a, 5ms);
+		wheel.arm(b, 70ms);
+		wheel.arm(c, 5000ms);
+		std::vector<llhttplus::Timer*> expired;
+		wheel.advance(start + 4ms, expired);
+		bool early = !expired.empty();
+		wheel.advance(start + 5ms, expired);
+		bool on_time = expired.size() == 1 && expired[0] == &a && !a.armed();
+		wheel.advance(start + 69ms, expired);
+		wheel.advance(start + 70ms, expired);
+		bool cascaded = expired.size() == 2 && expired[1] == &b;
+		wheel.advance(start + 4999ms, expired);
+		wheel.advance(start + 6000ms, expired);
+		__check(!early && on_time, "timer expires at its deadline, not before");
+		__check(cascaded && expired.size() == 3 && expired[2] == &c, "timers cascade down the levels");
+		__check(wheel.size() == 0, "expired timers are disarmed");
+	}
+
+	{
+		llhttplus::TimerWheel wheel(1ms, start);
+		llhttplus::Timer timer;
+		wheel.arm(timer, 10ms);
+		wheel.arm(timer, 100ms);
+		std::vector<llhttplus::Timer*> expired;
+		wheel.advance(start + 50ms, expired);
+		bool moved = expired.empty() && timer.armed() && wheel.size() == 1;
+		timer.cancel();
+		wheel.advance(start + 200ms, expired);
+		__check(moved && expired.empty() && wheel.size() == 0, "re-arm moves and cancel removes");
+
+		auto far = std::make_unique<llhttplus::Timer>();
+		wheel.arm(*far, 30h);
+		wheel.advance(start + 200ms + 29h, expired);
+		bool parked = expired.empty();
+		wheel.advance(start + 200ms + 30h, expired);
+		__check(parked && expired.size() == 1 && expired[0] == far.get(), "timers beyond the span wait");
+		wheel.arm(*far, 1s);
+		far.reset();
+		__check(wheel.size() == 0, "destroyed timer unlinks itself");
+	}
+
+	{
+		/* Random arms, re-arms, cancels and steps against deadlines kept aside. */
+		llhttplus::TimerWheel wheel(1ms, start);
+		std::vector<Reference> timers(2000);
+		for (auto& reference : timers)
+		{
+			reference.timer.data = &reference;
+		}
+		std::vector<llhttplus::Timer*> expired;
+		uint64_t state = 0x9e3779b97f4a7c15;
+		int64_t now = 0;
+		bool early = false;
+		bool ordered = true;
+		bool missed = false;
+		for (int round = 0; round < 3000; ++round)
+		{
+			for (int i = 0; i < 20; ++i)
+			{
+				auto& reference = timers[__next(&state) % timers.size()];
+				uint64_t r = __next(&state);
+				if (r % 10 == 0)
+				{
+					reference.timer.cancel();
+					reference.deadline = -1;
+					continue;
+				}
+				int64_t after = r % 7 == 0 ? static_cast<int64_t>((r >> 8) % 400000) : static_cast<int64_t>((r >> 8) % 3000);
+				wheel.arm(reference.timer, std::chrono::milliseconds(after));
+				reference.deadline = now + std::max<int64_t>(after, 1);
+			}
+
+			now += static_cast<int64_t>(__next(&state) % (round % 100 == 0 ? 100000 : 200));
+			expired.clear();
+			wheel.advance(start + std::chrono::milliseconds(now), expired);
+			int64_t previous = 0;
+			for (auto* timer : expired)
+			{
+				auto& reference = *static_cast<Reference*>(timer->data);
+				early |= reference.deadline < 0 || reference.deadline > now;
+				ordered &= reference.deadline >= previous;
+				previous = reference.deadline;
+				reference.deadline = -1;
+			}
+			for (const auto& reference : timers)
+			{
+				missed |= reference.deadline >= 0 && reference.deadline <= now;
+			}
+		}
+		size_t armed = 0;
+		for (const auto& reference : timers)
+		{
+			armed += reference.deadline >= 0;
+		}
+		__check(!early, "no timer expires early");
+		__check(!missed, "every due timer expires");
+		__check(ordered, "batches come out in deadline order");
+		__check(armed == wheel.size(), "armed count matches");
+	}
+
+	{
+		/* Parser lifecycle: idle, then header, body and idle again. */
+		llhttplus::TimerWheel wheel(1ms, start);
+		llhttplus::Deadlines deadlines{ 100ms, 50ms, 1000ms };
+		llhttplus::BasicParser<llhttplus::DeadlineSetting<llhttplus::DefaultSetting>> parser(&wheel, deadlines);
+		auto& setting = parser.callbacks();
+		llhttplus::Request request;
+		std::vector<llhttplus::Timer*> expired;
+		__check(setting.phase() == llhttplus::DeadlinePhase::idle && setting.timer().armed(), "idle deadline armed up front");
+
+		wheel.advance(start + 500ms, expired);
+		parser.execute(&request, std::string_view("POST /upload HTTP/1.1\r\nHost: a"));
+		__check(setting.phase() == llhttplus::DeadlinePhase::header, "first byte arms the header deadline");
+
+		wheel.advance(start + 590ms, expired);
+		parser.execute(&request, std::string_view("\r\nContent-Length: 10\r\n\r\n0123"));
+		__check(expired.empty() && setting.phase() == llhttplus::DeadlinePhase::body, "head in time arms the body deadline");
+
+		wheel.advance(start + 630ms, expired);
+		parser.execute(&request, std::string_view("45"));
+		wheel.advance(start + 670ms, expired);
+		__check(expired.empty(), "body progress re-arms");
+
+		parser.execute(&request, std::string_view("6789"));
+		__check(setting.phase() == llhttplus::DeadlinePhase::idle && request.url == "/upload", "complete message arms idle");
+		wheel.advance(start + 1669ms, expired);
+		bool waiting = expired.empty();
+		wheel.advance(start + 1670ms, expired);
+		__check(waiting && expired.size() == 1 && expired[0] == &setting.timer(), "idle connection expires");
+
+		llhttplus::BasicParser<llhttplus::DeadlineSetting<llhttplus::DefaultSetting>> slow(&wheel, deadlines);
+		slow.callbacks().timer().data = &slow;
+		slow.execute(&request, std::string_view("GET / HTTP/1.1\r\n"));
+		for (int i = 0; i < 20; ++i)
+		{
+			wheel.advance(start + 1670ms + std::chrono::milliseconds(10 * i), expired);
+			slow.execute(&request, std::string_view("X-Slow: 1\r\n"));
+		}
+		__check(expired.size() == 2 && expired[1]->data == &slow && slow.callbacks().phase() == llhttplus::DeadlinePhase::header,
+			"trickling head still expires");
+	}
+
+	return __summary();
+}
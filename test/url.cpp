@@ -0,0 +1,183 @@
+#include "llhttplus/url.hpp"
+#include "check.hpp"
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+/*
+ * UrlView, QueryIterator and percent decoding: origin and absolute form,
+ * `?` and `#` edge cases, empty and bare pairs, malformed escapes, and
+ * decoding against a plain reference at every length and escape position,
+ * which covers both the 16-byte loop and the scalar tail.
+ */
+
+static std::vector<std::pair<std::string, std::string>> __params(std::string_view query)
+{
+	std::vector<std::pair<std::string, std::string>> params;
+	for (auto param : llhttplus::QueryRange{ query })
+	{
+		params.emplace_back(param.key, param.value);
+	}
+	return params;
+}
+
+static int __hex(char c)
+{
+	if (c >= '0' && c <= '9')
+	{
+		return c - '0';
+	}
+	if (c >= 'a' && c <= 'f')
+	{
+		return c - 'a' + 10;
+	}
+	if (c >= 'A' && c <= 'F')
+	{
+		return c - 'A' + 10;
+	}
+	return -1;
+}
+
+static std::string __reference(std::string_view value, bool plus)
+{
+	std::string out;
+	for (size_t i = 0; i < value.size(); ++i)
+	{
+		if (plus && value[i] == '+')
+		{
+			out += ' ';
+		}
+		else if (value[i] == '%' && i + 2 < value.size() && __hex(value[i + 1]) >= 0 && __hex(value[i + 2]) >= 0)
+		{
+			out += static_cast<char>(__hex(value[i + 1]) << 4 | __hex(value[i + 2]));
+			i += 2;
+		}
+		else
+		{
+			out += value[i];
+		}
+	}
+	return out;
+}
+
+int main()
+{
+	std::pmr::monotonic_buffer_resource resource;
+
+	{
+		llhttplus::UrlView url("/a/b?x=1&y=2#frag");
+		__check(url.path() == "/a/b" && url.query() == "x=1&y=2" && url.fragment() == "frag", "origin form");
+		__check(url.param("y") == "2" && url.param("z").empty(), "param by key");
+
+		llhttplus::UrlView absolute("http://example.com:8080/p/q?k=v#f");
+		__check(absolute.path() == "/p/q" && absolute.query() == "k=v" && absolute.fragment() == "f", "absolute form");
+		llhttplus::UrlView bare("https://example.com");
+		__check(bare.path().empty() && bare.query().empty() && bare.fragment().empty(), "absolute form without path");
+		llhttplus::UrlView host_query("http://example.com?a=1");
+		__check(host_query.path().empty() && host_query.query() == "a=1", "absolute form with a query only");
+		llhttplus::UrlView scheme_in_query("/p?next=http://x/y");
+		__check(scheme_in_query.path() == "/p" && scheme_in_query.query() == "next=http://x/y",
+			"scheme inside the query");
+		__check(llhttplus::UrlView("*").path() == "*", "asterisk form");
+		__check(llhttplus::UrlView("example.com:443").path() == "example.com:443", "authority form");
+		llhttplus::UrlView empty("");
+		__check(empty.path().empty() && empty.query().empty() && empty.fragment().empty(), "empty target");
+	}
+
+	{
+		llhttplus::UrlView empty_query("/p?");
+		__check(empty_query.path() == "/p" && empty_query.query().empty() && empty_query.params().begin() == empty_query.params().end(),
+			"empty query");
+		llhttplus::UrlView empty_both("/p?#");
+		__check(empty_both.path() == "/p" && empty_both.query().empty() && empty_both.fragment().empty(), "empty query and fragment");
+		llhttplus::UrlView hash_first("/p#a?b=1");
+		__check(hash_first.path() == "/p" && hash_first.query().empty() && hash_first.fragment() == "a?b=1",
+			"question mark inside the fragment");
+		llhttplus::UrlView two_marks("/p?a=1?b=2#c#d");
+		__check(two_marks.query() == "a=1?b=2" && two_marks.fragment() == "c#d" && two_marks.param("a") == "1?b=2",
+			"second question mark and hash are data");
+		llhttplus::UrlView query_only("?a=1");
+		__check(query_only.path().empty() && query_only.query() == "a=1", "target without path");
+	}
+
+	{
+		auto params = __params("a=1&&b&=v&c=&&d=x=y&");
+		std::vector<std::pair<std::string, std::string>> expected = {
+			{ "a", "1" }, { "b", "" }, { "", "v" }, { "c", "" }, { "d", "x=y" },
+		};
+		__check(params == expected, "empty pairs are skipped, bare keys have empty values");
+		__check(__params("").empty() && __params("&&&").empty(), "no pairs");
+		__check(__params("k") == decltype(params){ { "k", "" } }, "single bare key");
+
+		llhttplus::QueryIterator it("a=1&b=2");
+		auto first = it++;
+		__check(first->key == "a" && it->key == "b" && ++it == llhttplus::QueryIterator(), "iterator steps");
+		__check(llhttplus::UrlView("/p?=v").param("") == "v", "empty key");
+	}
+
+	{
+		auto decode = [&](std::string_view value, bool plus = false) {
+			return std::string(llhttplus::percent_decode(value, &resource, plus));
+		};
+		__check(decode("a%20b%2fc%2F") == "a b/c/", "escapes in either case");
+		__check(decode("%") == "%" && decode("%4") == "%4" && decode("a%zz") == "a%zz" && decode("%4g%g4") == "%4g%g4",
+			"malformed escapes are kept");
+		__check(decode("%%41%") == "%A%" && decode("100%") == "100%", "percent before an escape and at the end");
+		__check(decode("%00") == std::string(1, '\0'), "escaped NUL");
+		__check(decode("a+b") == "a+b" && decode("a+b", true) == "a b" && decode("%2B+", true) == "+ ", "plus");
+
+		std::string_view clean = "/plain/path/longer/than/sixteen/bytes";
+		__check(llhttplus::percent_decode(clean, &resource).data() == clean.data(), "clean value is returned itself");
+		__check(!llhttplus::needs_decoding(clean) && llhttplus::needs_decoding("/a+b", true)
+			&& !llhttplus::needs_decoding("/a+b") && llhttplus::needs_decoding(std::string(40, 'x') + "%"),
+			"needs_decoding");
+
+		llhttplus::UrlView url("/a%20b/c?q=%41");
+		__check(url.decoded_path(&resource) == "/a b/c" && url.param("q") == "%41", "decoded path, encoded params");
+	}
+
+	{
+		/* Every length up to 70 with escapes at every position, in and out of 16-byte blocks. */
+		static const char* escapes[] = { "%41", "%", "%4", "%zz", "+", "%2b" };
+		bool same = true;
+		bool in_place = true;
+		bool needs = true;
+		uint32_t state = 12345;
+		for (size_t length = 0; length <= 70; ++length)
+		{
+			for (size_t at = 0; at <= length; ++at)
+			{
+				for (const char* escape : escapes)
+				{
+					state = state * 1103515245 + 12345;
+					std::string value(length, static_cast<char>('a' + state % 26));
+					value.insert(at, escape);
+					if (state % 3 == 0)
+					{
+						value.insert(value.size() - value.size() / 3, "%7e");
+					}
+
+					for (bool plus : { false, true })
+					{
+						std::string expected = __reference(value, plus);
+						same &= llhttplus::percent_decode(value, &resource, plus) == expected;
+
+						std::string copy = value;
+						size_t size = llhttplus::percent_decode_in_place(copy.data(), copy.size(), plus);
+						in_place &= std::string_view(copy.data(), size) == expected;
+
+						needs &= llhttplus::needs_decoding(value, plus) == (value.find('%') != std::string::npos
+							|| (plus && value.find('+') != std::string::npos));
+					}
+				}
+			}
+		}
+		__check(same, "percent_decode matches the reference");
+		__check(in_place, "percent_decode_in_place matches the reference");
+		__check(needs, "needs_decoding finds every escape");
+	}
+
+	return __summary();
+}